@@ -168,13 +168,14 @@ namespace ESSImport
         // I wonder what 0x40 does?
         if (cell.isExterior() && cell.mData.mFlags & 0x20)
         {
-            mContext->mGlobalMapState.mMarkers.insert(std::make_pair(cell.mData.mX, cell.mData.mY));
+            mMapMarkers.insert(std::make_pair(cell.mData.mX, cell.mData.mY));
         }
 
         // note if the player is in a nameless exterior cell, we will assign the cellId later based on player position
         if (cell.mName == mContext->mPlayerCellName)
         {
-            mContext->mPlayer.mCellId = cell.getCellId();
+            mHasPlayerCell = true;
+            mPlayerCellId = cell.getCellId();
         }
 
         Cell newcell;
@@ -191,7 +192,7 @@ namespace ESSImport
         {
             if (cell.isExterior()) // TODO: NAM8 occasionally exists for cells that haven't been explored.
                                    // are there any flags marking explored cells?
-                mContext->mExploredCells.insert(std::make_pair(cell.mData.mX, cell.mData.mY));
+                mExploredCells.insert(std::make_pair(cell.mData.mX, cell.mData.mY));
 
             esm.getSubHeader();
 
@@ -283,6 +284,14 @@ namespace ESSImport
             mIntCells[cell.mName] = newcell;
     }
 
+    void ConvertCell::finishRead()
+    {
+        mContext->mGlobalMapState.mMarkers.insert(mMapMarkers.begin(), mMapMarkers.end());
+        mContext->mExploredCells.insert(mExploredCells.begin(), mExploredCells.end());
+        if (mHasPlayerCell)
+            mContext->mPlayer.mCellId = mPlayerCellId;
+    }
+
     void ConvertCell::writeCell(const Cell &cell, ESM::ESMWriter& esm)
     {
         ESM::Cell esmcell = cell.mCell;
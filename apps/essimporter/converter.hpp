@@ -54,14 +54,26 @@ public:
 
     void setContext(Context& context) { mContext = &context; }
 
+    /// @return Can the records of this converter be read on their own thread? Only if read() does not
+    /// depend on the order of records of other types, and does not change any part of the Context that
+    /// another converter uses while reading.
+    virtual bool isIndependent() { return false; }
+
     /// @note The load method of ESM records accept the deleted flag as a parameter.
     /// I don't know can the DELE sub-record appear in saved games, so the deleted flag will be ignored.
     virtual void read(ESM::ESMReader& esm)
     {
     }
 
+    /// Called on the main thread after all records have been read, before any write()
+    virtual void finishRead()
+    {
+    }
+
     /// Called after the input file has been read in completely, which may be necessary
     /// if the conversion process relies on information in other records
+    /// @note Converters write at the same time, each to its own writer. The Context may only
+    /// be read here, unless the changed data is used by no other converter.
     virtual void write(ESM::ESMWriter& esm)
     {
 
@@ -78,6 +90,8 @@ class DefaultConverter : public Converter
 public:
     virtual int getStage() { return 0; }
 
+    virtual bool isIndependent() { return true; }
+
     virtual void read(ESM::ESMReader& esm)
     {
         T record;
@@ -159,6 +173,9 @@ public:
 class ConvertGlobal : public DefaultConverter<ESM::Global>
 {
 public:
+    // changes the Context
+    virtual bool isIndependent() { return false; }
+
     virtual void read(ESM::ESMReader &esm)
     {
         ESM::Global global;
@@ -180,6 +197,9 @@ public:
 class ConvertClass : public DefaultConverter<ESM::Class>
 {
 public:
+    // changes the Context
+    virtual bool isIndependent() { return false; }
+
     virtual void read(ESM::ESMReader &esm)
     {
         ESM::Class class_;
@@ -196,6 +216,9 @@ public:
 class ConvertBook : public DefaultConverter<ESM::Book>
 {
 public:
+    // changes the Context
+    virtual bool isIndependent() { return false; }
+
     virtual void read(ESM::ESMReader &esm)
     {
         ESM::Book book;
@@ -303,6 +326,9 @@ private:
 
 class ConvertCNTC : public Converter
 {
+    // the container changes are only used when writing
+    virtual bool isIndependent() { return true; }
+
     virtual void read(ESM::ESMReader &esm)
     {
         std::string id = esm.getHNString("NAME");
@@ -315,6 +341,9 @@ class ConvertCNTC : public Converter
 class ConvertCREC : public Converter
 {
 public:
+    // the creature changes are only used when writing
+    virtual bool isIndependent() { return true; }
+
     virtual void read(ESM::ESMReader &esm)
     {
         std::string id = esm.getHNString("NAME");
@@ -337,7 +366,13 @@ private:
 class ConvertCell : public Converter
 {
 public:
+    ConvertCell() : mHasPlayerCell(false) {}
+
+    // cells make up most of a save, the changes to the Context are kept back until finishRead()
+    virtual bool isIndependent() { return true; }
+
     virtual void read(ESM::ESMReader& esm);
+    virtual void finishRead();
     virtual void write(ESM::ESMWriter& esm);
 
 private:
@@ -353,6 +388,11 @@ private:
 
     std::vector<ESM::CustomMarker> mMarkers;
 
+    std::set<std::pair<int, int> > mMapMarkers;
+    std::set<std::pair<int, int> > mExploredCells;
+    bool mHasPlayerCell;
+    ESM::CellId mPlayerCellId;
+
     void writeCell(const Cell& cell, ESM::ESMWriter &esm);
 };
 
@@ -1,11 +1,16 @@
 #include "importer.hpp"
 
+#include <algorithm>
 #include <iomanip>
+#include <sstream>
 
 #include <boost/filesystem/fstream.hpp>
 
 #include <osgDB/ReadFile>
 #include <osg/ImageUtils>
+#include <osg/Timer>
+
+#include <OpenThreads/Thread>
 
 #include <components/esm/esmreader.hpp>
 #include <components/esm/esmwriter.hpp>
@@ -27,6 +32,8 @@
 
 #include <components/to_utf8/to_utf8.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include "importercontext.hpp"
 
 #include "converter.hpp"
@@ -34,6 +41,113 @@
 namespace
 {
 
+    /// Reads all records of one independent converter, with a reader of its own
+    class ReadRecordsWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        ReadRecordsWorkItem(ESSImport::Converter* converter, const std::string& essFile, const std::string& encoding,
+                            const std::vector<ESM::ESM_Context>& records)
+            : mConverter(converter)
+            , mEssFile(essFile)
+            , mEncoding(encoding)
+            , mRecords(records)
+            , mTime(0.0)
+        {
+        }
+
+        virtual void doWork()
+        {
+            osg::Timer_t start = osg::Timer::instance()->tick();
+            try
+            {
+                ToUTF8::Utf8Encoder encoder(ToUTF8::calculateEncoding(mEncoding));
+                ESM::ESMReader esm;
+                esm.open(mEssFile);
+                esm.setEncoder(&encoder);
+
+                for (std::vector<ESM::ESM_Context>::const_iterator it = mRecords.begin(); it != mRecords.end(); ++it)
+                {
+                    esm.restoreContext(*it);
+                    esm.getRecName();
+                    esm.getRecHeader();
+                    mConverter->read(esm);
+                }
+            }
+            catch (std::exception& e)
+            {
+                mError = e.what();
+            }
+            mTime = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+        }
+
+        const std::string& getError() const { return mError; }
+
+        double getTime() const { return mTime; }
+
+    private:
+        ESSImport::Converter* mConverter;
+        std::string mEssFile;
+        std::string mEncoding;
+        const std::vector<ESM::ESM_Context>& mRecords;
+        std::string mError;
+        double mTime;
+    };
+
+    /// Writes the records of one converter into a buffer, to be put into the output file later
+    class WriteRecordsWorkItem : public SceneUtil::WorkItem
+    {
+    public:
+        WriteRecordsWorkItem(ESSImport::Converter* converter)
+            : mConverter(converter)
+            , mTime(0.0)
+        {
+        }
+
+        virtual void doWork()
+        {
+            osg::Timer_t start = osg::Timer::instance()->tick();
+            try
+            {
+                ESM::ESMWriter writer;
+                writer.setFormat (ESM::SavedGame::sCurrentFormat);
+                std::ostringstream stream;
+                writer.save (stream);
+                // the header is only there to make the writer work, the records are appended to the real file
+                std::string::size_type headerSize = stream.str().size();
+
+                mConverter->write(writer);
+
+                mData = stream.str().substr(headerSize);
+            }
+            catch (std::exception& e)
+            {
+                mError = e.what();
+            }
+            mTime = osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
+        }
+
+        const std::string& getData() const { return mData; }
+
+        const std::string& getError() const { return mError; }
+
+        double getTime() const { return mTime; }
+
+    private:
+        ESSImport::Converter* mConverter;
+        std::string mData;
+        std::string mError;
+        double mTime;
+    };
+
+    struct ConverterTiming
+    {
+        int mNumRecords;
+        double mReadTime;
+        double mWriteTime;
+
+        ConverterTiming() : mNumRecords(0), mReadTime(0.0), mWriteTime(0.0) {}
+    };
+
     void writeScreenshot(const ESM::Header& fileHeader, ESM::SavedGame& out)
     {
         if (fileHeader.mSCRS.size() != 128*128*4)
@@ -310,6 +424,8 @@ namespace ESSImport
         // - SPLM (active spell effects)
         // - PROJ (magic projectiles in air)
 
+        osg::Timer_t startTime = osg::Timer::instance()->tick();
+
         std::set<unsigned int> unknownRecords;
 
         for (std::map<unsigned int, std::shared_ptr<Converter> >::const_iterator it = converters.begin();
@@ -318,15 +434,25 @@ namespace ESSImport
             it->second->setContext(context);
         }
 
+        // First pass: only note where the records are. The records of independent converters
+        // are grouped by type, the others have to be read in the order of the file.
+        std::map<unsigned int, std::vector<ESM::ESM_Context> > independentRecords;
+        std::vector<std::pair<unsigned int, ESM::ESM_Context> > orderedRecords;
+        std::map<unsigned int, ConverterTiming> timings;
         while (esm.hasMoreRecs())
         {
+            ESM::ESM_Context recordContext = esm.getContext();
             ESM::NAME n = esm.getRecName();
             esm.getRecHeader();
 
             std::map<unsigned int, std::shared_ptr<Converter> >::iterator it = converters.find(n.intval);
             if (it != converters.end())
             {
-                it->second->read(esm);
+                if (it->second->isIndependent())
+                    independentRecords[n.intval].push_back(recordContext);
+                else
+                    orderedRecords.push_back(std::make_pair(n.intval, recordContext));
+                ++timings[n.intval].mNumRecords;
             }
             else
             {
@@ -336,10 +462,84 @@ namespace ESSImport
                     std::cerr << "Error: unknown record " << n.toString() << " (0x" << std::hex << esm.getFileOffset() << ")" << std::endl;
                     std::cerr.flags(f);
                 }
+            }
+
+            esm.skipRecord();
+        }
+
+        osg::Timer_t indexTime = osg::Timer::instance()->tick();
+
+        // Second pass: the independent converters read on worker threads, while the rest is read here
+        int numThreads = std::max(1, std::min(OpenThreads::GetNumberOfProcessors(), static_cast<int>(converters.size())));
+        osg::ref_ptr<SceneUtil::WorkQueue> workQueue (new SceneUtil::WorkQueue(numThreads));
 
-                esm.skipRecord();
+        std::map<unsigned int, osg::ref_ptr<ReadRecordsWorkItem> > readItems;
+        for (std::map<unsigned int, std::vector<ESM::ESM_Context> >::const_iterator it = independentRecords.begin();
+             it != independentRecords.end(); ++it)
+        {
+            osg::ref_ptr<ReadRecordsWorkItem> item (new ReadRecordsWorkItem(converters[it->first].get(), mEssFile, mEncoding, it->second));
+            readItems[it->first] = item;
+            workQueue->addWorkItem(item);
+        }
+
+        std::string readError;
+        try
+        {
+            for (std::vector<std::pair<unsigned int, ESM::ESM_Context> >::const_iterator it = orderedRecords.begin();
+                 it != orderedRecords.end(); ++it)
+            {
+                osg::Timer_t start = osg::Timer::instance()->tick();
+                esm.restoreContext(it->second);
+                esm.getRecName();
+                esm.getRecHeader();
+                converters[it->first]->read(esm);
+                timings[it->first].mReadTime += osg::Timer::instance()->delta_m(start, osg::Timer::instance()->tick());
             }
         }
+        catch (std::exception& e)
+        {
+            // the work items refer to the converters, so they have to finish before leaving
+            readError = e.what();
+        }
+
+        for (std::map<unsigned int, osg::ref_ptr<ReadRecordsWorkItem> >::const_iterator it = readItems.begin(); it != readItems.end(); ++it)
+        {
+            it->second->waitTillDone();
+            timings[it->first].mReadTime = it->second->getTime();
+            if (readError.empty())
+                readError = it->second->getError();
+        }
+        if (!readError.empty())
+            throw std::runtime_error(readError);
+
+        for (std::map<unsigned int, std::shared_ptr<Converter> >::const_iterator it = converters.begin();
+             it != converters.end(); ++it)
+        {
+            it->second->finishRead();
+        }
+
+        osg::Timer_t readTime = osg::Timer::instance()->tick();
+
+        // Convert all record types at once, each into its own buffer
+        std::map<unsigned int, osg::ref_ptr<WriteRecordsWorkItem> > writeItems;
+        for (std::map<unsigned int, std::shared_ptr<Converter> >::const_iterator it = converters.begin();
+             it != converters.end(); ++it)
+        {
+            osg::ref_ptr<WriteRecordsWorkItem> item (new WriteRecordsWorkItem(it->second.get()));
+            writeItems[it->first] = item;
+            workQueue->addWorkItem(item);
+        }
+
+        std::string writeError;
+        for (std::map<unsigned int, osg::ref_ptr<WriteRecordsWorkItem> >::const_iterator it = writeItems.begin(); it != writeItems.end(); ++it)
+        {
+            it->second->waitTillDone();
+            timings[it->first].mWriteTime = it->second->getTime();
+            if (writeError.empty())
+                writeError = it->second->getError();
+        }
+        if (!writeError.empty())
+            throw std::runtime_error(writeError);
 
         ESM::ESMWriter writer;
 
@@ -391,7 +591,8 @@ namespace ESSImport
         {
             if (it->second->getStage() != 0)
                 continue;
-            it->second->write(writer);
+            const std::string& data = writeItems[it->first]->getData();
+            stream.write(data.c_str(), data.size());
         }
 
         writer.startRecord(ESM::REC_NPC_);
@@ -404,7 +605,8 @@ namespace ESSImport
         {
             if (it->second->getStage() != 1)
                 continue;
-            it->second->write(writer);
+            const std::string& data = writeItems[it->first]->getData();
+            stream.write(data.c_str(), data.size());
         }
 
         writer.startRecord(ESM::REC_PLAY);
@@ -427,6 +629,23 @@ namespace ESSImport
         writer.startRecord(ESM::REC_INPU);
         context.mControlsState.save(writer);
         writer.endRecord(ESM::REC_INPU);
+
+        osg::Timer_t endTime = osg::Timer::instance()->tick();
+
+        std::ios::fmtflags f(std::cout.flags());
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "Timing summary (" << numThreads << " threads):" << std::endl;
+        for (std::map<unsigned int, ConverterTiming>::const_iterator it = timings.begin(); it != timings.end(); ++it)
+        {
+            ESM::NAME name;
+            name.intval = it->first;
+            std::cout << "  " << name.toString() << ": " << std::setw(6) << it->second.mNumRecords << " records, read "
+                      << std::setw(8) << it->second.mReadTime << " ms, write " << std::setw(8) << it->second.mWriteTime << " ms" << std::endl;
+        }
+        std::cout << "  index " << osg::Timer::instance()->delta_m(startTime, indexTime) << " ms, read "
+                  << osg::Timer::instance()->delta_m(indexTime, readTime) << " ms, convert and write "
+                  << osg::Timer::instance()->delta_m(readTime, endTime) << " ms" << std::endl;
+        std::cout.flags(f);
     }
 
 
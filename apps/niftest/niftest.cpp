@@ -2,7 +2,11 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <cstdlib>
+#include <chrono>
+#include <iomanip>
+#include <algorithm>
 
 #include <components/nif/niffile.hpp>
 #include <components/files/constrainedfilestream.hpp>
@@ -17,6 +21,62 @@
 namespace bpo = boost::program_options;
 namespace bfs = boost::filesystem;
 
+///Parse throughput gathered in --benchmark mode
+struct BenchmarkStats
+{
+    bool mEnabled;
+    size_t mFiles;
+    size_t mBytes;
+    double mSeconds;
+    std::vector<std::pair<double, std::string> > mTimes;
+
+    BenchmarkStats() : mEnabled(false), mFiles(0), mBytes(0), mSeconds(0.0) {}
+};
+
+static BenchmarkStats sBenchmark;
+
+///Parse a nif file. In benchmark mode, the file is read into memory first so that only parsing is timed.
+void readNIF(Files::IStreamPtr stream, const std::string& name)
+{
+    if (!sBenchmark.mEnabled)
+    {
+        Nif::NIFFile temp_nif(stream, name);
+        return;
+    }
+
+    std::ostringstream buffer;
+    buffer << stream->rdbuf();
+    std::string data = buffer.str();
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    {
+        Nif::NIFFile temp_nif(Files::IStreamPtr(new std::istringstream(data)), name);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    sBenchmark.mFiles++;
+    sBenchmark.mBytes += data.size();
+    sBenchmark.mSeconds += seconds;
+    sBenchmark.mTimes.push_back(std::make_pair(seconds, name));
+}
+
+void printBenchmark()
+{
+    std::cout << "Parsed " << sBenchmark.mFiles << " files, " << std::fixed << std::setprecision(2)
+              << sBenchmark.mBytes / (1024.0*1024.0) << " MiB in " << std::setprecision(3) << sBenchmark.mSeconds << " s";
+    if (sBenchmark.mSeconds > 0.0)
+        std::cout << " (" << std::setprecision(2) << sBenchmark.mBytes / (1024.0*1024.0) / sBenchmark.mSeconds << " MiB/s, "
+                  << sBenchmark.mFiles / sBenchmark.mSeconds << " files/s)";
+    std::cout << std::endl;
+
+    std::sort(sBenchmark.mTimes.rbegin(), sBenchmark.mTimes.rend());
+    size_t count = std::min<size_t>(10, sBenchmark.mTimes.size());
+    if (count > 0)
+        std::cout << "Slowest files:" << std::endl;
+    for (size_t i = 0; i < count; ++i)
+        std::cout << "  " << std::setprecision(3) << sBenchmark.mTimes[i].first * 1000.0 << " ms  " << sBenchmark.mTimes[i].second << std::endl;
+}
+
 ///See if the file has the named extension
 bool hasExtension(std::string filename, std::string  extensionToFind)
 {
@@ -61,7 +121,7 @@ void readVFS(VFS::Archive* anArchive,std::string archivePath = "")
             if(isNIF(name))
             {
             //           std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(myManager.get(name),archivePath+name);
+                readNIF(myManager.get(name),archivePath+name);
             }
             else if(isBSA(name))
             {
@@ -85,10 +145,13 @@ std::vector<std::string> parseOptions (int argc, char** argv)
     bpo::options_description desc("Ensure that OpenMW can use the provided NIF and BSA files\n\n"
         "Usages:\n"
         "  niftool <nif files, BSA files, or directories>\n"
-        "      Scan the file or directories for nif errors.\n\n"
+        "      Scan the file or directories for nif errors.\n"
+        "  niftool --benchmark <nif files, BSA files, or directories>\n"
+        "      Also report how fast the nif files are parsed.\n\n"
         "Allowed options");
     desc.add_options()
         ("help,h", "print help message.")
+        ("benchmark,b", "measure parsing throughput. Files are read into memory before parsing, so disk access is not timed.")
         ("input-file", bpo::value< std::vector<std::string> >(), "input file")
         ;
 
@@ -116,6 +179,7 @@ std::vector<std::string> parseOptions (int argc, char** argv)
         std::cout << desc << std::endl;
         exit(1);
     }
+    sBenchmark.mEnabled = variables.count("benchmark") > 0;
     if (variables.count("input-file"))
     {
         return variables["input-file"].as< std::vector<std::string> >();
@@ -139,7 +203,7 @@ int main(int argc, char **argv)
             if(isNIF(name))
             {
                 //std::cout << "Decoding: " << name << std::endl;
-                Nif::NIFFile temp_nif(Files::openConstrainedFileStream(name.c_str()),name);
+                readNIF(Files::openConstrainedFileStream(name.c_str()),name);
              }
              else if(isBSA(name))
              {
@@ -161,5 +225,8 @@ int main(int argc, char **argv)
             std::cerr << "ERROR, an exception has occurred:  " << e.what() << std::endl;
         }
      }
+
+     if (sBenchmark.mEnabled)
+        printBenchmark();
      return 0;
 }
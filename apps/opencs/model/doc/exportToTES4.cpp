@@ -14,9 +14,11 @@ void inline OutputDebugString(const char *c_string) { std::cout << c_string; };
 
 #include "exportToTES4.hpp"
 #include "document.hpp"
+#include "../world/cellcoordinates.hpp"
 #include <components/esm/scriptconverter.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/misc/exportmanifest.hpp>
 
 #include <osg/Image>
 #include <osgDB/ReadFile>
@@ -32,6 +34,214 @@ void inline OutputDebugString(const char *c_string) { std::cout << c_string; };
 
 #include <components/nif/niffile.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#include <QRunnable>
+#include <QThreadPool>
+
+namespace
+{
+	Misc::ExportManifest::Hash hashStream(std::istream& stream, std::vector<char>* data = NULL)
+	{
+		Misc::ExportManifest::Hash hash = Misc::ExportManifest::sHashSeed;
+		char buffer[4096];
+		while (stream.eof() == false)
+		{
+			stream.read(buffer, sizeof(buffer));
+			hash = Misc::ExportManifest::hash(buffer, stream.gcount(), hash);
+			if (data != NULL)
+				data->insert(data->end(), buffer, buffer + stream.gcount());
+		}
+		return hash;
+	}
+
+	// The TES3 form of a record is a complete summary of its content, so use it to tell whether a cached TES4 record is still valid
+	template<typename RecordT>
+	Misc::ExportRecordCache::Hash hashSourceRecord(const CSMWorld::Record<RecordT>& record)
+	{
+		std::ostringstream stream;
+		ESM::ESMWriter writer;
+		writer.save(stream);
+		std::string::size_type headerSize = stream.str().size();
+
+		writer.startRecord(RecordT::sRecordId);
+		record.get().save(writer, record.isDeleted());
+		writer.endRecord(RecordT::sRecordId);
+
+		std::string data = stream.str();
+		int state = record.mState;
+		Misc::ExportRecordCache::Hash hash = Misc::ExportManifest::hash(data.c_str() + headerSize, data.size() - headerSize);
+		return Misc::ExportManifest::hash(reinterpret_cast<const char*>(&state), sizeof(state), hash);
+	}
+
+	// Hashes the mesh a NIF conversion job will read: the prepared copy in the export temp folder
+	// if there is one, otherwise the original from the VFS.
+	class ModelHashJob : public QRunnable
+	{
+	public:
+		struct Result
+		{
+			std::string mTempPath;
+			std::string mVFSPath;
+			std::string mSalt; // conversion settings that affect the output
+			Misc::ExportManifest::Hash mHash;
+			bool mValid;
+
+			Result() : mHash(0), mValid(false) {}
+		};
+
+		ModelHashJob(const VFS::Manager* vfs, Result& result)
+			: mVFS(vfs), mResult(result)
+		{}
+
+		virtual void run()
+		{
+			try
+			{
+				Misc::ExportManifest::Hash hash;
+				if (boost::filesystem::exists(mResult.mTempPath))
+				{
+					std::ifstream stream(mResult.mTempPath.c_str(), std::ios_base::in | std::ios_base::binary);
+					hash = hashStream(stream);
+				}
+				else
+				{
+					Files::IStreamPtr stream = mVFS->get(mResult.mVFSPath);
+					hash = hashStream(*stream);
+				}
+				mResult.mHash = Misc::ExportManifest::hash(mResult.mSalt, hash);
+				mResult.mValid = true;
+			}
+			catch (std::exception&)
+			{
+				mResult.mValid = false;
+			}
+		}
+
+	private:
+		const VFS::Manager* mVFS;
+		Result& mResult;
+	};
+
+	// Copies one texture from the VFS into the export folder on a thread pool thread,
+	// unless the export manifest shows the existing copy was made from identical source data.
+	class TextureExportJob : public QRunnable
+	{
+	public:
+		struct Result
+		{
+			std::string mInputPath;
+			std::string mOutputPath;
+			std::string mLogName;
+			bool mUnchanged;
+			std::string mError;
+
+			Result() : mUnchanged(false) {}
+		};
+
+		TextureExportJob(const VFS::Manager* vfs, Misc::ExportManifest& manifest, Result& result)
+			: mVFS(vfs), mManifest(manifest), mResult(result)
+		{}
+
+		virtual void run()
+		{
+			try
+			{
+				Files::IStreamPtr fileStream = mVFS->get(mResult.mInputPath);
+				std::vector<char> data;
+				Misc::ExportManifest::Hash hash = hashStream(*fileStream, &data);
+				if (mManifest.isUpToDate(mResult.mOutputPath, hash))
+				{
+					mResult.mUnchanged = true;
+					return;
+				}
+
+				// several jobs may create the same directory at once, so ignore "already exists" races
+				boost::filesystem::path p(mResult.mOutputPath);
+				boost::system::error_code ec;
+				boost::filesystem::create_directories(p.parent_path(), ec);
+
+				std::ofstream newDDSFile(p.string().c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+				if (data.empty() == false)
+					newDDSFile.write(&data[0], data.size());
+				newDDSFile.close();
+				if (newDDSFile.fail())
+					throw std::runtime_error("failed to write " + p.string());
+
+				mManifest.update(mResult.mOutputPath, hash);
+			}
+			catch (std::exception& e)
+			{
+				mResult.mError = e.what();
+			}
+		}
+
+	private:
+		const VFS::Manager* mVFS;
+		Misc::ExportManifest& mManifest;
+		Result& mResult;
+	};
+
+	// Where the points of the 17x17 VTXT grid fall on the 6x6 pre-blend map. The same for rows and columns,
+	// so the bilinear interpolation of every layer can use one table instead of recomputing it per point.
+	struct OpacityGridWeights
+	{
+		int mFloor[17];
+		float mWeight[17];
+		float mInvWeight[17];
+
+		OpacityGridWeights()
+		{
+			for (int i=0; i < 17; i++)
+			{
+				float map_u = (i/17.0); // (UV coords 0-1)
+				mFloor[i] = floor(map_u * 4)+1; // the highest is 4, so floor+1 stays inside the map
+				mWeight[i] = ((map_u*4)+1) - mFloor[i];
+				mInvWeight[i] = 1 - mWeight[i];
+			}
+		}
+	};
+
+	const OpacityGridWeights sOpacityGridWeights;
+
+	// Converts the textures of one land record on a thread pool thread
+	class LandTexturesJob : public QRunnable
+	{
+	public:
+		struct Result
+		{
+			std::pair<int, int> mLandXY;
+			std::vector<CSMDoc::ExportExteriorCellCollectionTES4Stage::QuadrantTextures> mQuadrants;
+			std::string mError;
+		};
+
+		LandTexturesJob(const CSMDoc::ExportExteriorCellCollectionTES4Stage& stage, Result& result)
+			: mStage(stage), mResult(result)
+		{}
+
+		virtual void run()
+		{
+			try
+			{
+				mStage.calculateQuadrantTextures(mResult.mLandXY.first, mResult.mLandXY.second, mResult.mQuadrants);
+			}
+			catch (std::exception& e)
+			{
+				mResult.mError = e.what();
+			}
+		}
+
+	private:
+		const CSMDoc::ExportExteriorCellCollectionTES4Stage& mStage;
+		Result& mResult;
+	};
+}
+
 /*
 namespace
 {
@@ -476,6 +686,8 @@ if ((esmName.find("TR_Mainland") != std::string::npos) ||
 
 void CSMDoc::ExportHeaderTES4Stage::perform (int stage, Messages& messages)
 {
+	// all stages have reserved their FormIDs in setup()
+	mState.getWriter().validateExportCache();
 	mState.getWriter().exportTES4 (mState.getStream());
 }
 
@@ -1564,9 +1776,12 @@ void CSMDoc::ExportAmmoCollectionTES4Stage::perform (int stage, Messages& messag
 //	std::string strEDID = writer.generateEDIDTES4(weaponRec.get().mId);
 //	uint32_t formID = writer.crossRefStringID(strEDID, "AMMO", false, true);
 
-	StartModRecord(sSIG, weaponRec.get().mId, writer, weaponRec.mState);
-	weaponRec.get().exportAmmoTESx(writer, 4);
-	writer.endRecordTES4(sSIG);
+	if (!WriteCachedModRecord(sSIG, weaponRec.get().mId, writer, hashSourceRecord(weaponRec)))
+	{
+		StartModRecord(sSIG, weaponRec.get().mId, writer, weaponRec.mState);
+		weaponRec.get().exportAmmoTESx(writer, 4);
+		writer.endRecordTES4(sSIG);
+	}
 
 	if (stage == mActiveRefCount-1 && numRecords > 0)
 	{
@@ -1666,9 +1881,12 @@ void CSMDoc::ExportWeaponCollectionTES4Stage::perform (int stage, Messages& mess
 			flags |= 0x800; // DISABLED
 		writer.startRecordTES4(sSIG, flags, formID, strEDID);
 */
-		StartModRecord(sSIG, weaponRec.get().mId, writer, weaponRec.mState);
-		weaponRec.get().exportTESx(writer, 4);
-		writer.endRecordTES4(sSIG);
+		if (!WriteCachedModRecord(sSIG, weaponRec.get().mId, writer, hashSourceRecord(weaponRec)))
+		{
+			StartModRecord(sSIG, weaponRec.get().mId, writer, weaponRec.mState);
+			weaponRec.get().exportTESx(writer, 4);
+			writer.endRecordTES4(sSIG);
+		}
 	}
 
 	if (stage == mActiveRecords.size()-1 && mActiveRecords.size() > 0)
@@ -1776,6 +1994,9 @@ void CSMDoc::ExportSoulgemCollectionTES4Stage::perform (int stage, Messages& mes
 			flags |= 0x800; // DISABLED
 		writer.startRecordTES4(sSIG, flags, formID, strEDID);
 */
+		if (WriteCachedModRecord(sSIG, soulgemRec.get().mId, writer, hashSourceRecord(soulgemRec)))
+			continue;
+
 		StartModRecord(sSIG, soulgemRec.get().mId, writer, soulgemRec.mState);
 		soulgemRec.get().exportTESx(writer, 4);
 		writer.startSubRecordTES4("SOUL");
@@ -1828,6 +2049,9 @@ void CSMDoc::ExportKeyCollectionTES4Stage::perform (int stage, Messages& message
 			flags |= 0x800; // DISABLED
 		writer.startRecordTES4(sSIG, flags, formID, strEDID);
 */
+		if (WriteCachedModRecord(sSIG, keyRecord.get().mId, writer, hashSourceRecord(keyRecord)))
+			continue;
+
 		StartModRecord(sSIG, keyRecord.get().mId, writer, keyRecord.mState);
 		keyRecord.get().exportTESx(writer, 4);
 		writer.endRecordTES4(sSIG);
@@ -3986,7 +4210,7 @@ void CSMDoc::ExportInteriorCellCollectionTES4Stage::perform (int stage, Messages
 
 CSMDoc::ExportExteriorCellCollectionTES4Stage::ExportExteriorCellCollectionTES4Stage (Document& document,
 	SavingState& state)
-	: mDocument (document), mState (state)
+	: mDocument (document), mState (state), mLandTexturesLoaded(false)
 {}
 
 int CSMDoc::ExportExteriorCellCollectionTES4Stage::setup()
@@ -3996,6 +4220,11 @@ int CSMDoc::ExportExteriorCellCollectionTES4Stage::setup()
 	int collectionSize = mDocument.getData().getCells().getSize();
 	std::ostringstream debugstream;
 
+	mLandTextures.clear();
+	mLandTexturesLoaded = false;
+	mQuadrantTextures.clear();
+	mPreparedBlocks.clear();
+
 	for (int i=0; i < collectionSize; i++)
 	{
 		CSMWorld::Record<CSMWorld::Cell>* cellRecordPtr = &mDocument.getData().getCells().getNthRecord(i);
@@ -4498,7 +4727,7 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::perform (int stage, Messages
 			{
 				debugstream << "landscape data found...";
 				int landIndex = mDocument.getData().getLand().getIndex(landID.str());
-				auto landRecord = mDocument.getData().getLand().getRecord(landIndex);
+				const CSMWorld::Record<CSMWorld::Land>& landRecord = mDocument.getData().getLand().getRecord(landIndex);
 				if (landRecord.isModified())
 					bLandscapePresent = true;
 			}
@@ -4599,19 +4828,16 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::perform (int stage, Messages
 					const ESM::Land::LandData *landData = mDocument.getData().getLand().getRecord(landIndex).get().getLandData(ESM::Land::DATA_VTEX);
 					if (landData != 0)
 					{
-						uint32_t texformID;
-						int i, j, u, v, quadVal = 0;
+						prepareQuadrantTextures(baseX / 2, baseY / 2);
+						const std::vector<QuadrantTextures>& quadrants = mQuadrantTextures[std::make_pair(baseX / 2, baseY / 2)];
+						int u, v, quadVal = 0;
 						for (v = 0; v < 2; v++)
 						{
 							for (u = 0; u < 2; u++)
 							{
-								createPreBlendMap(writer, (baseX / 2), (baseY / 2), x, y, u, v);
-								gatherPreBlendTextureList();
-								if (mPreBlendTextureList.size() > 0)
-								{
-									exportLTEX_basetexture(writer, quadVal);
-									exportLTEX_interpolatelayers(writer, quadVal);
-								}
+								const QuadrantTextures& textures = quadrants[(((y * 2) + x) * 2 + v) * 2 + u];
+								if (textures.mTextures.size() > 0)
+									writeQuadrantTextures(writer, textures, quadVal);
 								quadVal++;
 							}
 						}
@@ -4759,146 +4985,200 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::perform (int stage, Messages
 		// third one is the WRLD Top Group
 		writer.endGroupTES4("WRLD");
 	}
+	// all four subcells of the land are written
+	mQuadrantTextures.erase(std::make_pair(baseX / 2, baseY / 2));
+
 //	std::cout << "Erase the current sub-block" << std::endl;
 	subblock->begin()->second.erase( subblock->begin()->second.begin() );
 	mCellExportList.pop_back();
 	
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::exportLTEX_interpolatelayers(ESM::ESMWriter& writer, int quadVal)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::loadLandTextures()
 {
-	std::ostringstream debugstream;
-	int layer = -1;
-	uint32_t texformID;
-	auto tex_iter = mPreBlendTextureList.begin();
+	// copy the texture indices of all lands once, the land data of the document is loaded on demand
+	// and must not be touched from the worker threads
+	const CSMWorld::IdCollection<CSMWorld::Land>& lands = mDocument.getData().getLand();
+	for (int i=0; i < lands.getSize(); i++)
+	{
+		const CSMWorld::Land& land = lands.getRecord(i).get();
+		std::pair<CSMWorld::CellCoordinates, bool> coords = CSMWorld::CellCoordinates::fromId(land.mId);
+		const ESM::Land::LandData *landData = land.getLandData(ESM::Land::DATA_VTEX);
+		if (coords.second == false || landData == 0)
+			continue;
+
+		LandTextures& textures = mLandTextures[std::make_pair(coords.first.getX(), coords.first.getY())];
+		textures.mPlugin = land.mPlugin;
+		std::copy(landData->mTextures, landData->mTextures + ESM::Land::LAND_NUM_TEXTURES, textures.mTextures);
+	}
+	mLandTexturesLoaded = true;
+}
+
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::prepareQuadrantTextures(int landX, int landY)
+{
+	std::pair<int, int> landXY = std::make_pair(landX, landY);
+	if (mQuadrantTextures.find(landXY) != mQuadrantTextures.end())
+		return;
 
-	// iterate through the remaining textures, exporting each as a separate layer
-	for (tex_iter++; tex_iter != mPreBlendTextureList.end(); tex_iter++)
+	if (mLandTexturesLoaded == false)
+		loadLandTextures();
+
+	// cells are exported block by block, so convert the modified lands of the whole block (16x16 morrowind cells) at once
+	std::pair<int, int> blockXY = std::make_pair(static_cast<int>(std::floor(landX / 16.0)), static_cast<int>(std::floor(landY / 16.0)));
+	if (mPreparedBlocks.insert(blockXY).second == true)
 	{
-		layer++;
-		texformID = *tex_iter;
-		writer.startSubRecordTES4("ATXT");
-		writer.writeT<uint32_t>(texformID); // formID
-		writer.writeT<uint8_t>(quadVal); // quadrant
-		writer.writeT<uint8_t>(0); // unused
-		writer.writeT<int16_t>(layer); // 16bit layer
-		writer.endSubRecordTES4("ATXT");
+		std::vector<LandTexturesJob::Result> results;
+		const CSMWorld::IdCollection<CSMWorld::Land>& lands = mDocument.getData().getLand();
+		for (std::map<std::pair<int, int>, LandTextures>::const_iterator iter = mLandTextures.begin(); iter != mLandTextures.end(); ++iter)
+		{
+			if (std::floor(iter->first.first / 16.0) != blockXY.first || std::floor(iter->first.second / 16.0) != blockXY.second)
+				continue;
+			std::ostringstream landID;
+			landID << "#" << iter->first.first << " " << iter->first.second;
+			int landIndex = lands.searchId(landID.str());
+			if (landIndex == -1 || lands.getRecord(landIndex).isModified() == false)
+				continue;
 
-		debugstream.str(""); debugstream.clear();
-		debugstream << "[" << layer << "]Making OpacityMap: texformID=" << texformID << " ";
-		// create an opacity map for this layer, then export it as VTXT record
-		float opacityMap[17][17];
-		int map_x, map_y;
-		for (map_y = 0; map_y < 17; map_y++)
-		for (map_x = 0; map_x < 17; map_x++)
-		{
-			// bilinear interopolate texture
-			float map_u, map_v;
-			float neighbors[2][2];
-			map_u = ((map_x)/17.0); // (UV coords 0-1)
-			map_v = ((map_y)/17.0);
-			// assign neighbors (1.0 vs 0.0 if texture is present)
-			// find nearest neighbor coordinate (on 6x6 preblendmap)
-			int v_floor = floor(map_v * 4)+1;
-			int u_floor = floor(map_u * 4)+1;
-			int v_ceil = v_floor+1;
-			int u_ceil = u_floor+1;
-
-			if ((u_ceil >= 6) || (v_ceil >= 6))
-				throw std::runtime_error("ERROR: Landtex bilerp - preblend offsets out of bounds"); 
-
-			// get neighbor's values
-			neighbors[0][0] = (mPreBlendMap[u_floor][v_floor] == texformID) ? 1.0f : 0.0f;
-			neighbors[1][0] = (mPreBlendMap[u_ceil][v_floor] == texformID) ? 1.0f : 0.0f;
-			neighbors[0][1] = (mPreBlendMap[u_floor][v_ceil] == texformID) ? 1.0f : 0.0f;
-			neighbors[1][1] = (mPreBlendMap[u_ceil][v_ceil] == texformID) ? 1.0f : 0.0f;
-
-			// now do the actual interpolation
-			// first along x * 2
-			float x_lerp1, x_lerp2;
-			float wt_u = ((map_u*4)+1) - u_floor;
-			float wt_v = ((map_v*4)+1) - v_floor;
-			// calculate weights based on u==0 as texture A and u==1 as texture B
-			x_lerp1 = (neighbors[0][0] * (1-wt_u)) + (neighbors[1][0] * (wt_u));
-			x_lerp2 = (neighbors[0][1] * (1-wt_u)) + (neighbors[1][1] * (wt_u));
-			// then along y of the 2 prior results
-			float y_lerp;
-			y_lerp = (x_lerp1 * (1-wt_v)) + (x_lerp2 * (wt_v));
-//			if (y_lerp != 0)
-//				debugstream << "pos=[" << map_x << "," << map_y << "] uv=(" << map_u << "," << map_v << ") X1=" << x_lerp1 << " X2=" << x_lerp2 << " Y=" << y_lerp << "; ";
-
-			// now put it in the postmap
-			opacityMap[map_x][map_y] = y_lerp;
+			LandTexturesJob::Result result;
+			result.mLandXY = iter->first;
+			results.push_back(result);
 		}
-		debugstream << std::endl;
-//		OutputDebugString(debugstream.str().c_str());
 
-		int u, v;
-		uint16_t position=0;
-		float opacity=0;
-		writer.startSubRecordTES4("VTXT");
-		for (v=0; v < 17; v++)
-		for (u=0; u < 17; u++)
+		QThreadPool pool;
+		for (std::vector<LandTexturesJob::Result>::iterator iter = results.begin(); iter != results.end(); ++iter)
+			pool.start(new LandTexturesJob(*this, *iter));
+		pool.waitForDone();
+
+		for (std::vector<LandTexturesJob::Result>::iterator iter = results.begin(); iter != results.end(); ++iter)
 		{
-			opacity = opacityMap[u][v];
-			if (opacity > 0.0f)
-			{
-				writer.writeT<uint16_t>(position); // offset into 17x17 grid
-				writer.writeT<uint8_t>(0); // unused
-				writer.writeT<uint8_t>(0); // unused
-				writer.writeT<float>(opacity); // float opacity
-			}
-			position++;
+			if (iter->mError.empty() == false)
+				throw std::runtime_error(iter->mError);
+			mQuadrantTextures[iter->mLandXY].swap(iter->mQuadrants);
 		}
-		writer.endSubRecordTES4("VTXT");
 	}
 
+	// not part of the block's batch, e.g. the block was prepared before and this land was written already
+	if (mQuadrantTextures.find(landXY) == mQuadrantTextures.end())
+		calculateQuadrantTextures(landX, landY, mQuadrantTextures[landXY]);
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::exportLTEX_basetexture(ESM::ESMWriter& writer, int quadVal)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::calculateQuadrantTextures(int landX, int landY, std::vector<QuadrantTextures>& quadrants) const
 {
-	int texformID;
+	const OpacityGridWeights& weights = sOpacityGridWeights;
+	quadrants.clear();
+	quadrants.resize(16);
+
+	int subCX, subCY, quadX, quadY;
+	for (subCY=0; subCY < 2; subCY++)
+	for (subCX=0; subCX < 2; subCX++)
+	for (quadY=0; quadY < 2; quadY++)
+	for (quadX=0; quadX < 2; quadX++)
+	{
+		QuadrantTextures& result = quadrants[(((subCY * 2) + subCX) * 2 + quadY) * 2 + quadX];
+
+		PreBlendMap preBlendMap;
+		createPreBlendMap(preBlendMap, landX, landY, subCX, subCY, quadX, quadY);
+		gatherPreBlendTextureList(preBlendMap, result.mTextures);
+		if (result.mTextures.size() < 2)
+			continue;
+
+		// the first texture is the base layer, make an opacity map for each of the others
+		result.mLayerOpacity.resize(result.mTextures.size() - 1);
+		for (size_t layer=1; layer < result.mTextures.size(); layer++)
+		{
+			uint32_t texformID = result.mTextures[layer];
+			std::vector<std::pair<uint16_t, float> >& opacityList = result.mLayerOpacity[layer-1];
 
+			// 1.0 where the pre-blend map has this texture, 0.0 elsewhere, stored by row
+			float present[6][6];
+			for (int v=0; v < 6; v++)
+				for (int u=0; u < 6; u++)
+					present[v][u] = (preBlendMap[u][v] == texformID) ? 1.0f : 0.0f;
+
+			// bilinear interpolation of the 6x6 map into the 17x17 grid, one row at a time
+			uint16_t position = 0;
+			for (int map_y=0; map_y < 17; map_y++)
+			{
+				const float* row1 = present[weights.mFloor[map_y]];
+				const float* row2 = present[weights.mFloor[map_y] + 1];
+				float x1_floor[17], x1_ceil[17], x2_floor[17], x2_ceil[17];
+				for (int map_x=0; map_x < 17; map_x++)
+				{
+					x1_floor[map_x] = row1[weights.mFloor[map_x]];
+					x1_ceil[map_x] = row1[weights.mFloor[map_x] + 1];
+					x2_floor[map_x] = row2[weights.mFloor[map_x]];
+					x2_ceil[map_x] = row2[weights.mFloor[map_x] + 1];
+				}
+
+				float wt_v = weights.mWeight[map_y];
+				float inv_wt_v = weights.mInvWeight[map_y];
+				float opacity[17];
+				// no dependencies between the columns, so the compiler can vectorize this loop
+				for (int map_x=0; map_x < 17; map_x++)
+				{
+					float x_lerp1 = (x1_floor[map_x] * weights.mInvWeight[map_x]) + (x1_ceil[map_x] * weights.mWeight[map_x]);
+					float x_lerp2 = (x2_floor[map_x] * weights.mInvWeight[map_x]) + (x2_ceil[map_x] * weights.mWeight[map_x]);
+					opacity[map_x] = (x_lerp1 * inv_wt_v) + (x_lerp2 * wt_v);
+				}
+
+				for (int map_x=0; map_x < 17; map_x++, position++)
+				{
+					if (opacity[map_x] > 0.0f)
+						opacityList.push_back(std::make_pair(position, opacity[map_x]));
+				}
+			}
+		}
+	}
+}
+
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::writeQuadrantTextures(ESM::ESMWriter& writer, const QuadrantTextures& textures, int quadVal)
+{
 	// export first texture as the base layer
-	int16_t layer = -1;
-	auto tex_iter = mPreBlendTextureList.begin();
-	texformID = *tex_iter;
 	writer.startSubRecordTES4("BTXT");
-	writer.writeT<uint32_t>(texformID); // formID
+	writer.writeT<uint32_t>(textures.mTextures[0]); // formID
 	writer.writeT<uint8_t>(quadVal); // quadrant
 	writer.writeT<uint8_t>(0); // unused
-	writer.writeT<int16_t>(layer); // 16bit layer
+	writer.writeT<int16_t>(-1); // 16bit layer
 	writer.endSubRecordTES4("BTXT");
 
+	// export each of the remaining textures as a separate layer
+	for (size_t layer=0; layer < textures.mLayerOpacity.size(); layer++)
+	{
+		writer.startSubRecordTES4("ATXT");
+		writer.writeT<uint32_t>(textures.mTextures[layer+1]); // formID
+		writer.writeT<uint8_t>(quadVal); // quadrant
+		writer.writeT<uint8_t>(0); // unused
+		writer.writeT<int16_t>(static_cast<int16_t>(layer)); // 16bit layer
+		writer.endSubRecordTES4("ATXT");
+
+		const std::vector<std::pair<uint16_t, float> >& opacityList = textures.mLayerOpacity[layer];
+		writer.startSubRecordTES4("VTXT");
+		for (std::vector<std::pair<uint16_t, float> >::const_iterator iter = opacityList.begin(); iter != opacityList.end(); ++iter)
+		{
+			writer.writeT<uint16_t>(iter->first); // offset into 17x17 grid
+			writer.writeT<uint8_t>(0); // unused
+			writer.writeT<uint8_t>(0); // unused
+			writer.writeT<float>(iter->second); // float opacity
+		}
+		writer.endSubRecordTES4("VTXT");
+	}
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::gatherPreBlendTextureList()
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::gatherPreBlendTextureList(const PreBlendMap& preBlendMap, std::vector<uint32_t>& textureList) const
 {
 	int x, y;
 	uint32_t formID;
-	mPreBlendTextureList.clear();
+	textureList.clear();
 
 	// gather central 4x4
 	for (y=1; y < 5; y++)
 		for (x=1; x < 5; x++)
 		{
-			formID = mPreBlendMap[x][y];
+			formID = preBlendMap[x][y];
 			if (formID == 0)
 				continue;
-			auto tex_iter = mPreBlendTextureList.begin();
-			bool matchFound = false;
-			for (; tex_iter != mPreBlendTextureList.end(); tex_iter++)
-			{
-				if (*tex_iter == formID)
-				{
-					matchFound = true;
-					break;
-				}
-			}
-			if (matchFound == false)
-			{
-				mPreBlendTextureList.push_back(formID);
-			}
+			if (std::find(textureList.begin(), textureList.end(), formID) == textureList.end())
+				textureList.push_back(formID);
 		}
 	// gather borders areas
 	for (y=0; y < 6; y++)
@@ -4906,33 +5186,25 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::gatherPreBlendTextureList()
 		{
 			if (x == 0 || x == 5 || y == 0 || y == 5) 
 			{
-				formID = mPreBlendMap[x][y];
+				formID = preBlendMap[x][y];
 				if (formID == 0)
 					continue;
-				auto tex_iter = mPreBlendTextureList.begin();
-				bool matchFound = false;
-				for (; tex_iter != mPreBlendTextureList.end(); tex_iter++)
-				{
-					if (*tex_iter == formID)
-					{
-						matchFound = true;
-						break;
-					}
-				}
-				if (matchFound == false)
-				{
-					mPreBlendTextureList.push_back(formID);
-				}
+				if (std::find(textureList.begin(), textureList.end(), formID) == textureList.end())
+					textureList.push_back(formID);
 			}
 		}
 
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::createPreBlendMap(ESM::ESMWriter& writer, int origX, int origY, int subCX, int subCY, int quadX, int quadY)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::createPreBlendMap(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY) const
 {
-	std::ostringstream landID, debugstream;
-	const ESM::Land::LandData *landData;
-	int landIndex, plugindex;
+	const LandTextures *landData;
+	int plugindex;
+
+	// cells without land data are left out of the texture list
+	for (int x=0; x < 6; x++)
+		for (int y=0; y < 6; y++)
+			preBlendMap[x][y] = 0;
 
 	// get central 4x4 grid
 	if (getLandDataFromXY(origX, origY, plugindex, landData) == true)
@@ -4940,32 +5212,26 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::createPreBlendMap(ESM::ESMWr
 		int x, y;
 		for (y=0; y < 4; y++)
 			for (x=0; x < 4; x++)
-				drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, x, y, x+1, y+1);
+				drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, x, y, x+1, y+1);
 
 		// get 4 sides...
 		// get side X-1
-		drawLeftBorder(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawRightBorder(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawTopBorder(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawBottomBorder(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawLeftBorder(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawRightBorder(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawTopBorder(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawBottomBorder(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
 
 		// get 4 corners
-		drawTopLeftCorner(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawTopRightCorner(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawBottomLeftCorner(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
-		drawBottomRightCorner(origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawTopLeftCorner(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawTopRightCorner(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawBottomLeftCorner(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
+		drawBottomRightCorner(preBlendMap, origX, origY, subCX, subCY, quadX, quadY, plugindex, landData);
 
 	}
-	else
-	{
-		debugstream.str(""); debugstream.clear();
-		debugstream << "ERROR: createPreBlendMap-getLandDataFromXY: no landData found" << std::endl;
-//		OutputDebugString(debugstream.str().c_str());
-	}
 
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopLeftCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopLeftCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	int origX2=origX, origY2=origY;
 	int subCX2=subCX, quadX2=quadX;
@@ -5001,21 +5267,21 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopLeftCorner(int origX,
 			quadY2 = 0;
 		}
 	}
-	const ESM::Land::LandData* tempData;
+	const LandTextures* tempData;
 	int plugindex2;
 	if (getLandDataFromXY (origX2, origY2, plugindex2, tempData) == true)
 	{
-		drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 3, 0, 0, 5);
+		drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 3, 0, 0, 5);
 	}
 	else
 	{
 		// feather to blank or make hard edge
-		drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 0, 3, 0, 5);
+		drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 0, 3, 0, 5);
 	}
 
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopRightCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopRightCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	int origX2=origX, origY2=origY;
 	int subCX2=subCX, quadX2=quadX;
@@ -5051,21 +5317,21 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopRightCorner(int origX
 			quadY2 = 0;
 		}
 	}
-	const ESM::Land::LandData* tempData;
+	const LandTextures* tempData;
 	int plugindex2;
 	if (getLandDataFromXY (origX2, origY2, plugindex2, tempData) == true)
 	{
-		drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 0, 0, 5, 5);
+		drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 0, 0, 5, 5);
 	}
 	else
 	{
 		// feather to blank or make hard edge
-		drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 3, 3, 5, 5);
+		drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 3, 3, 5, 5);
 	}
 
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomLeftCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomLeftCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	int origX2=origX, origY2=origY;
 	int subCX2=subCX, quadX2=quadX;
@@ -5101,21 +5367,21 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomLeftCorner(int ori
 			quadY2 = 1;
 		}
 	}
-	const ESM::Land::LandData* tempData;
+	const LandTextures* tempData;
 	int plugindex2;
 	if (getLandDataFromXY (origX2, origY2, plugindex2, tempData) == true)
 	{
-		drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 3, 3, 0, 0);
+		drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 3, 3, 0, 0);
 	}
 	else
 	{
 		// feather to blank or make hard edge
-		drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 0, 0, 0, 0);
+		drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 0, 0, 0, 0);
 	}
 
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomRightCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomRightCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	int origX2=origX, origY2=origY;
 	int subCX2=subCX, quadX2=quadX;
@@ -5151,22 +5417,22 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomRightCorner(int or
 			quadY2 = 1;
 		}
 	}
-	const ESM::Land::LandData* tempData;
+	const LandTextures* tempData;
 	int plugindex2;
 	if (getLandDataFromXY (origX2, origY2, plugindex2, tempData) == true)
 	{
-		drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 0, 3, 5, 0);
+		drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY2, quadX2, quadY2, 0, 3, 5, 0);
 	}
 	else
 	{
 		// feather to blank or make hard edge
-		drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 3, 0, 5, 0);
+		drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 3, 0, 5, 0);
 	}
 
 }
 
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawLeftBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawLeftBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	// get side X-1
 	int subCX2=subCX, quadX2=quadX;
@@ -5176,7 +5442,7 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawLeftBorder(int origX, in
 		quadX2=0;
 		int y;
 		for (y=0; y < 4; y++)
-			drawPreBlendMapXY(landData, plugindex, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
 	}
 	else if (subCX == 1)
 	{
@@ -5185,31 +5451,31 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawLeftBorder(int origX, in
 		quadX2=1;
 		int y;
 		for (y=0; y < 4; y++)
-			drawPreBlendMapXY(landData, plugindex, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
 	}
 	else
 	{
 		// retrieve from origX-1, subCX=1, quadX=1
 		subCX2=1;
 		quadX2=1;
-		const ESM::Land::LandData* tempData;
+		const LandTextures* tempData;
 		int plugindex2;
 		if (getLandDataFromXY (origX-1, origY, plugindex2, tempData) == true)
 		{
 			int y;
 			for (y=0; y < 4; y++)
-				drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
+				drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY, quadX2, quadY, 3, y, 0, y+1);
 		}
 		else
 		{
 			// feather to blank or make hard edge
 			for (int y=0; y < 4; y++)
-				drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 0, y, 0, y+1);
+				drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 0, y, 0, y+1);
 		}
 	}
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawRightBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawRightBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	// get side X+1
 	int subCX2=subCX, quadX2=quadX;
@@ -5218,7 +5484,7 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawRightBorder(int origX, i
 		// retrieve from quadX=0;
 		quadX2=1;
 		for (int y=0; y < 4; y++)
-			drawPreBlendMapXY(landData, plugindex, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
 	}
 	else if (subCX == 0)
 	{
@@ -5226,30 +5492,30 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawRightBorder(int origX, i
 		subCX2=1;
 		quadX2=0;
 		for (int y=0; y < 4; y++)
-			drawPreBlendMapXY(landData, plugindex, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
 	}
 	else
 	{
 		// retrieve from origX+1, subCX=1, quadX=1
 		subCX2=0;
 		quadX2=0;
-		const ESM::Land::LandData* tempData;
+		const LandTextures* tempData;
 		int plugindex2;
 		if (getLandDataFromXY (origX+1, origY, plugindex2, tempData) == true)
 		{
 			for (int y=0; y < 4; y++)
-				drawPreBlendMapXY(tempData, plugindex2, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
+				drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX2, subCY, quadX2, quadY, 0, y, 5, y+1);
 		}
 		else
 		{
 			// feather to blank or make hard edge
 			for (int y=0; y < 4; y++)
-				drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, 3, y, 5, y+1);
+				drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, 3, y, 5, y+1);
 		}
 	}
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	// get side Y+1
 	int subCY2=subCY, quadY2=quadY;
@@ -5258,7 +5524,7 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopBorder(int origX, int
 		// retrieve from quadX=0;
 		quadY2=1;
 		for (int x=0; x < 4; x++)
-			drawPreBlendMapXY(landData, plugindex, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
 	}
 	else if (subCY == 0)
 	{
@@ -5266,30 +5532,30 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawTopBorder(int origX, int
 		subCY2=1;
 		quadY2=0;
 		for (int x=0; x < 4; x++)
-			drawPreBlendMapXY(landData, plugindex, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
 	}
 	else
 	{
 		// retrieve from origX+1, subCX=1, quadX=1
 		subCY2=0;
 		quadY2=0;
-		const ESM::Land::LandData* tempData;
+		const LandTextures* tempData;
 		int plugindex2;
 		if (getLandDataFromXY (origX, origY+1, plugindex2, tempData) == true)
 		{
 			for (int x=0; x < 4; x++)
-				drawPreBlendMapXY(tempData, plugindex2, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
+				drawPreBlendMapXY(preBlendMap, tempData, plugindex2, subCX, subCY2, quadX, quadY2, x, 0, x+1, 5);
 		}
 		else
 		{
 			// feather to blank or make hard edge
 			for (int x=0; x < 4; x++)
-				drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, x, 3, x+1, 5);
+				drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, x, 3, x+1, 5);
 		}
 	}
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const
 {
 	// get side Y-1
 	int subCY2=subCY, quadY2=quadY;
@@ -5298,7 +5564,7 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomBorder(int origX,
 		// retrieve from quadX=0;
 		quadY2=0;
 		for (int x=0; x < 4; x++)
-			drawPreBlendMapXY(landData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
 	}
 	else if (subCY == 1)
 	{
@@ -5306,130 +5572,81 @@ void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawBottomBorder(int origX,
 		subCY2=0;
 		quadY2=1;
 		for (int x=0; x < 4; x++)
-			drawPreBlendMapXY(landData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
+			drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
 	}
 	else
 	{
 		// retrieve from origY-1, subCX=1, quadX=1
 		subCY2=1;
 		quadY2=1;
-		const ESM::Land::LandData* tempData;
+		const LandTextures* tempData;
 		int plugindex2;
 		if (getLandDataFromXY (origX, origY-1, plugindex2, tempData) == true)
 		{
 			for (int x=0; x < 4; x++)
-				drawPreBlendMapXY(tempData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
+				drawPreBlendMapXY(preBlendMap, tempData, plugindex, subCX, subCY2, quadX, quadY2, x, 3, x+1, 0);
 		}
 		else
 		{
 			// feather to blank or make hard edge
 			for (int x=0; x < 4; x++)
-				drawPreBlendMapXY(landData, plugindex, subCX, subCY, quadX, quadY, x, 0, x+1, 0);
+				drawPreBlendMapXY(preBlendMap, landData, plugindex, subCX, subCY, quadX, quadY, x, 0, x+1, 0);
 		}
 	}
 }
 
-bool CSMDoc::ExportExteriorCellCollectionTES4Stage::getLandDataFromXY(int origX, int origY, int& plugindex, const ESM::Land::LandData*& landData)
+bool CSMDoc::ExportExteriorCellCollectionTES4Stage::getLandDataFromXY(int origX, int origY, int& plugindex, const LandTextures*& landData) const
 {
-	std::ostringstream landID, debugstream;
-	int landIndex;
+	// lands that are missing or have no vtex data are expected at the borders of the world, not necessarily an error
+	std::map<std::pair<int, int>, LandTextures>::const_iterator found = mLandTextures.find(std::make_pair(origX, origY));
+	if (found == mLandTextures.end())
+		return false;
 
-	landID.str(""); landID.clear();
-	landID << "#" << origX << " " << origY;
-	if (mDocument.getData().getLand().searchId(landID.str()) != -1)
-	{
-		landIndex = mDocument.getData().getLand().getIndex(landID.str());
-		int plugtemp = mDocument.getData().getLand().getRecord(landIndex).get().mPlugin;
-//		if (plugtemp == 0)
-//			plugtemp = mDocument.getData().getLand().getRecord(landIndex).getBase().mPlugin;
-		plugindex = plugtemp;
-		landData = mDocument.getData().getLand().getRecord(landIndex).get().getLandData(ESM::Land::DATA_VTEX);
-		if (landData != 0)
-			return true;
-		else
-		{
-			debugstream << "WARNING: getLandDataFromXY[" << origX << "," << origY << "] - no vtex data" << std::endl;
-//			OutputDebugString(debugstream.str().c_str());
-//			throw std::runtime_error("ERROR: getLandDataFromXY - no vtex data");
-		}
-	}
-	else
-	{
-		// This is an expected outcome to detect border regions.. not necessarily an error
-		debugstream << "WARNING: getLandDataFromXY[" << origX << "," << origY << "] - couldn't find landID" << std::endl;
-//		OutputDebugString(debugstream.str().c_str());
-	}
-
-	return false;
+	plugindex = found->second.mPlugin;
+	landData = &found->second;
+	return true;
 }
 
-void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawPreBlendMapXY(const ESM::Land::LandData *landData, int plugindex, int subCX, int subCY, int quadX, int quadY, int inputX, int inputY, int outputX, int outputY)
+void CSMDoc::ExportExteriorCellCollectionTES4Stage::drawPreBlendMapXY(PreBlendMap& preBlendMap, const LandTextures *landData, int plugindex, int subCX, int subCY, int quadX, int quadY, int inputX, int inputY, int outputX, int outputY) const
 {
 	uint32_t defaultTex = 0x8C0; // TerrainHDDirt01dds
-	std::ostringstream debugstream;
 
 	int yoffset = (subCY*8) + (quadY*4) + inputY;
 	int xoffset = (subCX*8) + (quadX*4) + inputX;
 	if (landData == 0)
-	{
-		debugstream << "ERROR: drawPreBlendMapXY - landData is null!" << std::endl;
-//		OutputDebugString(debugstream.str().c_str());
-		throw std::runtime_error(debugstream.str().c_str());
-	}
+		throw std::runtime_error("ERROR: drawPreBlendMapXY - landData is null!");
 	int texindex = landData->mTextures[(yoffset*16)+xoffset]-1;
 	if (texindex == -1)
 	{
 		// using locally defined defaultTex above
-		mPreBlendMap[outputX][outputY] = defaultTex;
+		preBlendMap[outputX][outputY] = defaultTex;
 		return; 
 	}
-	int current_plugindex = plugindex;
-	auto lookup = mState.mLandTexLookup_Plugin_Index[plugindex].find(texindex);
-	if (lookup == mState.mLandTexLookup_Plugin_Index[plugindex].end())
+
+	// look up the texture in its own plugin first, then in all others (read only, this runs on several threads)
+	const std::map<int, std::map<int, uint32_t> >& lookupTable = mState.mLandTexLookup_Plugin_Index;
+	std::map<int, std::map<int, uint32_t> >::const_iterator pluginMap_it = lookupTable.find(plugindex);
+	if (pluginMap_it != lookupTable.end())
 	{
-//		mPreBlendMap[outputX][outputY] = defaultTex;
-//		return;
-		debugstream.str("");
-		debugstream << "WARNING: drawPreBlendMapXY - couldn't resolve texindex=" << texindex << ", (plugin=" << plugindex << "), attempting to search other plugins..." << "\n";
-//		OutputDebugString(debugstream.str().c_str());
-		auto pluginMap_it = mState.mLandTexLookup_Plugin_Index.begin();
-		current_plugindex = pluginMap_it->first;
-		lookup = pluginMap_it->second.find(texindex);
-		while (lookup == pluginMap_it->second.end())
+		std::map<int, uint32_t>::const_iterator lookup = pluginMap_it->second.find(texindex);
+		if (lookup != pluginMap_it->second.end())
 		{
-			pluginMap_it++;
-			if (pluginMap_it != mState.mLandTexLookup_Plugin_Index.end())
-			{
-				current_plugindex = pluginMap_it->first;
-				lookup = pluginMap_it->second.find(texindex);
-			}
-			else
-			{
-				debugstream.str("");
-				debugstream << "ERROR: drawPreBlendMapXY - couldn't resolve texindex=" << texindex << ", (plugin=" << plugindex << "), using defaultTexture." << std::endl;
-//				OutputDebugString(debugstream.str().c_str());
-				// just use defaultTex to continue gracefully instead of crashing
-				mPreBlendMap[outputX][outputY] = defaultTex;
-				return;
-			}
+			preBlendMap[outputX][outputY] = lookup->second;
+			return;
 		}
 	}
-	if (plugindex != current_plugindex)
+	for (pluginMap_it = lookupTable.begin(); pluginMap_it != lookupTable.end(); pluginMap_it++)
 	{
-		debugstream.str("");
-		debugstream << "DEBUG: drawPreBlendMapXY - couldn't resolve texindex=" << texindex << " (plugin=" << plugindex << "), using plugin=" << current_plugindex << " instead.\n";
-//		OutputDebugString(debugstream.str().c_str());
-//		std::cout << "X";
-	}
-	else
-	{
-		debugstream.str("");
-		debugstream << "DEBUG: drawPreBlendMapXY - successfully resolved texindex=" << texindex << ", (plugin=" << plugindex << "), using plugin=" << current_plugindex << ".\n";
-//		OutputDebugString(debugstream.str().c_str());
-//		std::cout << "+";
+		std::map<int, uint32_t>::const_iterator lookup = pluginMap_it->second.find(texindex);
+		if (lookup != pluginMap_it->second.end())
+		{
+			preBlendMap[outputX][outputY] = lookup->second;
+			return;
+		}
 	}
-	uint32_t texformID = lookup->second;
-	mPreBlendMap[outputX][outputY] = texformID;
+
+	// just use defaultTex to continue gracefully instead of crashing
+	preBlendMap[outputX][outputY] = defaultTex;
 }
 
 // iterate through the 4x4 grid for this quadrant and add index=formID pair to map if not already there
@@ -5853,15 +6070,7 @@ void CSMDoc::FinalizeExportTES4Stage::MakeBatchNIFFiles(ESM::ESMWriter& esm)
 	std::string oblivionOutput = outputRoot + "Oblivion.output/";
 #endif
 */
-	std::string outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
-	if (outputRoot.length() == 0)
-	{
-#ifdef _WIN32
-		std::string outputRoot = "C:";
-#else
-		std::string outputRoot = getenv("HOME");
-#endif
-	}
+	std::string outputRoot = Misc::getExportOutputRoot();
 	outputRoot += "/";
 	std::string oblivionOutput = outputRoot + "Oblivion.output/";
 
@@ -5981,10 +6190,48 @@ void CSMDoc::FinalizeExportTES4Stage::MakeBatchNIFFiles(ESM::ESMWriter& esm)
 		batchFileLODNIFConv << "cd ..\n";
 	}
 
+	// Blender conversions are the slowest part of an export: hash the meshes they would read
+	// in parallel, so that models whose output is still up to date can be left out of the job lists.
+	std::vector<ModelHashJob::Result> modelHashes;
+	if (bBlenderOutput || bBlenderVWD)
+	{
+		modelHashes.resize(esm.mModelsToExportList.size());
+		QThreadPool hashPool;
+		for (size_t i = 0; i < esm.mModelsToExportList.size(); ++i)
+		{
+			const std::pair<std::string, std::pair<std::string, int>>& item = esm.mModelsToExportList[i];
+			ModelHashJob::Result& result = modelHashes[i];
+			result.mTempPath = oblivionOutput + "temp/Meshes/" + Misc::ResourceHelpers::getNormalizedPath(item.second.first);
+			result.mVFSPath = "meshes/" + Misc::ResourceHelpers::correctActorModelPath(item.first, mDocument.getVFS());
+			std::ostringstream salt;
+			salt << item.second.second << ":" << bFullResCollision;
+			result.mSalt = salt.str();
+
+			hashPool.start(new ModelHashJob(mDocument.getVFS(), result));
+		}
+		hashPool.waitForDone();
+	}
+	int skippedModels = 0;
+
 	int linecount = 0, far_linecount=0;
 	int nSpawnCount = 0;
 	for (auto nifConvItem = esm.mModelsToExportList.begin(); nifConvItem != esm.mModelsToExportList.end(); nifConvItem++)
 	{
+		bool bModelUpToDate = false;
+		if (!modelHashes.empty())
+		{
+			const ModelHashJob::Result& hashResult = modelHashes[nifConvItem - esm.mModelsToExportList.begin()];
+			std::string finalPath = oblivionOutput + "Data/Meshes/" + Misc::ResourceHelpers::getNormalizedPath(nifConvItem->second.first);
+			if (hashResult.mValid)
+			{
+				bModelUpToDate = esm.mExportManifest.isUpToDate(finalPath, hashResult.mHash);
+				// Blender runs after the export, so the model only counts as converted once its job has
+				// rewritten the output; a stale mesh from an earlier export is queued again
+				if (!bModelUpToDate)
+					esm.mExportManifest.updatePending(finalPath, hashResult.mHash);
+			}
+		}
+
 		std::string rawFilename = nifConvItem->first;
 		std::string nifInputName = "";
 		std::string nifOutputName = "";
@@ -6062,7 +6309,7 @@ void CSMDoc::FinalizeExportTES4Stage::MakeBatchNIFFiles(ESM::ESMWriter& esm)
 				batchFileLODNIFConv << "NIF_Conv.exe " << nifInputName << " -l 15 -s 0 -q 0 -f -c " << " -d " << lodFileName << "\n";
 			}
 
-			if (bBlenderVWD)
+			if (bBlenderVWD && bModelUpToDate == false)
 			{
 				// create New BlenderOutList
 //				blenderOutList_far << Misc::ResourceHelpers::getNormalizedPath(nifOutputName).substr(0, nifOutputName.length() - 4) + "_far.nif" << "\n";
@@ -6109,7 +6356,11 @@ void CSMDoc::FinalizeExportTES4Stage::MakeBatchNIFFiles(ESM::ESMWriter& esm)
 			// create New BlenderOutList (currently only types 1 & 2 supported
 //			if (nifConvItem->second.second == 0 ||
 //				nifConvItem->second.second == 1)
-			if (true)
+			if (bModelUpToDate)
+			{
+				skippedModels++;
+			}
+			else
 			{
 				if (bFullResCollision)
 					blenderOutList_fullres << Misc::ResourceHelpers::getNormalizedPath(nifOutputName) << ":" << nifInputName << ":" << cmdFlags << "\n";
@@ -6176,6 +6427,8 @@ void CSMDoc::FinalizeExportTES4Stage::MakeBatchNIFFiles(ESM::ESMWriter& esm)
         blenderOutList.close();
         blenderOutList_far.close();
     }
+	if (skippedModels > 0)
+		std::cout << std::endl << skippedModels << " models unchanged since the last export, skipping conversion." << std::endl;
 
 	// ****************
 	// ARMOR conversion
@@ -6262,15 +6515,7 @@ void CSMDoc::FinalizeExportTES4Stage::ExportDDSFiles(ESM::ESMWriter & esm)
 	std::string logFileStem = "Exported_TextureList_" + modStem;
 	std::ofstream logFileDDSConv;
 
-	std::string outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
-	if (outputRoot.length() == 0)
-	{
-#ifdef _WIN32
-		std::string outputRoot = "C:";
-#else
-		std::string outputRoot = getenv("HOME");
-#endif
-	}
+	std::string outputRoot = Misc::getExportOutputRoot();
 	outputRoot += "/";
 	std::string logRoot = outputRoot + "Oblivion.output/";
 
@@ -6284,12 +6529,14 @@ void CSMDoc::FinalizeExportTES4Stage::ExportDDSFiles(ESM::ESMWriter & esm)
 	{
 		boost::filesystem::create_directories(rootDir);
 	}
+
+	// resolve paths on this thread, then copy the files on the thread pool
+	std::vector<TextureExportJob::Result> jobs;
+	std::set<std::string> queuedOutputs;
 	for (auto ddsConvItem = esm.mDDSToExportList.begin(); ddsConvItem != esm.mDDSToExportList.end(); ddsConvItem++)
 	{
 		std::string mw_filename = "";
 		std::string ob_filename = "";
-//		mw_filename = get_normalized_path(ddsConvItem->first);
-//		ob_filename = get_normalized_path(ddsConvItem->second.first);
         mw_filename = Misc::ResourceHelpers::getNormalizedPath(ddsConvItem->first);
         ob_filename = Misc::ResourceHelpers::getNormalizedPath(ddsConvItem->second.first);
 
@@ -6298,7 +6545,6 @@ void CSMDoc::FinalizeExportTES4Stage::ExportDDSFiles(ESM::ESMWriter & esm)
 		if (mode == 0) // landscape == 0
 		{
 			inputFilepath = Misc::ResourceHelpers::correctTexturePath(mw_filename, mDocument.getVFS());
-//            Misc::ResourceHelpers::getNormalizedPath(inputFilepath);
 			outputFilepath = "Textures/Landscape/" + ob_filename;
 		}
 		else if (mode == 1) // icons == 1
@@ -6327,114 +6573,48 @@ void CSMDoc::FinalizeExportTES4Stage::ExportDDSFiles(ESM::ESMWriter & esm)
         {
             continue;
         }
-        std::cout << ".";
 
-		logFileDDSConv << inputFilepath << "," << outputFilepath << ",";
-
-		try 
+		// the same texture is usually queued by many records, only copy it once
+		std::string outputPath = outputRoot + "Oblivion.output/Data/" + outputFilepath;
+		if (queuedOutputs.insert(Misc::StringUtils::lowerCase(outputPath)).second == false)
 		{
-			auto fileStream = mDocument.getVFS()->get(inputFilepath);
-			std::ofstream newDDSFile;
-			// create output subdirectories
-			boost::filesystem::path p(outputRoot + "Oblivion.output/Data/" + outputFilepath);
-			if (boost::filesystem::exists(p.parent_path()) == false)
-			{
-				boost::filesystem::create_directories(p.parent_path());
-			}
-			// DO NOT COPY IF FILE EXISTS
-			if (boost::filesystem::exists(p.string()) == true)
-			{
-				continue;
-			}
-			newDDSFile.open(p.string(), std::ofstream::out | std::ofstream::binary );
-
-/*
-			osgDB::ReaderWriter* imageReader = osgDB::Registry::instance()->getReaderWriterForExtension(inputFilepath.substr(inputFilepath.find_last_of(".")+1));
-//			osgDB::ReaderWriter* tgaWriter = osgDB::Registry::instance()->getReaderWriterForExtension("tga");
-			osgDB::ReaderWriter* ddsWriter = osgDB::Registry::instance()->getReaderWriterForExtension("dds");
-			auto result = imageReader->readImage(*fileStream);
-			osg::Image *tempImage = result.getImage();
-			if (tempImage != NULL)
-			{
-				if (mode == 1)
-				{
-					if (tempImage->getInternalTextureFormat() == GL_COMPRESSED_RGB_S3TC_DXT1_EXT ||
-						tempImage->getInternalTextureFormat() == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT ||
-						tempImage->getInternalTextureFormat() == GL_COMPRESSED_RGBA_S3TC_DXT3_EXT ||
-						tempImage->getInternalTextureFormat() == GL_COMPRESSED_RGBA_S3TC_DXT5_EXT)
-					{
-//						std::cout << " - S3TC detected.\n";
-					}
-					else
-					{
-//						icon->scaleImage(64, 64, 1);
-					}
-				}
-//				ddsWriter->writeImage(*tempImage, newDDSFile);
-//				imageReader->writeImage(*tempImage, newDDSFile);				
-			}
-			else
-			{
-				std::cout << "Failed to load: " << p.string() << "\n";
-			}
-*/
-			int len = 0;
-			char buffer[1024];
-			while (fileStream->eof() == false)
-			{
-				fileStream->read(buffer, sizeof(buffer));
-				len = fileStream->gcount();
-				newDDSFile.write(buffer, len);
-			}
-
-			newDDSFile.close();
-
-/*
-			// if icon, scale x2
-			if (mode == -1)
-			{
+			continue;
+		}
 
-				// open image from first file
+		TextureExportJob::Result job;
+		job.mInputPath = inputFilepath;
+		job.mOutputPath = outputPath;
+		job.mLogName = outputFilepath;
+		jobs.push_back(job);
+	}
 
-				osg::Image *tempIcon = osgDB::readImageFile(p.string());
-				if (tempIcon != NULL)
-				{
-					if (tempIcon->s() == 64)
-					{
-						std::string errorMesg = "[" + p.string() + "]: icon width already 64";
-						throw (std::runtime_error(errorMesg.c_str()));
-					}
-					tempIcon->scaleImage(64, 64, 1);
-					if (tempIcon->s() == 64)
-					{
-						// write out final file
-						if (osgDB::writeImageFile((*tempIcon), p.string()) == true)
-						{
-							std::cout << "scaling success: " << p.string() << "\n";
-						}
-					}
-					else
-					{
-						std::string errorMesg = "[" + p.string() + "]: unable scale to 64";
-						throw (std::runtime_error(errorMesg.c_str()));
-					}
-				}
+	QThreadPool pool;
+	for (auto job = jobs.begin(); job != jobs.end(); job++)
+	{
+		pool.start(new TextureExportJob(mDocument.getVFS(), esm.mExportManifest, *job));
+	}
+	pool.waitForDone();
 
-			}
-*/
-			logFileDDSConv << "export success\n";
+	int exported = 0, unchanged = 0;
+	for (auto job = jobs.begin(); job != jobs.end(); job++)
+	{
+		if (job->mError.empty() == false)
+		{
+			std::cout << "Error: (" << job->mInputPath << ") " << job->mError << "\n";
+			logFileDDSConv << job->mInputPath << "," << job->mLogName << "," << "export error\n";
 		}
-		catch (std::runtime_error e)
+		else if (job->mUnchanged)
 		{
-			std::cout << "Error: (" << inputFilepath << ") " << e.what() << "\n";
-			logFileDDSConv << "export error\n";
+			unchanged++;
+			logFileDDSConv << job->mInputPath << "," << job->mLogName << "," << "unchanged\n";
 		}
-		catch (...)
+		else
 		{
-			std::cout << "ERROR: something else bad happened!\n";
+			exported++;
+			logFileDDSConv << job->mInputPath << "," << job->mLogName << "," << "export success\n";
 		}
 	}
-	std::cout << ". done.\n";
+	std::cout << " " << exported << " exported, " << unchanged << " unchanged. done.\n";
 
 	logFileDDSConv.close();
 }
@@ -6466,6 +6646,8 @@ void CSMDoc::FinalizeExportTES4Stage::perform (int stage, Messages& messages)
 
 	MakeBatchNIFFiles(esm);
 	ExportDDSFiles(esm);
+	esm.mExportManifest.save();
+	esm.saveExportCache();
 
 	std::cout << std::endl << "Now writing out CSV log files..";
 
@@ -6798,3 +6980,13 @@ void CSMDoc::StartModRecord(const std::string& sSIG,  const std::string& mId, ES
 		flags |= 0x800; // DISABLED
 	esm.startRecordTES4(sSIG, flags, formID, strEDID);
 }
+
+bool CSMDoc::WriteCachedModRecord(const std::string& sSIG, const std::string& mId, ESM::ESMWriter& esm, Misc::ExportRecordCache::Hash sourceHash)
+{
+	std::string strEDID = esm.generateEDIDTES4(mId, 0, sSIG);
+	if (esm.writeCachedRecordTES4(sSIG, strEDID, sourceHash))
+		return true;
+
+	esm.captureNextRecordTES4(sourceHash);
+	return false;
+}
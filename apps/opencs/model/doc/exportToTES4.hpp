@@ -1,6 +1,8 @@
 #ifndef CSM_DOC_EXPORT_TO_TES4_H
 #define CSM_DOC_EXPORT_TO_TES4_H
 
+#include <set>
+
 #include "../world/record.hpp"
 #include "../world/idcollection.hpp"
 #include "../world/scope.hpp"
@@ -37,6 +39,9 @@ namespace CSMDoc
 {
 	uint32_t FindSiblingDoor(Document& mDocument, SavingState& mState, CSMWorld::CellRef& refRecord, uint32_t refFormID, ESM::Position& returnPosition);
 	void StartModRecord(const std::string& sSIG, const std::string& mId, ESM::ESMWriter& esm, const CSMWorld::RecordBase::State& state);
+	/// Write the record from the export cache if its source is unchanged, otherwise make the writer cache it.
+	/// \return false if the record must be written as usual, starting with StartModRecord.
+	bool WriteCachedModRecord(const std::string& sSIG, const std::string& mId, ESM::ESMWriter& esm, Misc::ExportRecordCache::Hash sourceHash);
 
     class Document;
     class SavingState;
@@ -765,22 +770,47 @@ namespace CSMDoc
 		bool mIsWrldHeaderWritten=false;
 		std::vector<uint32_t> mSubCellQuadTexList;
 		std::map<uint16_t, float> mTexLayerOpacityMap;
-		uint32_t mPreBlendMap[6][6]; // ESM3-based, single-layer 4x4 grid +1 surrounding texture
-		std::vector<uint32_t> mPreBlendTextureList;
 
-		bool getLandDataFromXY(int origX, int origY, int& plugindex, const ESM::Land::LandData*& landData);
-		void drawPreBlendMapXY(const ESM::Land::LandData *landData, int plugindex, int subCX, int subCY, int quadX, int quadY, int inputX, int inputY, int outputX, int outputY);
-		void drawLeftBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawRightBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawTopBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawBottomBorder(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawTopLeftCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawTopRightCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawBottomLeftCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
-		void drawBottomRightCorner(int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const ESM::Land::LandData*& landData);
+	public:
+		/// Copy of the VTEX data of a land record, so that the landscape textures can be converted
+		/// on worker threads without touching the document
+		struct LandTextures
+		{
+			int mPlugin;
+			uint16_t mTextures[ESM::Land::LAND_NUM_TEXTURES];
+		};
+
+		/// BTXT/ATXT/VTXT data of one quadrant of a subcell
+		struct QuadrantTextures
+		{
+			std::vector<uint32_t> mTextures; // the first one is the base texture, the others are layers
+			std::vector<std::vector<std::pair<uint16_t, float> > > mLayerOpacity; // (position in 17x17 grid, opacity) per layer
+		};
+
+		typedef uint32_t PreBlendMap[6][6]; // ESM3-based, single-layer 4x4 grid +1 surrounding texture
+
+	private:
+		std::map<std::pair<int, int>, LandTextures> mLandTextures;
+		bool mLandTexturesLoaded;
+		/// Converted textures of the lands that are about to be exported, 16 quadrants per land
+		std::map<std::pair<int, int>, std::vector<QuadrantTextures> > mQuadrantTextures;
+		std::set<std::pair<int, int> > mPreparedBlocks;
 
-		void exportLTEX_basetexture(ESM::ESMWriter& writer, int quadVal);
-		void exportLTEX_interpolatelayers(ESM::ESMWriter& writer, int quadVal);
+		void loadLandTextures();
+		void prepareQuadrantTextures(int landX, int landY);
+
+		bool getLandDataFromXY(int origX, int origY, int& plugindex, const LandTextures*& landData) const;
+		void drawPreBlendMapXY(PreBlendMap& preBlendMap, const LandTextures *landData, int plugindex, int subCX, int subCY, int quadX, int quadY, int inputX, int inputY, int outputX, int outputY) const;
+		void drawLeftBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawRightBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawTopBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawBottomBorder(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawTopLeftCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawTopRightCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawBottomLeftCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+		void drawBottomRightCorner(PreBlendMap& preBlendMap, int origX, int origY, int subCX, int subCY, int quadX, int quadY, int plugindex, const LandTextures*& landData) const;
+
+		void writeQuadrantTextures(ESM::ESMWriter& writer, const QuadrantTextures& textures, int quadVal);
 
 	public:
 
@@ -792,8 +822,12 @@ namespace CSMDoc
 		virtual void perform (int stage, Messages& messages);
 		///< Messages resulting from this stage will be appended to \a messages.
 
-		void createPreBlendMap(ESM::ESMWriter& writer, int baseX, int baseY, int subCX, int subCY, int quadX, int quadY);
-		void gatherPreBlendTextureList();
+		void createPreBlendMap(PreBlendMap& preBlendMap, int baseX, int baseY, int subCX, int subCY, int quadX, int quadY) const;
+		void gatherPreBlendTextureList(const PreBlendMap& preBlendMap, std::vector<uint32_t>& textureList) const;
+
+		/// Convert the textures of one land record. Only reads the land texture copies and the LTEX lookup
+		/// of the saving state, so it can be called on several threads at once.
+		void calculateQuadrantTextures(int landX, int landY, std::vector<QuadrantTextures>& quadrants) const;
 
 		void gatherSubCellQuadrantLTEX(int SubCell, int subX, int subY, int quadrant, const ESM::Land::LandData *landData, int plugindex);
 		void calculateTexLayerOpacityMap(int SubCell, int subX, int subY, int quadrant, const ESM::Land::LandData *landData, int plugindex, int layerID);
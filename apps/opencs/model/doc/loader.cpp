@@ -2,11 +2,20 @@
 
 #include <iostream>
 
+#include <QElapsedTimer>
+
 #include "../tools/reportmodel.hpp"
 
 #include "document.hpp"
 #include "state.hpp"
 
+namespace
+{
+    // Load records for this long before reporting progress and letting the event loop handle
+    // requests like aborting the load.
+    const int sBatchTime = 50; // in ms
+}
+
 CSMDoc::Loader::Stage::Stage() : mFile (0), mRecordsLoaded (0), mRecordsLeft (false) {}
 
 
@@ -60,15 +69,22 @@ void CSMDoc::Loader::load()
         if (iter->second.mRecordsLeft)
         {
             Messages messages (Message::Severity_Error);
-            const int batchingSize = 50;
-            for (int i=0; i<batchingSize; ++i) // do not flood the system with update signals
+
+            // do not flood the system with update signals
+            QElapsedTimer timer;
+            timer.start();
+
+            do
+            {
                 if (document->getData().continueLoading (messages))
                 {
                     iter->second.mRecordsLeft = false;
                     break;
                 }
-                else
-                    ++(iter->second.mRecordsLoaded);
+
+                ++(iter->second.mRecordsLoaded);
+            }
+            while (!timer.hasExpired (sBatchTime));
 
             CSMWorld::UniversalId log (CSMWorld::UniversalId::Type_LoadErrorLog, 0);
 
@@ -67,9 +67,8 @@ namespace CSMDoc
                 int totalRecords);
 
             void nextRecord (CSMDoc::Document *document, int records);
-            ///< \note This signal is only given once per group of records. The group size is
-            /// approximately the total number of records divided by the steps value of the
-            /// previous nextStage signal.
+            ///< \note This signal is only given once per group of records, which are loaded
+            /// in a fixed time slice.
 
             void loadMessage (CSMDoc::Document *document, const std::string& message);
             ///< Non-critical load error or warning
@@ -1,8 +1,11 @@
 #include "operation.hpp"
 
+#include <algorithm>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include <QRunnable>
 #include <QTimer>
 
 #include "../world/universalid.hpp"
@@ -10,6 +13,59 @@
 #include "state.hpp"
 #include "stage.hpp"
 
+namespace
+{
+    // Steps are handed to the pool in jobs of this size, and each call of executeStage gives
+    // every thread several jobs, so that slow steps do not leave the other threads idle.
+    const int sStepsPerJob = 16;
+    const int sJobsPerThread = 4;
+
+    class StepsJob : public QRunnable
+    {
+            std::vector<std::pair<CSMDoc::Stage *, int> > mSteps;
+            CSMDoc::Messages mMessages;
+            std::string mError;
+
+        public:
+
+            StepsJob()
+            // severity is resolved when the messages are added to the operation's list
+            : mMessages (CSMDoc::Message::Severity_Default)
+            {
+                setAutoDelete (false);
+            }
+
+            void addStep (CSMDoc::Stage *stage, int step)
+            {
+                mSteps.push_back (std::make_pair (stage, step));
+            }
+
+            virtual void run()
+            {
+                try
+                {
+                    for (std::vector<std::pair<CSMDoc::Stage *, int> >::const_iterator iter (mSteps.begin());
+                        iter!=mSteps.end(); ++iter)
+                        iter->first->perform (iter->second, mMessages);
+                }
+                catch (const std::exception& e)
+                {
+                    mError = e.what();
+                }
+            }
+
+            const CSMDoc::Messages& getMessages() const
+            {
+                return mMessages;
+            }
+
+            const std::string& getError() const
+            {
+                return mError;
+            }
+    };
+}
+
 void CSMDoc::Operation::prepareStages()
 {
     mCurrentStage = mStages.begin();
@@ -29,9 +85,10 @@ CSMDoc::Operation::Operation (int type, bool ordered, bool finalAlways)
 : mType (type), mStages(std::vector<std::pair<Stage *, int> >()), mCurrentStage(mStages.begin()),
   mCurrentStep(0), mCurrentStepTotal(0), mTotalSteps(0), mOrdered (ordered),
   mFinalAlways (finalAlways), mError(false), mConnected (false), mPrepared (false),
-  mDefaultSeverity (Message::Severity_Error)
+  mDefaultSeverity (Message::Severity_Error), mParallel (false)
 {
     mTimer = new QTimer (this);
+    mThreadPool = new QThreadPool (this);
 }
 
 CSMDoc::Operation::~Operation()
@@ -65,6 +122,11 @@ void CSMDoc::Operation::setDefaultSeverity (Message::Severity severity)
     mDefaultSeverity = severity;
 }
 
+void CSMDoc::Operation::setParallel (bool parallel)
+{
+    mParallel = parallel;
+}
+
 bool CSMDoc::Operation::hasError() const
 {
     return mError;
@@ -101,6 +163,9 @@ void CSMDoc::Operation::executeStage()
 
     while (mCurrentStage!=mStages.end())
     {
+        if (mParallel && executeParallel (messages))
+            break;
+
         if (mCurrentStep>=mCurrentStage->second)
         {
             mCurrentStep = 0;
@@ -132,6 +197,69 @@ void CSMDoc::Operation::executeStage()
         operationDone();
 }
 
+bool CSMDoc::Operation::executeParallel (Messages& messages)
+{
+    std::vector<std::unique_ptr<StepsJob> > jobs;
+
+    int maxSteps = mThreadPool->maxThreadCount() * sJobsPerThread * sStepsPerJob;
+    int steps = 0;
+
+    while (mCurrentStage!=mStages.end() && steps<maxSteps)
+    {
+        if (mCurrentStep>=mCurrentStage->second)
+        {
+            // the stages of an ordered operation may depend on the results of the previous ones
+            if (steps>0 && mOrdered)
+                break;
+
+            mCurrentStep = 0;
+            ++mCurrentStage;
+            continue;
+        }
+
+        if (!mCurrentStage->first->isThreadSafe())
+            break;
+
+        if (steps % sStepsPerJob==0)
+            jobs.push_back (std::unique_ptr<StepsJob> (new StepsJob));
+
+        jobs.back()->addStep (mCurrentStage->first, mCurrentStep++);
+        ++steps;
+    }
+
+    if (jobs.empty())
+        return false;
+
+    for (std::vector<std::unique_ptr<StepsJob> >::const_iterator iter (jobs.begin()); iter!=jobs.end(); ++iter)
+        mThreadPool->start (iter->get());
+
+    mThreadPool->waitForDone();
+
+    // merge in the order of the steps, so that the report does not depend on the scheduling
+    bool failed = false;
+
+    for (std::vector<std::unique_ptr<StepsJob> >::const_iterator iter (jobs.begin()); iter!=jobs.end(); ++iter)
+    {
+        const Messages& jobMessages = (*iter)->getMessages();
+
+        for (Messages::Iterator iter2 (jobMessages.begin()); iter2!=jobMessages.end(); ++iter2)
+            messages.add (iter2->mId, iter2->mMessage, iter2->mHint, iter2->mSeverity);
+
+        if (!(*iter)->getError().empty())
+        {
+            messages.add (CSMWorld::UniversalId(), (*iter)->getError(), "", Message::Severity_SeriousError);
+            failed = true;
+        }
+    }
+
+    mCurrentStepTotal += steps;
+
+    if (failed)
+        abort();
+
+    return true;
+}
+
 void CSMDoc::Operation::operationDone()
 {
     mTimer->stop();
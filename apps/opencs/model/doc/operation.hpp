@@ -7,6 +7,7 @@
 #include <QObject>
 #include <QTimer>
 #include <QStringList>
+#include <QThreadPool>
 
 #include "messages.hpp"
 
@@ -36,9 +37,16 @@ namespace CSMDoc
             QTimer *mTimer;
             bool mPrepared;
             Message::Severity mDefaultSeverity;
+            bool mParallel;
+            QThreadPool *mThreadPool;
 
             void prepareStages();
 
+            bool executeParallel (Messages& messages);
+            ///< Perform the thread-safe steps starting at the current step on the thread pool.
+            ///
+            /// \return Were any steps performed?
+
         public:
 
             Operation (int type, bool ordered, bool finalAlways = false);
@@ -55,6 +63,13 @@ namespace CSMDoc
             /// \attention Do no call this function while this Operation is running.
             void setDefaultSeverity (Message::Severity severity);
 
+            /// Perform the steps of thread-safe stages concurrently. If the operation is not
+            /// ordered, the steps of consecutive thread-safe stages are mixed too. Messages are
+            /// reported in the same order as in a sequential run.
+            ///
+            /// \attention Do no call this function while this Operation is running.
+            void setParallel (bool parallel);
+
             bool hasError() const;
 
         signals:
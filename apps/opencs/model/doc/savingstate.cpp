@@ -10,6 +10,8 @@ void inline OutputDebugString(const char *c_string) { std::cout << c_string; };
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 
+#include <components/misc/exportmanifest.hpp>
+
 #include "operation.hpp"
 #include "document.hpp"
 
@@ -1224,5 +1226,11 @@ int CSMDoc::SavingState::initializeSubstitutions(std::string esmName)
 	logFileDDSLog2.close();
 	std::cout << "DEBUG: " << logFileStem2 << ".csv is reset.\n";
 
+	// asset export manifest lives next to the exported Data folder
+	std::string outputRoot = Misc::getExportOutputRoot();
+	mWriter.mExportManifest.load(outputRoot + "/Oblivion.output/");
+	// FormIDs and records of the previous export of this plugin
+	mWriter.mExportCache.load(outputRoot + "/Oblivion.output/modexporter_" + esmName + ".cache");
+
 	return 0;
 }
@@ -23,6 +23,12 @@ namespace CSMDoc
 
             virtual void perform (int stage, Messages& messages) = 0;
             ///< Messages resulting from this stage will be appended to \a messages.
+
+            virtual bool isThreadSafe() const;
+            ///< May steps of this stage be performed concurrently with each other and with other
+            /// stages? This requires that perform only reads the document and does not modify *this.
+            ///
+            /// Default: false
     };
 }
 
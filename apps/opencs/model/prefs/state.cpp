@@ -123,6 +123,9 @@ void CSMPrefs::State::declare()
     declareEnum ("double-s", "Shift Double Click", actionRemove).addValues (reportValues);
     declareEnum ("double-c", "Control Double Click", actionEditAndRemove).addValues (reportValues);
     declareEnum ("double-sc", "Shift Control Double Click", actionNone).addValues (reportValues);
+    declareBool ("parallel-verify", "Run verifier checks on all CPU cores", true).
+        setTooltip ("Checks that only read the document are run on several threads at once. "
+        "The order of the reports is the same either way.");
 
     declareCategory ("Search & Replace");
     declareInt ("char-before", "Characters before search string", 10).
@@ -65,3 +65,8 @@ void CSMTools::ClassCheckStage::perform (int stage, CSMDoc::Messages& messages)
                 ESM::Skill::indexToId (iter->first) + " is listed more than once"));
         }
 }
+
+bool CSMTools::ClassCheckStage::isThreadSafe() const
+{
+    return true;
+}
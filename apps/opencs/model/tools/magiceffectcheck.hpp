@@ -44,6 +44,8 @@ namespace CSMTools
             ///< \return number of steps
             virtual void perform (int stage, CSMDoc::Messages &messages);
             ///< Messages resulting from this tage will be appended to \a messages.
+
+            virtual bool isThreadSafe() const;
     };
 }
 
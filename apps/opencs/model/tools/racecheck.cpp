@@ -38,10 +38,6 @@ void CSMTools::RaceCheckStage::performPerRecord (int stage, CSMDoc::Messages& me
     if (race.mData.mWeight.mFemale<0)
         messages.push_back (std::make_pair (id, "female " + race.mId + " has negative weight"));
 
-    // remember playable flag
-    if (race.mData.mFlags & 0x1)
-        mPlayable = true;
-
     /// \todo check data members that can't be edited in the table view
 }
 
@@ -49,17 +45,25 @@ void CSMTools::RaceCheckStage::performFinal (CSMDoc::Messages& messages)
 {
     CSMWorld::UniversalId id (CSMWorld::UniversalId::Type_Races);
 
-    if (!mPlayable)
-        messages.push_back (std::make_pair (id, "No playable race"));
+    // look for the playable flag here instead of remembering it in performPerRecord, so that the
+    // steps do not depend on each other
+    for (int i=0; i<mRaces.getSize(); ++i)
+    {
+        const CSMWorld::Record<ESM::Race>& record = mRaces.getRecord (i);
+
+        if (!record.isDeleted() && (record.get().mData.mFlags & 0x1))
+            return;
+    }
+
+    messages.push_back (std::make_pair (id, "No playable race"));
 }
 
 CSMTools::RaceCheckStage::RaceCheckStage (const CSMWorld::IdCollection<ESM::Race>& races)
-: mRaces (races), mPlayable (false)
+: mRaces (races)
 {}
 
 int CSMTools::RaceCheckStage::setup()
 {
-    mPlayable = false;
     return mRaces.getSize()+1;
 }
 
@@ -70,3 +74,8 @@ void CSMTools::RaceCheckStage::perform (int stage, CSMDoc::Messages& messages)
     else
         performPerRecord (stage, messages);
 }
+
+bool CSMTools::RaceCheckStage::isThreadSafe() const
+{
+    return true;
+}
@@ -15,8 +15,7 @@ CSMTools::ReferenceableCheckStage::ReferenceableCheckStage(
     mRaces(races),
     mClasses(classes),
     mFactions(faction),
-    mScripts(scripts),
-    mPlayerPresent(false)
+    mScripts(scripts)
 {
 }
 
@@ -227,7 +226,6 @@ void CSMTools::ReferenceableCheckStage::perform (int stage, CSMDoc::Messages& me
 
 int CSMTools::ReferenceableCheckStage::setup()
 {
-    mPlayerPresent = false;
     return mReferencables.getSize() + 1;
 }
 
@@ -651,10 +649,6 @@ void CSMTools::ReferenceableCheckStage::npcCheck (
     //Don't know what unknown is for
     int gold(npc.mNpdt52.mGold);
 
-    //Detect if player is present
-    if (Misc::StringUtils::ciEqual(npc.mId, "player")) //Happy now, scrawl?
-        mPlayerPresent = true;
-
     if (npc.mNpdtType == ESM::NPC::NPC_WITH_AUTOCALCULATED_STATS) //12 = autocalculated
     {
         if ((npc.mFlags & ESM::NPC::Autocalc) == 0) //0x0010 = autocalculated flag
@@ -895,7 +889,11 @@ void CSMTools::ReferenceableCheckStage::staticCheck (
 
 void CSMTools::ReferenceableCheckStage::finalCheck (CSMDoc::Messages& messages)
 {
-    if (!mPlayerPresent)
+    // searched for here, so that the steps do not depend on each other
+    CSMWorld::RefIdData::LocalIndex index = mReferencables.searchId ("player");
+
+    if (index.first==-1 || index.second!=CSMWorld::UniversalId::Type_Npc ||
+        mReferencables.getRecord (index).isDeleted())
         messages.push_back (std::make_pair (CSMWorld::UniversalId::Type_Referenceables,
             "There is no player record"));
 }
@@ -1033,3 +1031,8 @@ template<typename Tool> void CSMTools::ReferenceableCheckStage::scriptCheck (
             messages.push_back (std::make_pair (someID, someTool.mId + " refers to an unknown script \""+someTool.mScript+"\""));
     }
 }
+
+bool CSMTools::ReferenceableCheckStage::isThreadSafe() const
+{
+    return true;
+}
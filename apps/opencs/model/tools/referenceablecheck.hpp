@@ -20,6 +20,7 @@ namespace CSMTools
 
             virtual void perform(int stage, CSMDoc::Messages& messages);
             virtual int setup();
+            virtual bool isThreadSafe() const;
 
         private:
             //CONCRETE CHECKS
@@ -81,7 +82,6 @@ namespace CSMTools
             const CSMWorld::IdCollection<ESM::Class>& mClasses;
             const CSMWorld::IdCollection<ESM::Faction>& mFactions;
             const CSMWorld::IdCollection<ESM::Script>& mScripts;
-            bool mPlayerPresent;
     };
 }
 #endif // REFERENCEABLECHECKSTAGE_H
@@ -102,3 +102,8 @@ int CSMTools::ReferenceCheckStage::setup()
 {
     return mReferences.getSize();
 }
+
+bool CSMTools::ReferenceCheckStage::isThreadSafe() const
+{
+    return true;
+}
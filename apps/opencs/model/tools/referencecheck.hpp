@@ -16,6 +16,7 @@ namespace CSMTools
 
             virtual void perform(int stage, CSMDoc::Messages& messages);
             virtual int setup();
+            virtual bool isThreadSafe() const;
 
         private:
             const CSMWorld::RefCollection& mReferences;
@@ -6,83 +6,86 @@
 #include "../doc/messages.hpp"
 #include "../doc/document.hpp"
 
-#include "../world/idtablebase.hpp"
+#include "../world/idtable.hpp"
+#include "../world/collectionbase.hpp"
 #include "../world/columnbase.hpp"
 #include "../world/universalid.hpp"
 #include "../world/commands.hpp"
 
-void CSMTools::Search::searchTextCell (const CSMWorld::IdTableBase *model,
-    const QModelIndex& index, const CSMWorld::UniversalId& id, bool writable,
-    CSMDoc::Messages& messages) const
+QVariant CSMTools::Search::getData (const CSMWorld::IdTableBase *model, int row, int column) const
+{
+    // skip the model, which only forwards display data to the collection anyway
+    if (mCollection)
+        return mCollection->getData (row, column);
+
+    return model->data (model->index (row, column));
+}
+
+void CSMTools::Search::searchTextCell (const QString& text, const SearchColumn& column,
+    const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const
 {
     // using QString here for easier handling of case folding.
-    
-    QString search = QString::fromUtf8 (mText.c_str());
-    QString text = model->data (index).toString();
+
+    int length = mMatcher.pattern().length();
 
     int pos = 0;
 
-    while ((pos = text.indexOf (search, pos, Qt::CaseInsensitive))!=-1)
+    while ((pos = mMatcher.indexIn (text, pos))!=-1)
     {
         std::ostringstream hint;
         hint
-            << (writable ? 'R' : 'r')
+            << (column.mWritable ? 'R' : 'r')
             <<": "
-            << model->getColumnId (index.column())
+            << column.mColumnId
             << " " << pos
-            << " " << search.length();
-        
-        messages.add (id, formatDescription (text, pos, search.length()).toUtf8().data(), hint.str());
+            << " " << length;
+
+        messages.add (id, formatDescription (text, pos, length).toUtf8().data(), hint.str());
 
-        pos += search.length();
+        pos += length;
     }
 }
 
-void CSMTools::Search::searchRegExCell (const CSMWorld::IdTableBase *model,
-    const QModelIndex& index, const CSMWorld::UniversalId& id, bool writable,
-    CSMDoc::Messages& messages) const
+void CSMTools::Search::searchRegExCell (const QString& text, const SearchColumn& column,
+    const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const
 {
-    QString text = model->data (index).toString();
-
     int pos = 0;
 
     while ((pos = mRegExp.indexIn (text, pos))!=-1)
     {
         int length = mRegExp.matchedLength();
-        
+
         std::ostringstream hint;
         hint
-            << (writable ? 'R' : 'r')
+            << (column.mWritable ? 'R' : 'r')
             <<": "
-            << model->getColumnId (index.column())
+            << column.mColumnId
             << " " << pos
             << " " << length;
-        
+
         messages.add (id, formatDescription (text, pos, length).toUtf8().data(), hint.str());
 
         pos += length;
     }
 }
 
-void CSMTools::Search::searchRecordStateCell (const CSMWorld::IdTableBase *model,
-    const QModelIndex& index, const CSMWorld::UniversalId& id, bool writable, CSMDoc::Messages& messages) const
+void CSMTools::Search::searchRecordStateCell (int data, const SearchColumn& column,
+    const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const
 {
-    if (writable)
+    if (column.mWritable)
         throw std::logic_error ("Record state can not be modified by search and replace");
-        
-    int data = model->data (index).toInt();
 
     if (data==mValue)
     {
         std::vector<std::string> states =
             CSMWorld::Columns::getEnums (CSMWorld::Columns::ColumnId_Modification);
-    
+
         std::ostringstream message;
         message << states.at (data);
 
         std::ostringstream hint;
-        hint << "r: " << model->getColumnId (index.column());
-        
+        hint << "r: " << column.mColumnId;
+
         messages.add (id, message.str(), hint.str());
     }
 }
@@ -121,24 +124,27 @@ QString CSMTools::Search::flatten (const QString& text) const
 }
 
 CSMTools::Search::Search() : mType (Type_None), mValue (0), mIdColumn (0), mTypeColumn (0),
-    mPaddingBefore (10), mPaddingAfter (10) {}
+    mPaddingBefore (10), mPaddingAfter (10), mCollection (0) {}
 
 CSMTools::Search::Search (Type type, const std::string& value)
-: mType (type), mText (value), mValue (0), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10)
+: mType (type), mText (value), mMatcher (QString::fromUtf8 (value.c_str()), Qt::CaseInsensitive),
+  mValue (0), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10), mCollection (0)
 {
     if (type!=Type_Text && type!=Type_Id)
         throw std::logic_error ("Invalid search parameter (string)");
 }
 
 CSMTools::Search::Search (Type type, const QRegExp& value)
-: mType (type), mRegExp (value), mValue (0), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10)
+: mType (type), mRegExp (value), mValue (0), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10),
+  mCollection (0)
 {
     if (type!=Type_TextRegEx && type!=Type_IdRegEx)
         throw std::logic_error ("Invalid search parameter (RegExp)");
 }
 
 CSMTools::Search::Search (Type type, int value)
-: mType (type), mValue (value), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10)
+: mType (type), mValue (value), mIdColumn (0), mTypeColumn (0), mPaddingBefore (10), mPaddingAfter (10),
+  mCollection (0)
 {
     if (type!=Type_RecordState)
         throw std::logic_error ("invalid search parameter (int)");
@@ -148,6 +154,9 @@ void CSMTools::Search::configure (const CSMWorld::IdTableBase *model)
 {
     mColumns.clear();
 
+    const CSMWorld::IdTable *table = dynamic_cast<const CSMWorld::IdTable *> (model);
+    mCollection = table ? table->getCollection() : 0;
+
     int columns = model->columnCount();
 
     for (int i=0; i<columns; ++i)
@@ -195,7 +204,20 @@ void CSMTools::Search::configure (const CSMWorld::IdTableBase *model)
         }
 
         if (consider)
-            mColumns.insert (i);
+        {
+            SearchColumn column;
+            column.mIndex = i;
+            column.mColumnId = model->getColumnId (i);
+
+            // editability depends on the column only
+            if (mCollection)
+                column.mWritable = mCollection->getColumn (i).isUserEditable();
+            else
+                column.mWritable = model->rowCount()>0 &&
+                    (model->flags (model->index (0, i)) & Qt::ItemIsEditable);
+
+            mColumns.push_back (column);
+        }
     }
 
     mIdColumn = model->findColumnIndex (CSMWorld::Columns::ColumnId_Id);
@@ -205,40 +227,51 @@ void CSMTools::Search::configure (const CSMWorld::IdTableBase *model)
 void CSMTools::Search::searchRow (const CSMWorld::IdTableBase *model, int row,
     CSMDoc::Messages& messages) const
 {
-    for (std::set<int>::const_iterator iter (mColumns.begin()); iter!=mColumns.end(); ++iter)
-    {
-        QModelIndex index = model->index (row, *iter);
+    searchRows (model, row, row+1, messages);
+}
 
+void CSMTools::Search::searchRows (const CSMWorld::IdTableBase *model, int begin, int end,
+    CSMDoc::Messages& messages) const
+{
+    if (mColumns.empty())
+        return;
+
+    for (int row=begin; row<end; ++row)
+    {
         CSMWorld::UniversalId::Type type = static_cast<CSMWorld::UniversalId::Type> (
-            model->data (model->index (row, mTypeColumn)).toInt());
-        
+            getData (model, row, mTypeColumn).toInt());
+
         CSMWorld::UniversalId id (
-            type, model->data (model->index (row, mIdColumn)).toString().toUtf8().data());
+            type, getData (model, row, mIdColumn).toString().toUtf8().data());
 
-        bool writable = model->flags (index) & Qt::ItemIsEditable;
-            
-        switch (mType)
+        for (std::vector<SearchColumn>::const_iterator iter (mColumns.begin());
+            iter!=mColumns.end(); ++iter)
         {
-            case Type_Text:
-            case Type_Id:
+            QVariant data = getData (model, row, iter->mIndex);
 
-                searchTextCell (model, index, id, writable, messages);
-                break;
-            
-            case Type_TextRegEx:
-            case Type_IdRegEx:
+            switch (mType)
+            {
+                case Type_Text:
+                case Type_Id:
 
-                searchRegExCell (model, index, id, writable, messages);
-                break;
-            
-            case Type_RecordState:
+                    searchTextCell (data.toString(), *iter, id, messages);
+                    break;
 
-                searchRecordStateCell (model, index, id, writable, messages);
-                break;
+                case Type_TextRegEx:
+                case Type_IdRegEx:
 
-            case Type_None:
+                    searchRegExCell (data.toString(), *iter, id, messages);
+                    break;
 
-                break;
+                case Type_RecordState:
+
+                    searchRecordStateCell (data.toInt(), *iter, id, messages);
+                    break;
+
+                case Type_None:
+
+                    break;
+            }
         }
     }
 }
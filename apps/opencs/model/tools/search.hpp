@@ -3,11 +3,13 @@
 
 #include <string>
 #include <set>
+#include <vector>
 
 #include <QRegExp>
+#include <QStringMatcher>
 #include <QMetaType>
 
-class QModelIndex;
+class QVariant;
 
 namespace CSMDoc
 {
@@ -18,6 +20,7 @@ namespace CSMDoc
 namespace CSMWorld
 {
     class IdTableBase;
+    class CollectionBase;
     class UniversalId;
 }
 
@@ -39,25 +42,37 @@ namespace CSMTools
 
         private:
 
+            struct SearchColumn
+            {
+                int mIndex;
+                int mColumnId;
+                bool mWritable;
+            };
+
             Type mType;
             std::string mText;
+            QStringMatcher mMatcher;
             QRegExp mRegExp;
             int mValue;
-            std::set<int> mColumns;
+            std::vector<SearchColumn> mColumns;
             int mIdColumn;
             int mTypeColumn;
             int mPaddingBefore;
             int mPaddingAfter;
 
-            void searchTextCell (const CSMWorld::IdTableBase *model, const QModelIndex& index,
-                const CSMWorld::UniversalId& id, bool writable, CSMDoc::Messages& messages) const;
+            // records of the configured model, if it gives access to them
+            const CSMWorld::CollectionBase *mCollection;
 
-            void searchRegExCell (const CSMWorld::IdTableBase *model, const QModelIndex& index,
-                const CSMWorld::UniversalId& id, bool writable, CSMDoc::Messages& messages) const;
+            QVariant getData (const CSMWorld::IdTableBase *model, int row, int column) const;
 
-            void searchRecordStateCell (const CSMWorld::IdTableBase *model,
-                const QModelIndex& index, const CSMWorld::UniversalId& id, bool writable,
-                CSMDoc::Messages& messages) const;
+            void searchTextCell (const QString& text, const SearchColumn& column,
+                const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const;
+
+            void searchRegExCell (const QString& text, const SearchColumn& column,
+                const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const;
+
+            void searchRecordStateCell (int data, const SearchColumn& column,
+                const CSMWorld::UniversalId& id, CSMDoc::Messages& messages) const;
 
             QString formatDescription (const QString& description, int pos, int length) const;
 
@@ -82,6 +97,18 @@ namespace CSMTools
             void searchRow (const CSMWorld::IdTableBase *model, int row,
                 CSMDoc::Messages& messages) const;
 
+            // Search rows [begin, end) in \a model and store results in \a messages.
+            //
+            // If \a model is an IdTable, the records are read from its collection directly
+            // instead of through the model interface.
+            //
+            // \attention *this needs to be configured for \a model.
+            //
+            // \attention Regular expression searches are not thread-safe. Use a copy of *this
+            // for each thread.
+            void searchRows (const CSMWorld::IdTableBase *model, int begin, int end,
+                CSMDoc::Messages& messages) const;
+
             void setPadding (int before, int after);
 
             // Configuring *this for the model is not necessary when calling this function.
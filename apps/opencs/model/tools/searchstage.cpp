@@ -1,11 +1,59 @@
 #include "searchstage.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include <QRunnable>
+
 #include "../world/idtablebase.hpp"
 
 #include "searchoperation.hpp"
 
+namespace
+{
+    // Rows per step. Results and progress are reported after each step, so this must stay small
+    // enough for the report to fill up while the search is still running.
+    const int sRowsPerStep = 1024;
+
+    // Below this, splitting a range between threads costs more than it saves.
+    const int sMinRowsPerJob = 64;
+
+    class SearchJob : public QRunnable
+    {
+            // each job has its own copy, because regular expression matching is not thread-safe
+            CSMTools::Search mSearch;
+            const CSMWorld::IdTableBase *mModel;
+            int mBegin;
+            int mEnd;
+            CSMDoc::Messages& mMessages;
+            std::string& mError;
+
+        public:
+
+            SearchJob (const CSMTools::Search& search, const CSMWorld::IdTableBase *model,
+                int begin, int end, CSMDoc::Messages& messages, std::string& error)
+            : mSearch (search), mModel (model), mBegin (begin), mEnd (end), mMessages (messages),
+              mError (error)
+            {}
+
+            virtual void run()
+            {
+                try
+                {
+                    mSearch.searchRows (mModel, mBegin, mEnd, mMessages);
+                }
+                catch (const std::exception& e)
+                {
+                    mError = e.what();
+                }
+            }
+    };
+}
+
 CSMTools::SearchStage::SearchStage (const CSMWorld::IdTableBase *model)
-: mModel (model), mOperation (0)
+: mModel (model), mOperation (0), mRows (0)
 {}
 
 int CSMTools::SearchStage::setup()
@@ -14,13 +62,53 @@ int CSMTools::SearchStage::setup()
         mSearch = mOperation->getSearch();
 
     mSearch.configure (mModel);
-        
-    return mModel->rowCount();
+
+    mRows = mModel->rowCount();
+
+    return (mRows+sRowsPerStep-1)/sRowsPerStep;
 }
 
 void CSMTools::SearchStage::perform (int stage, CSMDoc::Messages& messages)
 {
-    mSearch.searchRow (mModel, stage, messages);
+    int begin = stage*sRowsPerStep;
+    int end = std::min (begin+sRowsPerStep, mRows);
+
+    int jobs = std::max (1, std::min (mThreadPool.maxThreadCount(), (end-begin)/sMinRowsPerJob));
+
+    if (jobs==1)
+    {
+        mSearch.searchRows (mModel, begin, end, messages);
+        return;
+    }
+
+    // Messages resolves the default severity when adding, so leave that to the final list.
+    std::vector<std::unique_ptr<CSMDoc::Messages> > results;
+    std::vector<std::string> errors (jobs);
+
+    int rowsPerJob = (end-begin+jobs-1)/jobs;
+
+    for (int i=0; i<jobs; ++i)
+    {
+        results.push_back (std::unique_ptr<CSMDoc::Messages> (
+            new CSMDoc::Messages (CSMDoc::Message::Severity_Default)));
+
+        int jobBegin = std::min (begin+i*rowsPerJob, end);
+        int jobEnd = std::min (jobBegin+rowsPerJob, end);
+
+        mThreadPool.start (new SearchJob (mSearch, mModel, jobBegin, jobEnd, *results.back(),
+            errors[i]));
+    }
+
+    mThreadPool.waitForDone();
+
+    for (int i=0; i<jobs; ++i)
+    {
+        if (!errors[i].empty())
+            throw std::runtime_error (errors[i]);
+
+        for (CSMDoc::Messages::Iterator iter (results[i]->begin()); iter!=results[i]->end(); ++iter)
+            messages.add (iter->mId, iter->mMessage, iter->mHint, iter->mSeverity);
+    }
 }
 
 void CSMTools::SearchStage::setOperation (const SearchOperation *operation)
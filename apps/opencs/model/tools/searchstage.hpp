@@ -1,6 +1,8 @@
 #ifndef CSM_TOOLS_SEARCHSTAGE_H
 #define CSM_TOOLS_SEARCHSTAGE_H
 
+#include <QThreadPool>
+
 #include "../doc/stage.hpp"
 
 #include "search.hpp"
@@ -14,11 +16,17 @@ namespace CSMTools
 {
     class SearchOperation;
     
+    /// \brief Search all rows of a table
+    ///
+    /// Each step covers a range of rows, which is split up between the threads of a pool. The
+    /// results of a step are reported in row order once it is complete.
     class SearchStage : public CSMDoc::Stage
     {
             const CSMWorld::IdTableBase *mModel;
             Search mSearch;
             const SearchOperation *mOperation;
+            int mRows;
+            QThreadPool mThreadPool;
 
         public:
 
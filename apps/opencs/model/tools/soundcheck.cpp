@@ -31,3 +31,8 @@ void CSMTools::SoundCheckStage::perform (int stage, CSMDoc::Messages& messages)
 
     /// \todo check, if the sound file exists
 }
+
+bool CSMTools::SoundCheckStage::isThreadSafe() const
+{
+    return true;
+}
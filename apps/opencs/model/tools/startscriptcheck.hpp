@@ -22,6 +22,7 @@ namespace CSMTools
 
             virtual void perform(int stage, CSMDoc::Messages& messages);
             virtual int setup();
+            virtual bool isThreadSafe() const;
     };
 }
 
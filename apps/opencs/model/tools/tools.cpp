@@ -9,6 +9,8 @@
 #include "../world/data.hpp"
 #include "../world/universalid.hpp"
 
+#include "../prefs/state.hpp"
+
 #include "reportmodel.hpp"
 #include "mandatoryid.hpp"
 #include "skillcheck.hpp"
@@ -189,7 +191,9 @@ CSMWorld::UniversalId CSMTools::Tools::runVerifier (const CSMWorld::UniversalId&
 
     mActiveReports[CSMDoc::State_Verifying] = reportNumber;
 
-    getVerifier()->start();
+    CSMDoc::OperationHolder *verifier = getVerifier();
+    mVerifierOperation->setParallel (CSMPrefs::get()["Reports"]["parallel-verify"].isTrue());
+    verifier->start();
 
     return CSMWorld::UniversalId (CSMWorld::UniversalId::Type_VerificationResults, reportNumber);
 }
@@ -439,3 +439,8 @@ void CSMTools::TopicInfoCheckStage::writeInvalidTypeError(const std::string& spe
 
     messages.add(id, stream.str(), "", CSMDoc::Message::Severity_Error);
 }
+
+bool CSMTools::TopicInfoCheckStage::isThreadSafe() const
+{
+    return true;
+}
@@ -1,9 +1,9 @@
 #ifndef CSM_WOLRD_COLLECTION_H
 #define CSM_WOLRD_COLLECTION_H
 
-#include <list>
 #include <vector>
 #include <map>
+#include <memory>
 #include <algorithm>
 #include <cctype>
 #include <stdexcept>
@@ -51,15 +51,10 @@ namespace CSMWorld
 
         private:
 
-			typedef typename std::list<Record<ESXRecordT> >::iterator RecordIteratorT;
-			typedef std::pair<int, RecordIteratorT> CacheEntry;
-			typedef typename std::list<Record<ESXRecordT> >::const_iterator ConstRecordIteratorT;
-			typedef std::pair<int, ConstRecordIteratorT> CacheConstEntry;
-			mutable CacheEntry mLastAccessedRecord;
-			mutable CacheConstEntry mLastAccessedConstRecord;
-
-			std::list<Record<ESXRecordT> > mRecords;
-			std::map<std::string, int> mIndex;
+            // The records live on the heap and don't move, so that inserting a row only shifts pointers,
+            // while access by index stays constant time.
+            std::vector<std::unique_ptr<Record<ESXRecordT> > > mRecords;
+            std::map<std::string, int> mIndex;
             std::vector<Column<ESXRecordT> *> mColumns;
 
             // not implemented
@@ -70,7 +65,7 @@ namespace CSMWorld
 
             const std::map<std::string, int>& getIdMap() const;
 
-            const std::list<Record<ESXRecordT> >& getRecords() const;
+            const std::vector<std::unique_ptr<Record<ESXRecordT> > >& getRecords() const;
 
             bool reorderRowsImp (int baseIndex, const std::vector<int>& newOrder);
             ///< Reorder the rows [baseIndex, baseIndex+newOrder.size()) according to the indices
@@ -84,14 +79,11 @@ namespace CSMWorld
 
             virtual ~Collection();
 
-			// use the fastest traversal to reach the Nth Record
-			typename std::list<Record<ESXRecordT>>::iterator getNthRecordIterator(int index);
-			typename std::list<Record<ESXRecordT>>::const_iterator getNthRecordIterator(int index) const;
-			Record<ESXRecordT>& getNthRecord(int index);
-			const Record<ESXRecordT>& getNthRecord(int index) const;
-			void invalidateCache() const;
+            Record<ESXRecordT>& getNthRecord (int index);
+
+            const Record<ESXRecordT>& getNthRecord (int index) const;
 
-			void add (const ESXRecordT& record);
+            void add (const ESXRecordT& record);
             ///< Add a new record (modified)
 
             virtual int getSize() const;
@@ -174,156 +166,17 @@ namespace CSMWorld
             NestableColumn *getNestableColumn (int column) const;
     };
 
-	template<typename ESXRecordT, typename IdAccessorT>
-	void Collection<ESXRecordT, IdAccessorT>::invalidateCache() const
-	{
-		// invalidate cache if can't maintain coherence
-		mLastAccessedRecord.first = -1;
-		mLastAccessedConstRecord.first = -1;
-	}
-
-	// use the fastest traversal to reach the Nth Record
-	template<typename ESXRecordT, typename IdAccessorT>
-	typename std::list<Record<ESXRecordT>>::iterator Collection<ESXRecordT, IdAccessorT>::getNthRecordIterator(int index)
-	{
-		int i, distanceFromEnd, distanceFromCache;
-        typename std::list<Record<ESXRecordT>>::iterator iter;
-
-		if (index == 0)
-		{
-			if (mLastAccessedRecord.first == -1)
-			{
-				mLastAccessedRecord.first = 0;
-				mLastAccessedRecord.second = mRecords.begin();
-			}
-			return mRecords.begin();
-		}
-		else
-		{
-			if (mLastAccessedRecord.first == index)
-			{
-				iter = mLastAccessedRecord.second;
-				return iter;
-			}
-			else if (mLastAccessedRecord.first != -1)
-				distanceFromCache = index - mLastAccessedRecord.first;
-			else
-				distanceFromCache = index;
-		}
-
-		distanceFromEnd = mRecords.size() - index;
-
-		if ((abs(distanceFromCache) < index) && (abs(distanceFromCache) < distanceFromEnd))
-		{
-			if (distanceFromCache > 0)
-				// forward
-				for (iter = mLastAccessedRecord.second, i = 0; i < distanceFromCache; i++)
-					iter++;
-			else
-				// backward
-				for (iter = mLastAccessedRecord.second, i = 0; i > distanceFromCache; i--)
-					iter--;
-		}
-		else
-		{
-
-			if (distanceFromEnd < index) {
-				// traverse from end()
-				for (iter = mRecords.end(), i = mRecords.size(); i > index; i--)
-					iter--;
-			}
-			else
-			{
-				// traverse from begin()
-				for (iter = mRecords.begin(), i = 0; i < index; i++)
-					iter++;
-			}
-
-		}
-
-		mLastAccessedRecord.first = index;
-		mLastAccessedRecord.second = iter;
-
-		return iter;
-
-	}
-
-	// use the fastest traversal to reach the Nth Record
-	template<typename ESXRecordT, typename IdAccessorT>
-	typename std::list<Record<ESXRecordT>>::const_iterator Collection<ESXRecordT, IdAccessorT>::getNthRecordIterator(int index) const
-	{
-		int i, distanceFromEnd, distanceFromCache;
-		typename std::list<Record<ESXRecordT>>::const_iterator iter;
-
-		if (index == 0)
-		{
-			if (mLastAccessedConstRecord.first == -1)
-			{
-				mLastAccessedConstRecord.first = 0;
-				mLastAccessedConstRecord.second = mRecords.begin();
-			}
-			return mRecords.begin();
-		}
-		else
-		{
-			if (mLastAccessedConstRecord.first == index)
-				return mLastAccessedConstRecord.second;
-			else if (mLastAccessedConstRecord.first != -1)
-				distanceFromCache = index - mLastAccessedConstRecord.first;
-			else
-				distanceFromCache = index;
-		}
-
-		distanceFromEnd = mRecords.size() - index;
-
-		if ( (abs(distanceFromCache) < index) && (abs(distanceFromCache) < distanceFromEnd) )
-		{
-			if (distanceFromCache > 0)
-				// forward
-				for (iter = mLastAccessedConstRecord.second, i = 0; i < distanceFromCache; i++)
-					iter++;
-			else
-				// backward
-				for (iter = mLastAccessedConstRecord.second, i = 0; i > distanceFromCache; i--)
-					iter--;
-		}
-		else
-		{
-
-			if (distanceFromEnd < index) {
-				// traverse from end()
-				for (iter = mRecords.end(), i = mRecords.size(); i > index; i--)
-					iter--;
-			}
-			else
-			{
-				// traverse from begin()
-				for (iter = mRecords.begin(), i = 0; i < index; i++)
-					iter++;
-			}
-
-		}
-
-		mLastAccessedConstRecord.first = index;
-		mLastAccessedConstRecord.second = iter;
-
-		return iter;
-	}
-
-// use the fastest traversal to reach the Nth Record
-	template<typename ESXRecordT, typename IdAccessorT>
-	Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getNthRecord(int index)
-	{
-		return *getNthRecordIterator(index);
-	}
-
-	// use the fastest traversal to reach the Nth Record
-	template<typename ESXRecordT, typename IdAccessorT>
-	const Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getNthRecord(int index) const
-	{
-		return *getNthRecordIterator(index);
-	}
+    template<typename ESXRecordT, typename IdAccessorT>
+    Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getNthRecord (int index)
+    {
+        return *mRecords.at (index);
+    }
 
+    template<typename ESXRecordT, typename IdAccessorT>
+    const Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getNthRecord (int index) const
+    {
+        return *mRecords.at (index);
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     const std::map<std::string, int>& Collection<ESXRecordT, IdAccessorT>::getIdMap() const
@@ -332,7 +185,7 @@ namespace CSMWorld
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
-    const std::list<Record<ESXRecordT> >& Collection<ESXRecordT, IdAccessorT>::getRecords() const
+    const std::vector<std::unique_ptr<Record<ESXRecordT> > >& Collection<ESXRecordT, IdAccessorT>::getRecords() const
     {
         return mRecords;
     }
@@ -341,8 +194,6 @@ namespace CSMWorld
     bool Collection<ESXRecordT, IdAccessorT>::reorderRowsImp (int baseIndex,
         const std::vector<int>& newOrder)
     {
-		typename std::list<Record<ESXRecordT>>::iterator currentRecord, nextRecord, newPosition;
-
         if (!newOrder.empty())
         {
             int size = static_cast<int> (newOrder.size());
@@ -353,46 +204,21 @@ namespace CSMWorld
             if (*test.begin()!=0 || *--test.end()!=size-1)
                 return false;
 
-            // reorder records
-//            std::vector<Record<ESXRecordT> > buffer (size);
-			std::vector<bool> isSpliced (newOrder.size(), false);
+            // reorder records, only the pointers are moved
+            std::vector<std::unique_ptr<Record<ESXRecordT> > > buffer (size);
 
-			nextRecord = getNthRecordIterator(baseIndex);
-			for (int i=0; i < size; ++i)
+            for (int i=0; i<size; ++i)
             {
-				currentRecord = nextRecord;
-				++nextRecord;
-				// if this is a previously spliced record, skip to the next
-				for (int j=i; isSpliced[newOrder[j]] == true; j++)
-				{
-					currentRecord = nextRecord;
-					++nextRecord;
-				}
-				newPosition = getNthRecordIterator(newOrder[i]);
-				mRecords.splice(newPosition, mRecords, currentRecord);
-				(*currentRecord).setModified( (*currentRecord).get() );
-
-				// set this new position as spliced so it can be skipped
-				isSpliced[newOrder[i]] = true;
-//                buffer[newOrder[i]] = mRecords [baseIndex+i];
-//                buffer[newOrder[i]].setModified (buffer[newOrder[i]].get());
+                buffer[newOrder[i]] = std::move (mRecords [baseIndex+i]);
+                buffer[newOrder[i]]->setModified (buffer[newOrder[i]]->get());
             }
 
-//            std::copy (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
+            std::move (buffer.begin(), buffer.end(), mRecords.begin()+baseIndex);
 
             // update affected mIndex entries
-			std::map<std::string, int>::iterator iter;
-            for (iter = mIndex.begin(); iter != mIndex.end(); ++iter)
-                if ((iter->second >= baseIndex) && (iter->second < baseIndex+size))
-                    iter->second = newOrder[iter->second - baseIndex] + baseIndex;
-
-			// update iterator caches
-			// iterator in mLastAccessedRecord is the splice_destination_iterator used in the last splice operation above
-//			if ((mLastAccessedRecord.first >= baseIndex) && (mLastAccessedRecord.first < baseIndex + size))
-			++(mLastAccessedRecord.first);
-			if ((mLastAccessedConstRecord.first >= baseIndex) && (mLastAccessedConstRecord.first < baseIndex + size))
-				mLastAccessedConstRecord.first = newOrder[mLastAccessedConstRecord.first - baseIndex] + baseIndex;
-
+            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end(); ++iter)
+                if (iter->second>=baseIndex && iter->second<baseIndex+size)
+                    iter->second = newOrder.at (iter->second-baseIndex)+baseIndex;
         }
 
         return true;
@@ -408,19 +234,13 @@ namespace CSMWorld
        copy.mState = RecordBase::State_ModifiedOnly;
        copy.get().mId = destination;
 
-	   appendRecord(copy);
-//       insertRecord(copy, getAppendIndex(destination, type));
+       appendRecord(copy);
     }
 
-	// CONSTRUCTOR
     template<typename ESXRecordT, typename IdAccessorT>
     Collection<ESXRecordT, IdAccessorT>::Collection()
-    {
-		mLastAccessedRecord.first = -1;
-		mLastAccessedConstRecord.first = -1;
-	}
+    {}
 
-	// DESTRUCTOR
     template<typename ESXRecordT, typename IdAccessorT>
     Collection<ESXRecordT, IdAccessorT>::~Collection()
     {
@@ -435,23 +255,18 @@ namespace CSMWorld
 
         std::map<std::string, int>::iterator iter = mIndex.find (id);
 
-        if (iter == mIndex.end())
+        if (iter==mIndex.end())
         {
-			// ID not found in mIndex
             Record<ESXRecordT> record2;
             record2.mState = Record<ESXRecordT>::State_ModifiedOnly;
             record2.mModified = record;
 
-			appendRecord(record2);
-//            insertRecord (record2, getAppendIndex (id));
+            appendRecord (record2);
         }
         else
         {
-			// ID found
-            getNthRecord(iter->second).setModified(record);
+            mRecords[iter->second]->setModified (record);
         }
-
-		// update mIndex !!!! -----------------------
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -463,9 +278,8 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     std::string Collection<ESXRecordT, IdAccessorT>::getId (int index) const
     {
-//        return IdAccessorT().getId (mRecords.at (index).get());
-		return IdAccessorT().getId( getNthRecord(index).get());
-	}
+        return IdAccessorT().getId (mRecords.at (index)->get());
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     int  Collection<ESXRecordT, IdAccessorT>::getIndex (const std::string& id) const
@@ -487,16 +301,14 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     QVariant Collection<ESXRecordT, IdAccessorT>::getData (int index, int column) const
     {
-//        return mColumns.at (column)->get (mRecords.at (index));
-		return mColumns.at(column)->get(getNthRecord(index));
-	}
+        return mColumns.at (column)->get (*mRecords.at (index));
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::setData (int index, int column, const QVariant& data)
     {
-//        return mColumns.at (column)->set (mRecords.at (index), data);
-		return mColumns.at(column)->set(getNthRecord(index), data);
-	}
+        return mColumns.at (column)->set (*mRecords.at (index), data);
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     const ColumnBase& Collection<ESXRecordT, IdAccessorT>::getColumn (int column) const
@@ -522,27 +334,20 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::merge()
     {
-//        for (typename std::vector<Record<ESXRecordT> >::iterator iter (mRecords.begin()); iter!=mRecords.end(); ++iter)
-		typename std::list<Record<ESXRecordT> >::iterator iter;
-		for (iter = mRecords.begin(); iter != mRecords.end(); ++iter)
-            iter->merge();
+        for (typename std::vector<std::unique_ptr<Record<ESXRecordT> > >::iterator iter (mRecords.begin()); iter!=mRecords.end(); ++iter)
+            (*iter)->merge();
 
         purge();
-		// mIndex coherence??
-
-		// cache invalidation
-		invalidateCache();
-	}
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void  Collection<ESXRecordT, IdAccessorT>::purge()
     {
         int i = 0;
 
-        while (i < static_cast<int>(mRecords.size()))
+        while (i<static_cast<int> (mRecords.size()))
         {
-//            if (mRecords[i].isErased())
-			if ( getNthRecord(i).isErased())
+            if (mRecords[i]->isErased())
                 removeRows (i, 1);
             else
                 ++i;
@@ -552,45 +357,26 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::removeRows (int index, int count)
     {
-		typename std::list<Record<ESXRecordT>>::iterator startPos = getNthRecordIterator(index);
-		typename std::list<Record<ESXRecordT>>::iterator stopPos = getNthRecordIterator(index + count);
-
-		mRecords.erase(startPos, stopPos);
-
-//        typename std::map<std::string, int>::iterator iter = mIndex.begin();
-//        while (iter != mIndex.end())
-		typename std::map<std::string, int>::iterator iter, deleteMe=mIndex.end();
-		for (iter = mIndex.begin(); iter != mIndex.end(); iter++) 
-		{
-			if (deleteMe != mIndex.end())
-			{
-				mIndex.erase(deleteMe);
-				deleteMe = mIndex.end();
-			}
-			if (iter->second >= index) 
-			{
-				if (iter->second >= index + count)
-				{
-					iter->second -= count;
-				}
-                else
-				{
-					deleteMe = iter;
-//                    mIndex.erase(iter);
-				}
-			}
-		}
-
-		// update iterator caches
-		// asssuming that index >= 0
-		// iterator in mLastAccessedRecord is the last_erase_iterator (stopPos) for erase operation above
-		mLastAccessedRecord.first -= count;
-        if (mLastAccessedConstRecord.first >= index)
+        mRecords.erase (mRecords.begin()+index, mRecords.begin()+index+count);
+
+        typename std::map<std::string, int>::iterator iter = mIndex.begin();
+
+        while (iter!=mIndex.end())
         {
-            if (mLastAccessedConstRecord.first >= index + count)
-				mLastAccessedConstRecord.first -= count;
+            if (iter->second>=index)
+            {
+                if (iter->second>=index+count)
+                {
+                    iter->second -= count;
+                    ++iter;
+                }
+                else
+                {
+                    mIndex.erase (iter++);
+                }
+            }
             else
-				mLastAccessedConstRecord.first = -1;
+                ++iter;
         }
     }
 
@@ -606,9 +392,7 @@ namespace CSMWorld
         record2.mState = Record<ESXRecordT>::State_ModifiedOnly;
         record2.mModified = record;
 
-		appendRecord(record2);
-//        insertRecord (record2, getAppendIndex (id, type), type);
-
+        appendRecord (record2);
     }
 
     template<typename ESXRecordT, typename IdAccessorT>
@@ -627,38 +411,33 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::replace (int index, const RecordBase& record)
     {
-//        mRecords.at (index) = dynamic_cast<const Record<ESXRecordT>&> (record);
-		getNthRecord(index) = dynamic_cast<const Record<ESXRecordT>&> (record);
-	}
+        *mRecords.at (index) = dynamic_cast<const Record<ESXRecordT>&> (record);
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::appendRecord (const RecordBase& record,
         UniversalId::Type type)
     {
-		int index = getAppendIndex(IdAccessorT().getId(dynamic_cast<const Record<ESXRecordT>&> (record).get()), type);
+        const Record<ESXRecordT>& record2 = dynamic_cast<const Record<ESXRecordT>&> (record);
 
-		// if insertion point is not at end of vector, use insertRecord
-//		if (index < static_cast<int>(mRecords.size())-1 )
-		if (index < static_cast<int>(mRecords.size()) )
-		{
-			insertRecord(record, index);
-			return;
-		}
+        int index = getAppendIndex (IdAccessorT().getId (record2.get()), type);
 
-		const Record<ESXRecordT>& record2 = dynamic_cast<const Record<ESXRecordT>&> (record);
+        // subclasses may keep related records together, which requires an insertion
+        if (index<static_cast<int> (mRecords.size()))
+        {
+            insertRecord (record, index);
+            return;
+        }
 
-		mRecords.push_back(dynamic_cast<const Record<ESXRecordT>&> (record2));
+        mRecords.push_back (std::unique_ptr<Record<ESXRecordT> > (new Record<ESXRecordT> (record2)));
 
-		mIndex.insert( std::make_pair(Misc::StringUtils::lowerCase(IdAccessorT().getId(record2.get())), index) );
-		// cache invalidation
-		// not needed, no elements affected
-	}
+        mIndex.insert (std::make_pair (Misc::StringUtils::lowerCase (IdAccessorT().getId (record2.get())), index));
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     int Collection<ESXRecordT, IdAccessorT>::getAppendIndex (const std::string& id,
         UniversalId::Type type) const
     {
-		// std::string id is currently not used.  I'm assuming intention was to find insertion index following the last record with matching id
         return static_cast<int> (mRecords.size());
     }
 
@@ -666,12 +445,12 @@ namespace CSMWorld
     std::vector<std::string> Collection<ESXRecordT, IdAccessorT>::getIds (bool listDeleted) const
     {
         std::vector<std::string> ids;
-		typename std::map<std::string, int>::const_iterator iter;
-        for (iter = mIndex.begin(); iter != mIndex.end(); ++iter)
+
+        for (typename std::map<std::string, int>::const_iterator iter = mIndex.begin();
+            iter!=mIndex.end(); ++iter)
         {
-//            if (listDeleted || !mRecords[iter->second].isDeleted())
-			if (listDeleted || !getNthRecord(iter->second).isDeleted() )
-                ids.push_back (IdAccessorT().getId (getNthRecord(iter->second).get()));
+            if (listDeleted || !mRecords[iter->second]->isDeleted())
+                ids.push_back (IdAccessorT().getId (mRecords[iter->second]->get()));
         }
 
         return ids;
@@ -680,69 +459,49 @@ namespace CSMWorld
     template<typename ESXRecordT, typename IdAccessorT>
     const Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getRecord (const std::string& id) const
     {
-		int index = searchId(id);
-//        return mRecords.at (index);
-		return getNthRecord(index);
-	}
+        int index = getIndex (id);
+        return *mRecords.at (index);
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     const Record<ESXRecordT>& Collection<ESXRecordT, IdAccessorT>::getRecord (int index) const
     {
-//        return mRecords.at (index);
-		return getNthRecord(index);
-	}
+        return *mRecords.at (index);
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::insertRecord (const RecordBase& record, int index,
         UniversalId::Type type)
     {
-		if ( (index < 0) || (index > static_cast<int>(mRecords.size())) )
+        if (index<0 || index>static_cast<int> (mRecords.size()))
             throw std::runtime_error ("index out of range");
 
-		if (index == static_cast<int>(mRecords.size()) )
-			return appendRecord(record);
-
         const Record<ESXRecordT>& record2 = dynamic_cast<const Record<ESXRecordT>&> (record);
-		
-		typename std::list<Record<ESXRecordT> >::iterator recordIter = getNthRecordIterator(index);
-        mRecords.insert (recordIter, record2);
 
-		// if index is less than the largest possible index value, update mIndex etnries
-		if ( index < static_cast<int>(mRecords.size())-1 )
-        {
-			std::map<std::string, int>::iterator iter;
-			std::map<std::string, int>::iterator end = mIndex.end();
-			for (iter = mIndex.begin(); iter != end; ++iter)
-				if (iter->second >= index)
-					++(iter->second);
+        // the records themselves stay in place, only the pointers behind the insertion point move
+        mRecords.insert (mRecords.begin()+index, std::unique_ptr<Record<ESXRecordT> > (new Record<ESXRecordT> (record2)));
 
-			// update iterator caches
-			// must detect case where inserting into empty set
-			// iterator in mLastAccessedRecord was last used as insertion_iterator for operation above
-			++(mLastAccessedRecord.first);
-			if (mLastAccessedConstRecord.first >= index)
-				++(mLastAccessedConstRecord.first);
-		}
-		// insert new ID-index pair into mIndex
-        mIndex.insert ( std::make_pair(Misc::StringUtils::lowerCase(IdAccessorT().getId(record2.get())), index) );
+        if (index<static_cast<int> (mRecords.size())-1)
+        {
+            for (std::map<std::string, int>::iterator iter (mIndex.begin()); iter!=mIndex.end();
+                ++iter)
+                 if (iter->second>=index)
+                     ++(iter->second);
+        }
 
-	}
+        mIndex.insert (std::make_pair (Misc::StringUtils::lowerCase (IdAccessorT().getId (
+            record2.get())), index));
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     void Collection<ESXRecordT, IdAccessorT>::setRecord (int index, const Record<ESXRecordT>& record)
     {
-		std::string oldRecordmID, newRecordmID;
-		oldRecordmID = Misc::StringUtils::lowerCase(IdAccessorT().getId(getNthRecord(index).get()));
-		newRecordmID = Misc::StringUtils::lowerCase(IdAccessorT().getId(record.get()));
-//        if (Misc::StringUtils::lowerCase (IdAccessorT().getId (mRecords.at (index).get()))!=
-//		if (Misc::StringUtils::lowerCase(IdAccessorT().getId(getNthRecord(index).get())) !=
-//			Misc::StringUtils::lowerCase (IdAccessorT().getId (record.get())))
-		if (oldRecordmID != newRecordmID)
+        if (Misc::StringUtils::lowerCase (IdAccessorT().getId (mRecords.at (index)->get()))!=
+            Misc::StringUtils::lowerCase (IdAccessorT().getId (record.get())))
             throw std::runtime_error ("attempt to change the ID of a record");
 
-//        mRecords.at (index) = record;
-		getNthRecord(index) = record;
-	}
+        *mRecords.at (index) = record;
+    }
 
     template<typename ESXRecordT, typename IdAccessorT>
     bool Collection<ESXRecordT, IdAccessorT>::reorderRows (int baseIndex, const std::vector<int>& newOrder)
@@ -4,6 +4,8 @@
 #include <algorithm>
 
 #include <QAbstractItemModel>
+#include <QRunnable>
+#include <QThreadPool>
 
 #include <components/esm/esmreader.hpp>
 #include <components/esm/defs.hpp>
@@ -21,6 +23,35 @@
 #include "resourcetable.hpp"
 #include "nestedcoladapterimp.hpp"
 
+namespace
+{
+    class LoadLandDataJob : public QRunnable
+    {
+            const ESM::Land& mLand;
+            std::string& mError;
+
+        public:
+
+            LoadLandDataJob (const ESM::Land& land, std::string& error)
+            : mLand (land), mError (error)
+            {}
+
+            virtual void run()
+            {
+                // each land record opens its own reader, so they can be loaded concurrently
+                try
+                {
+                    mLand.loadData (ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML |
+                        ESM::Land::DATA_VCLR | ESM::Land::DATA_VTEX);
+                }
+                catch (const std::exception& e)
+                {
+                    mError = e.what();
+                }
+            }
+    };
+}
+
 void CSMWorld::Data::addModel (QAbstractItemModel *model, UniversalId::Type type, bool update)
 {
     mModels.push_back (model);
@@ -50,6 +81,36 @@ void CSMWorld::Data::appendIds (std::vector<std::string>& ids, const CollectionB
     ids.insert (ids.end(), ids2.begin(), ids2.end());
 }
 
+void CSMWorld::Data::loadLandData()
+{
+    // a content file may contain the same land more than once, but its data must only be loaded by one job
+    std::sort (mLandToLoad.begin(), mLandToLoad.end());
+    mLandToLoad.erase (std::unique (mLandToLoad.begin(), mLandToLoad.end()), mLandToLoad.end());
+
+    std::vector<std::string> errors (mLandToLoad.size());
+
+    {
+        QThreadPool pool;
+
+        for (std::size_t i=0; i<mLandToLoad.size(); ++i)
+        {
+            // a later record of the same file may have deleted the land again
+            int index = mLand.searchId (mLandToLoad[i]);
+
+            if (index!=-1)
+                pool.start (new LoadLandDataJob (mLand.getRecord (index).get(), errors[i]));
+        }
+
+        pool.waitForDone();
+    }
+
+    mLandToLoad.clear();
+
+    for (std::vector<std::string>::const_iterator iter (errors.begin()); iter!=errors.end(); ++iter)
+        if (!iter->empty())
+            throw std::runtime_error (*iter);
+}
+
 int CSMWorld::Data::count (RecordBase::State state, const CollectionBase& collection)
 {
     int number = 0;
@@ -896,6 +957,7 @@ int CSMWorld::Data::startLoading (const boost::filesystem::path& path, bool base
     mReader = 0;
 
     mDialogue = 0;
+    mLandToLoad.clear();
 
     mReader = new ESM::ESMReader;
     mReader->setEncoder (&mEncoder);
@@ -940,6 +1002,8 @@ bool CSMWorld::Data::continueLoading (CSMDoc::Messages& messages)
 
     if (!mReader->hasMoreRecs())
     {
+        loadLandData();
+
         if (mBase)
         {
             // Don't delete the Reader yet. Some record types store a reference to the Reader to handle on-demand loading.
@@ -990,10 +1054,10 @@ bool CSMWorld::Data::continueLoading (CSMDoc::Messages& messages)
 
             // Load all land data for now. A future optimisation may only load non-base data
             // if a suitable mechanism for avoiding race conditions can be established.
+            // Decoding the data is the bulk of the work, so it is done for the whole content
+            // file at once on a thread pool, see loadLandData.
             if (index!=-1/* && !mBase*/)
-                mLand.getRecord (index).get().loadData (
-                    ESM::Land::DATA_VHGT | ESM::Land::DATA_VNML | ESM::Land::DATA_VCLR |
-                    ESM::Land::DATA_VTEX);
+                mLandToLoad.push_back (mLand.getId (index));
 
             break;
         }
@@ -116,7 +116,7 @@ namespace CSMWorld
             const ESM::Dialogue *mDialogue; // last loaded dialogue
             bool mBase;
             bool mProject;
-            std::map<std::string, std::map<ESM::RefNum, std::string> > mRefLoadCache;
+            std::map<std::string, std::map<unsigned int, std::string> > mRefLoadCache;
             int mReaderIndex;
 
             std::shared_ptr<Resource::ResourceSystem> mResourceSystem;
@@ -125,6 +125,9 @@ namespace CSMWorld
 
             std::map<std::string, int> mContentFileNames;
 
+            // IDs of the land records of the current content file, whose data has not been loaded yet
+            std::vector<std::string> mLandToLoad;
+
             // not implemented
             Data (const Data&);
             Data& operator= (const Data&);
@@ -138,6 +141,9 @@ namespace CSMWorld
 
             static int count (RecordBase::State state, const CollectionBase& collection);
 
+            void loadLandData();
+            ///< Load the data of the land records in mLandToLoad, on all cores.
+
         public:
 
             Data (ToUTF8::FromType encoding, const ResourcesManager& resourcesManager, const Fallback::Map* fallback, const boost::filesystem::path& resDir);
@@ -277,6 +277,11 @@ int CSMWorld::IdTable::getColumnId(int column) const
     return mIdCollection->getColumn(column).getId();
 }
 
+const CSMWorld::CollectionBase *CSMWorld::IdTable::getCollection() const
+{
+    return mIdCollection;
+}
+
 CSMWorld::CollectionBase *CSMWorld::IdTable::idCollection() const
 {
     return mIdCollection;
@@ -69,6 +69,10 @@ namespace CSMWorld
 
             const RecordBase& getRecord (const std::string& id) const;
 
+            const CollectionBase *getCollection() const;
+            ///< Read-only access to the records, for operations that go over the whole table and
+            /// do not need the model interface.
+
             virtual int searchColumnIndex (Columns::ColumnId id) const;
             ///< Return index of column with the given \a id. If no such column exists, -1 is returned.
 
@@ -38,7 +38,7 @@ void CSMWorld::InfoCollection::load (const Info& record, bool base)
         {
             Range topicrange = getTopicRange (topic);
 
-            index = std::distance (getRecords().begin(), topicrange.second);
+            index = std::distance (getRecords().begin(), topicrange.second.base());
         }
 
         insertRecord (record2, index);
@@ -65,7 +65,7 @@ int CSMWorld::InfoCollection::getInfoIndex (const std::string& id, const std::st
 
     for (; range.first != range.second; ++range.first)
         if (Misc::StringUtils::ciEqual(range.first->get().mId, fullId))
-            return std::distance (getRecords().begin(), range.first);
+            return std::distance (getRecords().begin(), range.first.base());
 
     return -1;
 }
@@ -82,7 +82,7 @@ int CSMWorld::InfoCollection::getAppendIndex (const std::string& id, UniversalId
     if (range.first==range.second)
         return Collection<Info, IdAccessor<Info> >::getAppendIndex (id, type);
 
-    return std::distance (getRecords().begin(), range.second);
+    return std::distance (getRecords().begin(), range.second.base());
 }
 
 bool CSMWorld::InfoCollection::reorderRows (int baseIndex, const std::vector<int>& newOrder)
@@ -159,15 +159,15 @@ CSMWorld::InfoCollection::Range CSMWorld::InfoCollection::getTopicRange (const s
         std::size_t size = topic2.size();
 
         if ( (testTopicId.size() < size) || (testTopicId.substr (0, size) != topic2) )
-            return Range (getRecords().end(), getRecords().end());
+            return Range (RecordConstIterator (getRecords().end()), RecordConstIterator (getRecords().end()));
     }
 
     if (iter==getIdMap().end())
-        return Range (getRecords().end(), getRecords().end());
+        return Range (RecordConstIterator (getRecords().end()), RecordConstIterator (getRecords().end()));
 
-	RecordConstIterator begin (getNthRecordIterator(iter->second));
+    RecordConstIterator begin (getRecords().begin()+iter->second);
 
-    while (begin != getRecords().begin())
+    while (begin.base() != getRecords().begin())
     {
         if (!Misc::StringUtils::ciEqual(begin->get().mTopicId, topic2))
         {
@@ -181,7 +181,7 @@ CSMWorld::InfoCollection::Range CSMWorld::InfoCollection::getTopicRange (const s
     // Find end
     RecordConstIterator end = begin;
 
-    for (; end != getRecords().end(); ++end)
+    for (; end.base() != getRecords().end(); ++end)
         if (!Misc::StringUtils::ciEqual(end->get().mTopicId, topic2))
             break;
 
@@ -193,7 +193,6 @@ void CSMWorld::InfoCollection::removeDialogueInfos(const std::string& dialogueId
     std::string id = Misc::StringUtils::lowerCase(dialogueId);
     std::vector<int> erasedRecords;
 
-	// update mIndex
     std::map<std::string, int>::const_iterator current = getIdMap().lower_bound(id);
     std::map<std::string, int>::const_iterator end = getIdMap().end();
     for (; current != end; ++current)
@@ -217,7 +216,6 @@ void CSMWorld::InfoCollection::removeDialogueInfos(const std::string& dialogueId
             break;
         }
     }
-	invalidateCache();
 
     while (!erasedRecords.empty())
     {
@@ -1,6 +1,8 @@
 #ifndef CSM_WOLRD_INFOCOLLECTION_H
 #define CSM_WOLRD_INFOCOLLECTION_H
 
+#include <boost/iterator/indirect_iterator.hpp>
+
 #include "collection.hpp"
 #include "info.hpp"
 
@@ -15,7 +17,8 @@ namespace CSMWorld
     {
         public:
 
-            typedef std::list<Record<Info> >::const_iterator RecordConstIterator;
+            typedef boost::indirect_iterator<std::vector<std::unique_ptr<Record<Info> > >::const_iterator,
+                const Record<Info> > RecordConstIterator;
             typedef std::pair<RecordConstIterator, RecordConstIterator> Range;
 
         private:
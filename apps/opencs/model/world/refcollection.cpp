@@ -2,6 +2,7 @@
 
 #include <sstream>
 #include <iostream>
+#include <algorithm>
 
 #include <components/misc/stringops.hpp>
 #include <components/esm/loadcell.hpp>
@@ -12,7 +13,7 @@
 #include "record.hpp"
 
 void CSMWorld::RefCollection::load (ESM::ESMReader& reader, int cellIndex, bool base,
-    std::map<ESM::RefNum, std::string>& cache, CSMDoc::Messages& messages)
+    std::map<unsigned int, std::string>& cache, CSMDoc::Messages& messages)
 {
     Record<Cell> cell = mCells.getRecord (cellIndex);
 
@@ -73,12 +74,7 @@ void CSMWorld::RefCollection::load (ESM::ESMReader& reader, int cellIndex, bool
             ref.mCell = cell2.mId;
 
         // ignore content file number
-        std::map<ESM::RefNum, std::string>::iterator iter = cache.begin();
-        for (; iter != cache.end(); ++iter)
-        {
-            if (ref.mRefNum.mIndex == iter->first.mIndex)
-                break;
-        }
+        std::map<unsigned int, std::string>::iterator iter = cache.find (ref.mRefNum.mIndex);
 
         if (isDeleted)
         {
@@ -120,7 +116,7 @@ void CSMWorld::RefCollection::load (ESM::ESMReader& reader, int cellIndex, bool
 
             appendRecord (record);
 
-            cache.insert (std::make_pair (ref.mRefNum, ref.mId));
+            cache.insert (std::make_pair (ref.mRefNum.mIndex, ref.mId));
         }
         else
         {
@@ -144,3 +140,112 @@ std::string CSMWorld::RefCollection::getNewId()
     stream << "ref#" << mNextId++;
     return stream.str();
 }
+
+void CSMWorld::RefCollection::updateCellIndex (int row)
+{
+    const Record<CellRef>& record = getRecord (row);
+
+    std::string refId = Misc::StringUtils::lowerCase (record.get().mId);
+
+    if (record.mState==RecordBase::State_Erased)
+    {
+        removeFromCellIndex (refId);
+        return;
+    }
+
+    std::string cellId = Misc::StringUtils::lowerCase (record.get().mCell);
+
+    std::map<std::string, std::string>::iterator iter = mRefCells.find (refId);
+
+    if (iter!=mRefCells.end())
+    {
+        if (iter->second==cellId)
+            return;
+
+        // moved to another cell
+        std::map<std::string, std::set<std::string> >::iterator cell = mCellIndex.find (iter->second);
+        cell->second.erase (refId);
+        if (cell->second.empty())
+            mCellIndex.erase (cell);
+
+        iter->second = cellId;
+    }
+    else
+        mRefCells.insert (std::make_pair (refId, cellId));
+
+    mCellIndex[cellId].insert (refId);
+}
+
+void CSMWorld::RefCollection::removeFromCellIndex (const std::string& refId)
+{
+    std::map<std::string, std::string>::iterator iter = mRefCells.find (refId);
+
+    if (iter==mRefCells.end())
+        return;
+
+    std::map<std::string, std::set<std::string> >::iterator cell = mCellIndex.find (iter->second);
+    cell->second.erase (refId);
+    if (cell->second.empty())
+        mCellIndex.erase (cell);
+
+    mRefCells.erase (iter);
+}
+
+std::vector<int> CSMWorld::RefCollection::getCellRows (const std::string& cellId) const
+{
+    std::vector<int> rows;
+
+    std::map<std::string, std::set<std::string> >::const_iterator cell =
+        mCellIndex.find (Misc::StringUtils::lowerCase (cellId));
+
+    if (cell==mCellIndex.end())
+        return rows;
+
+    rows.reserve (cell->second.size());
+
+    for (std::set<std::string>::const_iterator iter (cell->second.begin()); iter!=cell->second.end(); ++iter)
+        rows.push_back (searchId (*iter));
+
+    std::sort (rows.begin(), rows.end());
+
+    return rows;
+}
+
+void CSMWorld::RefCollection::setData (int index, int column, const QVariant& data)
+{
+    Collection<CellRef>::setData (index, column, data);
+    updateCellIndex (index);
+}
+
+void CSMWorld::RefCollection::removeRows (int index, int count)
+{
+    for (int i=index; i<index+count; ++i)
+        removeFromCellIndex (Misc::StringUtils::lowerCase (getId (i)));
+
+    Collection<CellRef>::removeRows (index, count);
+}
+
+void CSMWorld::RefCollection::replace (int index, const RecordBase& record)
+{
+    Collection<CellRef>::replace (index, record);
+    updateCellIndex (index);
+}
+
+void CSMWorld::RefCollection::appendRecord (const RecordBase& record, UniversalId::Type type)
+{
+    Collection<CellRef>::appendRecord (record, type);
+    updateCellIndex (getSize()-1);
+}
+
+void CSMWorld::RefCollection::insertRecord (const RecordBase& record, int index,
+    UniversalId::Type type)
+{
+    Collection<CellRef>::insertRecord (record, index, type);
+    updateCellIndex (index);
+}
+
+void CSMWorld::RefCollection::setRecord (int index, const Record<CellRef>& record)
+{
+    Collection<CellRef>::setRecord (index, record);
+    updateCellIndex (index);
+}
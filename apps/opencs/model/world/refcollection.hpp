@@ -2,6 +2,8 @@
 #define CSM_WOLRD_REFCOLLECTION_H
 
 #include <map>
+#include <set>
+#include <vector>
 
 #include "../doc/stage.hpp"
 
@@ -20,6 +22,17 @@ namespace CSMWorld
             Collection<Cell>& mCells;
             int mNextId;
 
+            // lower case cell ID -> lower case IDs of the references in that cell (including deleted ones)
+            std::map<std::string, std::set<std::string> > mCellIndex;
+
+            // lower case reference ID -> the cell it is listed under in mCellIndex
+            std::map<std::string, std::string> mRefCells;
+
+            /// List the reference in \a row under its current cell.
+            void updateCellIndex (int row);
+
+            void removeFromCellIndex (const std::string& refId);
+
         public:
             // MSVC needs the constructor for a class inheriting a template to be defined in header
             RefCollection (Collection<Cell>& cells)
@@ -27,10 +40,33 @@ namespace CSMWorld
             {}
 
             void load (ESM::ESMReader& reader, int cellIndex, bool base,
-                std::map<ESM::RefNum, std::string>& cache, CSMDoc::Messages& messages);
+                std::map<unsigned int, std::string>& cache, CSMDoc::Messages& messages);
             ///< Load a sequence of references.
+            ///
+            /// \param cache Reference number (without the content file) -> ID of the references
+            /// of this cell loaded so far
 
             std::string getNewId();
+
+            std::vector<int> getCellRows (const std::string& cellId) const;
+            ///< Return the rows of the references in cell \a cellId (including deleted references),
+            /// in ascending order. Costs time in proportion to the number of references in the cell,
+            /// not in the collection.
+
+            virtual void setData (int index, int column, const QVariant& data);
+
+            virtual void removeRows (int index, int count);
+
+            virtual void replace (int index, const RecordBase& record);
+
+            virtual void appendRecord (const RecordBase& record,
+                UniversalId::Type type = UniversalId::Type_None);
+
+            virtual void insertRecord (const RecordBase& record, int index,
+                UniversalId::Type type = UniversalId::Type_None);
+
+            void setRecord (int index, const Record<CellRef>& record);
+            ///< \attention This function must not change the ID.
     };
 }
 
@@ -179,7 +179,7 @@ void CSMWorld::RefIdData::load (ESM::ESMReader& reader, bool base, CSMWorld::Uni
     if (found == mRecordContainers.end())
         throw std::logic_error ("Invalid Referenceable ID type");
 
-    int index = found->second->load(reader, base);
+    int index = found->second->load(reader, base, mIndex, type);
     if (index != -1)
     {
         LocalIndex localIndex = LocalIndex(index, type);
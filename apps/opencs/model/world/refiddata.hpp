@@ -39,6 +39,9 @@ namespace CSMWorld
 {
     struct RefIdDataContainerBase
     {
+        /// Lower case ID -> index of the record within its container and the container's type
+        typedef std::map<std::string, std::pair<int, UniversalId::Type> > Index;
+
         virtual ~RefIdDataContainerBase();
 
         virtual int getSize() const = 0;
@@ -51,8 +54,12 @@ namespace CSMWorld
 
         virtual void insertRecord (RecordBase& record) = 0;
 
-        virtual int load (ESM::ESMReader& reader, bool base) = 0;
-        ///< \return index of a loaded record or -1 if no record was loaded
+        virtual int load (ESM::ESMReader& reader, bool base, const Index& index,
+            UniversalId::Type type) = 0;
+        ///< \param index The index of all referenceables, used to find a record that is being
+        /// overwritten.
+        /// \param type Type of the records in this container.
+        /// \return index of a loaded record or -1 if no record was loaded
 
         virtual void erase (int index, int count) = 0;
 
@@ -77,7 +84,8 @@ namespace CSMWorld
 
         virtual void insertRecord (RecordBase& record);
 
-        virtual int load (ESM::ESMReader& reader, bool base);
+        virtual int load (ESM::ESMReader& reader, bool base, const Index& index,
+            UniversalId::Type type);
         ///< \return index of a loaded record or -1 if no record was loaded
 
         virtual void erase (int index, int count);
@@ -128,20 +136,32 @@ namespace CSMWorld
     }
 
     template<typename RecordT>
-    int RefIdDataContainer<RecordT>::load (ESM::ESMReader& reader, bool base)
+    int RefIdDataContainer<RecordT>::load (ESM::ESMReader& reader, bool base, const Index& index2,
+        UniversalId::Type type)
     {
         RecordT record;
         bool isDeleted = false;
 
         record.load(reader, isDeleted);
 
-        int index = 0;
         int numRecords = static_cast<int>(mContainer.size());
-        for (; index < numRecords; ++index)
+        int index = numRecords;
+
+        Index::const_iterator found = index2.find (Misc::StringUtils::lowerCase (record.mId));
+        if (found != index2.end())
         {
-            if (Misc::StringUtils::ciEqual(mContainer[index].get().mId, record.mId))
+            if (found->second.second == type)
+                index = found->second.first;
+            else
             {
-                break;
+                // the ID has been taken over by a record of another type, which hides ours from the index
+                for (index = 0; index < numRecords; ++index)
+                {
+                    if (Misc::StringUtils::ciEqual(mContainer[index].get().mId, record.mId))
+                    {
+                        break;
+                    }
+                }
             }
         }
 
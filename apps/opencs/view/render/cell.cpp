@@ -92,12 +92,11 @@ CSVRender::Cell::Cell (CSMWorld::Data& data, osg::Group* rootNode, const std::st
 
     if (!mDeleted)
     {
-        CSMWorld::IdTable& references = dynamic_cast<CSMWorld::IdTable&> (
-            *mData.getTableModel (CSMWorld::UniversalId::Type_References));
+        // only look at the references of this cell, not the whole table
+        std::vector<int> rows = mData.getReferences().getCellRows (mId);
 
-        int rows = references.rowCount();
-
-        addObjects (0, rows-1);
+        for (std::vector<int>::const_iterator iter (rows.begin()); iter!=rows.end(); ++iter)
+            addObjects (*iter, *iter);
 
         const CSMWorld::IdCollection<CSMWorld::Land>& land = mData.getLand();
         int landIndex = land.searchId(mId);
@@ -0,0 +1,201 @@
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include <osg/Math>
+
+#include "mwbase/environment.hpp"
+#include "mwbase/world.hpp"
+
+#include "mwworld/ptr.hpp"
+
+namespace OMW
+{
+    Benchmark::Benchmark (int numFrames, float timeStep)
+        : mNumFrames (numFrames)
+        , mTimeStep (timeStep)
+        , mFrame (0)
+    {
+        mRows.reserve(numFrames);
+    }
+
+    void Benchmark::loadPath (const std::string& path)
+    {
+        std::ifstream stream (path.c_str());
+        if (!stream.is_open())
+            throw std::runtime_error ("failed to open benchmark path " + path);
+
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline (stream, line))
+        {
+            ++lineNumber;
+            if (line.empty() || line[0] == '#')
+                continue;
+
+            std::istringstream lineStream (line);
+            Keyframe keyframe;
+            keyframe.mYaw = 0;
+            keyframe.mPitch = 0;
+            lineStream >> keyframe.mTime >> keyframe.mPos[0] >> keyframe.mPos[1] >> keyframe.mPos[2];
+            if (lineStream.fail())
+            {
+                std::ostringstream error;
+                error << "invalid keyframe in " << path << " line " << lineNumber;
+                throw std::runtime_error (error.str());
+            }
+            lineStream >> keyframe.mYaw >> keyframe.mPitch;
+
+            if (!mPath.empty() && keyframe.mTime < mPath.back().mTime)
+            {
+                std::ostringstream error;
+                error << "keyframes out of order in " << path << " line " << lineNumber;
+                throw std::runtime_error (error.str());
+            }
+            mPath.push_back (keyframe);
+        }
+
+        std::cout << "Benchmark path: " << mPath.size() << " keyframes loaded from " << path << std::endl;
+    }
+
+    bool Benchmark::isDone() const
+    {
+        return mFrame >= mNumFrames;
+    }
+
+    void Benchmark::applyPath()
+    {
+        if (mPath.empty())
+            return;
+
+        float time = mFrame * mTimeStep;
+
+        std::vector<Keyframe>::const_iterator next = mPath.begin();
+        while (next != mPath.end() && next->mTime <= time)
+            ++next;
+
+        Keyframe keyframe;
+        if (next == mPath.begin())
+            keyframe = mPath.front();
+        else if (next == mPath.end())
+            keyframe = mPath.back();
+        else
+        {
+            const Keyframe& prev = *(next-1);
+            float factor = (time - prev.mTime) / (next->mTime - prev.mTime);
+            keyframe.mTime = time;
+            for (int i=0; i<3; ++i)
+                keyframe.mPos[i] = prev.mPos[i] + (next->mPos[i] - prev.mPos[i]) * factor;
+            keyframe.mYaw = prev.mYaw + (next->mYaw - prev.mYaw) * factor;
+            keyframe.mPitch = prev.mPitch + (next->mPitch - prev.mPitch) * factor;
+        }
+
+        MWBase::World* world = MWBase::Environment::get().getWorld();
+        MWWorld::Ptr player = world->getPlayerPtr();
+        player = world->moveObject (player, keyframe.mPos[0], keyframe.mPos[1], keyframe.mPos[2]);
+        world->rotateObject (player, osg::DegreesToRadians (keyframe.mPitch), 0, osg::DegreesToRadians (keyframe.mYaw));
+    }
+
+    void Benchmark::addTiming (const std::string& name, double seconds)
+    {
+        size_t index = mCurrentRow.size();
+        if (index >= mColumns.size() || mColumns[index] != name)
+        {
+            std::vector<std::string>::const_iterator found = std::find (mColumns.begin(), mColumns.end(), name);
+            index = found - mColumns.begin();
+            if (found == mColumns.end())
+                mColumns.push_back (name);
+        }
+
+        if (index >= mCurrentRow.size())
+            mCurrentRow.resize (index+1, 0.0);
+        mCurrentRow[index] += seconds;
+    }
+
+    void Benchmark::endFrame()
+    {
+        mCurrentRow.resize (mColumns.size(), 0.0);
+        mRows.push_back (mCurrentRow);
+        mCurrentRow.clear();
+        ++mFrame;
+    }
+
+    bool Benchmark::writeResults (const std::string& path) const
+    {
+        bool json = path.size() >= 5 && path.compare (path.size()-5, 5, ".json") == 0;
+
+        std::ofstream stream (path.c_str(), std::ios_base::out | std::ios_base::trunc);
+        if (!stream.is_open())
+        {
+            std::cerr << "Benchmark: failed to open " << path << std::endl;
+            return false;
+        }
+
+        // all timings in milliseconds
+        stream << std::fixed << std::setprecision (3);
+        if (json)
+            stream << "{\"timeStep\":" << mTimeStep << ",\"frames\":[\n";
+        else
+        {
+            stream << "frame";
+            for (std::vector<std::string>::const_iterator it = mColumns.begin(); it != mColumns.end(); ++it)
+                stream << "," << *it;
+            stream << "\n";
+        }
+
+        for (size_t row=0; row<mRows.size(); ++row)
+        {
+            if (json)
+                stream << (row ? ",\n" : "") << "{\"frame\":" << row;
+            else
+                stream << row;
+
+            for (size_t column=0; column<mColumns.size(); ++column)
+            {
+                double value = column < mRows[row].size() ? mRows[row][column] * 1000.0 : 0.0;
+                if (json)
+                    stream << ",\"" << mColumns[column] << "\":" << value;
+                else
+                    stream << "," << value;
+            }
+            stream << (json ? "}" : "\n");
+        }
+        if (json)
+            stream << "\n]}\n";
+
+        if (!stream.good())
+        {
+            std::cerr << "Benchmark: failed to write " << path << std::endl;
+            return false;
+        }
+
+        std::cout << "Benchmark: " << mRows.size() << " frames written to " << path << std::endl;
+        std::cout << std::fixed << std::setprecision (3);
+        for (size_t column=0; column<mColumns.size(); ++column)
+        {
+            std::vector<double> values;
+            values.reserve (mRows.size());
+            double sum = 0.0;
+            for (size_t row=0; row<mRows.size(); ++row)
+            {
+                values.push_back (column < mRows[row].size() ? mRows[row][column] * 1000.0 : 0.0);
+                sum += values.back();
+            }
+            if (values.empty())
+                continue;
+            std::sort (values.begin(), values.end());
+
+            std::cout << "  " << std::setw (24) << std::left << mColumns[column] << std::right
+                      << " mean " << std::setw (9) << sum / values.size()
+                      << " ms, median " << std::setw (9) << values[values.size()/2]
+                      << " ms, 95% " << std::setw (9) << values[std::min (values.size()-1, values.size()*95/100)]
+                      << " ms, max " << std::setw (9) << values.back() << " ms" << std::endl;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef GAME_BENCHMARK_H
+#define GAME_BENCHMARK_H
+
+#include <string>
+#include <vector>
+
+namespace OMW
+{
+    /// \brief Records the time taken by the parts of each frame of a benchmark run, and moves the player along a path.
+    ///
+    /// The engine runs a fixed number of frames with a fixed time step, so that runs of different builds do the same work.
+    class Benchmark
+    {
+        public:
+            /// \param timeStep Simulated seconds per frame.
+            Benchmark (int numFrames, float timeStep);
+
+            /// Load a player path, each line holding a keyframe "<time> <x> <y> <z> [<yaw> [<pitch>]]",
+            /// with the time in seconds and the angles in degrees. Empty lines and lines starting with # are ignored.
+            /// \throw std::runtime_error
+            void loadPath (const std::string& path);
+
+            int getNumFrames() const { return mNumFrames; }
+
+            float getTimeStep() const { return mTimeStep; }
+
+            bool isDone() const;
+
+            /// Place the player at the position of the path for the current frame.
+            void applyPath();
+
+            /// Add the time that a part of the current frame took. The parts should be added in the same order every frame.
+            void addTiming (const std::string& name, double seconds);
+
+            /// Finish the current frame.
+            void endFrame();
+
+            /// Write one line per frame to \a path, as CSV, or as JSON if \a path ends in ".json", and
+            /// print a summary of each part to the console.
+            /// \return false if the file could not be written.
+            bool writeResults (const std::string& path) const;
+
+        private:
+            struct Keyframe
+            {
+                float mTime;
+                float mPos[3];
+                float mYaw;
+                float mPitch;
+            };
+
+            int mNumFrames;
+            float mTimeStep;
+            int mFrame;
+            std::vector<Keyframe> mPath;
+            std::vector<std::string> mColumns;
+            std::vector<std::vector<double> > mRows;
+            std::vector<double> mCurrentRow;
+    };
+}
+
+#endif
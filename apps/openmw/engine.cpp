@@ -1,4 +1,5 @@
 #include "engine.hpp"
+#include "benchmark.hpp"
 
 #include <iomanip>
 
@@ -11,6 +12,7 @@
 #include <SDL.h>
 
 #include <components/misc/rng.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/vfs/manager.hpp>
 #include <components/vfs/registerarchives.hpp>
@@ -87,12 +89,16 @@ void OMW::Engine::frame(float frametime)
         mEnvironment.setFrameDuration (frametime);
 
         // update input
-        mEnvironment.getInputManager()->update(frametime, false);
+        {
+            Misc::ProfileZone zone("Input");
+            mEnvironment.getInputManager()->update(frametime, false);
+        }
 
         // When the window is minimized, pause the game. Currently this *has* to be here to work around a MyGUI bug.
         // If we are not currently rendering, then RenderItems will not be reused resulting in a memory leak upon changing widget textures (fixed in MyGUI 3.3.2),
         // and destroyed widgets will not be deleted (not fixed yet, https://github.com/MyGUI/mygui/issues/21)
-        if (!mEnvironment.getInputManager()->isWindowVisible())
+        // The hidden window of a benchmark run is still rendered.
+        if (!mEnvironment.getInputManager()->isWindowVisible() && mBenchmarkFrames == 0)
             return;
 
         // sound
@@ -103,7 +109,10 @@ void OMW::Engine::frame(float frametime)
         bool paused = mEnvironment.getWindowManager()->containsMode(MWGui::GM_MainMenu);
 
         // update game state
-        mEnvironment.getStateManager()->update (frametime);
+        {
+            Misc::ProfileZone zone("State");
+            mEnvironment.getStateManager()->update (frametime);
+        }
 
         bool guiActive = mEnvironment.getWindowManager()->isGuiMode();
 
@@ -111,6 +120,7 @@ void OMW::Engine::frame(float frametime)
         if (mEnvironment.getStateManager()->getState()==
             MWBase::StateManager::State_Running)
         {
+            Misc::ProfileZone zone("Scripts");
             if (!paused)
             {
                 if (mEnvironment.getWorld()->getScriptsEnabled())
@@ -138,6 +148,7 @@ void OMW::Engine::frame(float frametime)
         if (mEnvironment.getStateManager()->getState()!=
             MWBase::StateManager::State_NoGame)
         {
+            Misc::ProfileZone zone("Mechanics");
             mEnvironment.getMechanicsManager()->update(frametime,
                 guiActive);
         }
@@ -156,16 +167,20 @@ void OMW::Engine::frame(float frametime)
         if (mEnvironment.getStateManager()->getState()!=
             MWBase::StateManager::State_NoGame)
         {
+            Misc::ProfileZone zone("World");
             mEnvironment.getWorld()->update(frametime, guiActive);
         }
         osg::Timer_t afterPhysicsTick = osg::Timer::instance()->tick();
 
         // update GUI
-        mEnvironment.getWindowManager()->onFrame(frametime);
-        if (mEnvironment.getStateManager()->getState()!=
-            MWBase::StateManager::State_NoGame)
         {
-            mEnvironment.getWindowManager()->update();
+            Misc::ProfileZone zone("GUI");
+            mEnvironment.getWindowManager()->onFrame(frametime);
+            if (mEnvironment.getStateManager()->getState()!=
+                MWBase::StateManager::State_NoGame)
+            {
+                mEnvironment.getWindowManager()->update();
+            }
         }
 
         unsigned int frameNumber = mViewer->getFrameStamp()->getFrameNumber();
@@ -188,6 +203,8 @@ void OMW::Engine::frame(float frametime)
 
             stats->setAttribute(frameNumber, "WorkQueue", mWorkQueue->getNumItems());
             stats->setAttribute(frameNumber, "WorkThread", mWorkQueue->getNumActiveThreads());
+
+            mEnvironment.getMechanicsManager()->reportStats(frameNumber, stats);
         }
 
     }
@@ -214,6 +231,8 @@ OMW::Engine::Engine(Files::ConfigurationManager& configurationManager)
   , mFSStrict (false)
   , mScriptBlacklistUse (true)
   , mNewGame (false)
+  , mBenchmarkFrames (0)
+  , mBenchmarkFps (60.f)
   , mCfgMgr(configurationManager)
 {
     Misc::Rng::init();
@@ -296,6 +315,14 @@ void OMW::Engine::setSkipMenu (bool skipMenu, bool newGame)
     mNewGame = newGame;
 }
 
+void OMW::Engine::setBenchmark (int frames, float fps, const std::string& path, const std::string& output)
+{
+    mBenchmarkFrames = frames;
+    mBenchmarkFps = fps;
+    mBenchmarkPath = path;
+    mBenchmarkOutput = output;
+}
+
 std::string OMW::Engine::loadSettings (Settings::Manager & settings)
 {
     // Create the settings manager and load default settings file
@@ -328,6 +355,13 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
     bool vsync = settings.getBool("vsync", "Video");
     int antialiasing = settings.getInt("antialiasing", "Video");
 
+    if (mBenchmarkFrames > 0)
+    {
+        // frames should not wait for the display
+        fullscreen = false;
+        vsync = false;
+    }
+
     int pos_x = SDL_WINDOWPOS_CENTERED_DISPLAY(screen),
         pos_y = SDL_WINDOWPOS_CENTERED_DISPLAY(screen);
 
@@ -337,7 +371,8 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
         pos_y = SDL_WINDOWPOS_UNDEFINED_DISPLAY(screen);
     }
 
-    Uint32 flags = SDL_WINDOW_OPENGL|SDL_WINDOW_SHOWN|SDL_WINDOW_RESIZABLE;
+    Uint32 flags = SDL_WINDOW_OPENGL|SDL_WINDOW_RESIZABLE;
+    flags |= mBenchmarkFrames > 0 ? SDL_WINDOW_HIDDEN : SDL_WINDOW_SHOWN;
     if(fullscreen)
         flags |= SDL_WINDOW_FULLSCREEN;
 
@@ -410,6 +445,10 @@ void OMW::Engine::createWindow(Settings::Manager& settings)
 
     mViewer->realize();
 
+    // realizing the graphics window shows it
+    if (mBenchmarkFrames > 0)
+        SDL_HideWindow(mWindow);
+
     mViewer->getEventQueue()->getCurrentEventState()->setWindowRectangle(0, 0, width, height);
 }
 
@@ -440,8 +479,13 @@ void OMW::Engine::setWindowIcon()
 
 void OMW::Engine::prepareEngine (Settings::Manager & settings)
 {
+    int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
+    if (numThreads <= 0)
+        throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
+    mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+
     mEnvironment.setStateManager (
-        new MWState::StateManager (mCfgMgr.getUserDataPath() / "saves", mContentFiles.at (0)));
+        new MWState::StateManager (mCfgMgr.getUserDataPath() / "saves", mContentFiles.at (0), mWorkQueue.get()));
 
     createWindow(settings);
 
@@ -461,10 +505,8 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         Settings::Manager::getInt("anisotropy", "General")
     );
 
-    int numThreads = Settings::Manager::getInt("preload num threads", "Cells");
-    if (numThreads <= 0)
-        throw std::runtime_error("Invalid setting: 'preload num threads' must be >0");
-    mWorkQueue = new SceneUtil::WorkQueue(numThreads);
+    if (Settings::Manager::getBool("model disk cache", "Cells"))
+        mResourceSystem->setDiskCacheDirectory(mCfgMgr.getCachePath().string());
 
     // Create input and UI first to set up a bootstrapping environment for
     // showing a loading screen and keeping the window responsive while doing so
@@ -540,7 +582,7 @@ void OMW::Engine::prepareEngine (Settings::Manager & settings)
         mScriptBlacklistUse ? mScriptBlacklist : std::vector<std::string>()));
 
     // Create game mechanics system
-    MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager;
+    MWMechanics::MechanicsManager* mechanics = new MWMechanics::MechanicsManager(mWorkQueue.get());
     mEnvironment.setMechanicsManager (mechanics);
 
     // Create dialog system
@@ -618,6 +660,46 @@ private:
     std::string mScreenshotFormat;
 };
 
+/// Writes the recent zones of the Misc::Profiler to a new file in the user data path, on a key press or when requested.
+class ProfilerTraceHandler : public osgGA::GUIEventHandler
+{
+public:
+    ProfilerTraceHandler(const std::string& tracePath)
+        : mTracePath(tracePath)
+    {
+    }
+
+    virtual bool handle(const osgGA::GUIEventAdapter& ea, osgGA::GUIActionAdapter& aa)
+    {
+        if (ea.getEventType() == osgGA::GUIEventAdapter::KEYDOWN && ea.getKey() == osgGA::GUIEventAdapter::KEY_F7
+                && Misc::Profiler::isEnabled())
+        {
+            writeTrace();
+            return true;
+        }
+        return false;
+    }
+
+    void writeTrace()
+    {
+        int traceCount = 0;
+        std::ostringstream stream;
+        do
+        {
+            stream.str("");
+            stream.clear();
+
+            stream << mTracePath << "/trace" << std::setw(3) << std::setfill('0') << traceCount++ << ".json";
+
+        } while (boost::filesystem::exists(stream.str()));
+
+        Misc::Profiler::writeChromeTrace(stream.str());
+    }
+
+private:
+    std::string mTracePath;
+};
+
 // Initialise and enter main loop.
 
 void OMW::Engine::go()
@@ -629,6 +711,17 @@ void OMW::Engine::go()
     mViewer = new osgViewer::Viewer;
     mViewer->setReleaseContextAtEndOfFrameHint(false);
 
+    if (mBenchmarkFrames > 0)
+    {
+        // keep the work of every frame on the main thread and the game independent of the time and the user
+        mViewer->setThreadingModel(osgViewer::ViewerBase::SingleThreaded);
+        Misc::Rng::init(0);
+        mUseSound = false;
+        mGrab = false;
+        if (mSaveGameFile.empty())
+            mSkipMenu = true;
+    }
+
     osg::ref_ptr<osgViewer::StatsHandler> statshandler = new osgViewer::StatsHandler;
     statshandler->setKeyEventTogglesOnScreenStats(osgGA::GUIEventAdapter::KEY_F3);
 
@@ -652,6 +745,12 @@ void OMW::Engine::go()
         Settings::Manager::getString("screenshot format", "General")));
     mViewer->addEventHandler(mScreenCaptureHandler);
 
+    Misc::Profiler::setThreadName("Main");
+    Misc::Profiler::setEnabled(Settings::Manager::getBool("profiler", "General"),
+        Settings::Manager::getFloat("profiler window", "General"));
+    osg::ref_ptr<ProfilerTraceHandler> profilerTraceHandler = new ProfilerTraceHandler(mCfgMgr.getUserDataPath().string());
+    mViewer->addEventHandler(profilerTraceHandler);
+
     // Create encoder
     ToUTF8::Utf8Encoder encoder (mEncoding);
     mEncoder = &encoder;
@@ -682,15 +781,30 @@ void OMW::Engine::go()
         mEnvironment.getStateManager()->newGame (!mNewGame);
     }
 
+    std::unique_ptr<Benchmark> benchmark;
+    if (mBenchmarkFrames > 0)
+    {
+        benchmark.reset(new Benchmark(mBenchmarkFrames, 1.f / mBenchmarkFps));
+        if (!mBenchmarkPath.empty())
+            benchmark->loadPath(mBenchmarkPath);
+    }
+
     // Start the main rendering loop
     osg::Timer frameTimer;
     double simulationTime = 0.0;
     float framerateLimit = Settings::Manager::getFloat("framerate limit", "Video");
     while (!mViewer->done() && !mEnvironment.getStateManager()->hasQuitRequest())
     {
+        if (benchmark && benchmark->isDone())
+            break;
+
+        Misc::ProfileZone frameZone("Frame");
+
         double dt = frameTimer.time_s();
         frameTimer.setStartTick();
         dt = std::min(dt, 0.2);
+        if (benchmark)
+            dt = benchmark->getTimeStep();
 
         bool guiActive = mEnvironment.getWindowManager()->isGuiMode();
         if (!guiActive)
@@ -698,18 +812,60 @@ void OMW::Engine::go()
 
         mViewer->advance(simulationTime);
 
-        frame(dt);
+        if (benchmark)
+            benchmark->applyPath();
+
+        osg::Timer_t beforeUpdateTick = osg::Timer::instance()->tick();
+        {
+            Misc::ProfileZone zone("Update");
+            frame(dt);
+        }
+        osg::Timer_t afterUpdateTick = osg::Timer::instance()->tick();
 
-        if (!mEnvironment.getInputManager()->isWindowVisible())
+        // the benchmark window is hidden, but still has to be drawn
+        if (!mEnvironment.getInputManager()->isWindowVisible() && !benchmark)
         {
             OpenThreads::Thread::microSleep(5000);
             continue;
         }
         else
         {
-            mViewer->eventTraversal();
-            mViewer->updateTraversal();
-            mViewer->renderingTraversals();
+            {
+                Misc::ProfileZone zone("Event traversal");
+                mViewer->eventTraversal();
+            }
+            osg::Timer_t afterEventTick = osg::Timer::instance()->tick();
+            {
+                Misc::ProfileZone zone("Update traversal");
+                mViewer->updateTraversal();
+            }
+            osg::Timer_t afterUpdateTraversalTick = osg::Timer::instance()->tick();
+            {
+                Misc::ProfileZone zone("Rendering traversals");
+                mViewer->renderingTraversals();
+            }
+            osg::Timer_t afterRenderingTick = osg::Timer::instance()->tick();
+
+            if (benchmark)
+            {
+                osg::Timer* timer = osg::Timer::instance();
+                osg::Stats* stats = mViewer->getViewerStats();
+                unsigned int frameNumber = mViewer->getFrameStamp()->getFrameNumber();
+                const char* parts[] = { "script", "mechanics", "physics" };
+                for (unsigned int i=0; i<sizeof(parts)/sizeof(parts[0]); ++i)
+                {
+                    double taken = 0.0;
+                    stats->getAttribute(frameNumber, std::string(parts[i]) + "_time_taken", taken);
+                    benchmark->addTiming(parts[i], taken);
+                }
+                benchmark->addTiming("update", timer->delta_s(beforeUpdateTick, afterUpdateTick));
+                benchmark->addTiming("event_traversal", timer->delta_s(afterUpdateTick, afterEventTick));
+                benchmark->addTiming("update_traversal", timer->delta_s(afterEventTick, afterUpdateTraversalTick));
+                benchmark->addTiming("rendering_traversals", timer->delta_s(afterUpdateTraversalTick, afterRenderingTick));
+                benchmark->addTiming("frame", timer->delta_s(frameTimer.getStartTick(), afterRenderingTick));
+                benchmark->endFrame();
+                continue;
+            }
         }
 
         if (framerateLimit > 0.f)
@@ -723,6 +879,12 @@ void OMW::Engine::go()
         }
     }
 
+    if (benchmark)
+        benchmark->writeResults(mBenchmarkOutput);
+
+    if (Misc::Profiler::isEnabled())
+        profilerTraceHandler->writeTrace();
+
     // Save user settings
     settings.saveUser(settingspath);
 
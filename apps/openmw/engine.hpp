@@ -110,6 +110,11 @@ namespace OMW
             bool mScriptBlacklistUse;
             bool mNewGame;
 
+            int mBenchmarkFrames;
+            float mBenchmarkFps;
+            std::string mBenchmarkPath;
+            std::string mBenchmarkOutput;
+
             osg::Timer_t mStartTick;
 
             // not implemented
@@ -168,6 +173,13 @@ namespace OMW
 
             void setGrabMouse(bool grab) { mGrab = grab; }
 
+            /// Run \a frames frames with a fixed time step in a hidden window, without sound, then write the
+            /// time taken by each part of every frame to \a output and quit.
+            ///
+            /// \param path Optional path for the player to follow, see Benchmark::loadPath.
+            /// \note Starts a new game in the start cell unless a save game is loaded.
+            void setBenchmark (int frames, float fps, const std::string& path, const std::string& output);
+
             /// Initialise and enter main loop.
             void go();
 
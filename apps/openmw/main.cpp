@@ -145,7 +145,19 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
         ("export-fonts", bpo::value<bool>()->implicit_value(true)
             ->default_value(false), "Export Morrowind .fnt fonts to PNG image and XML file in current directory")
 
-        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override");
+        ("activate-dist", bpo::value <int> ()->default_value (-1), "activation distance override")
+
+        ("benchmark", bpo::value<int>()->default_value(0),
+            "run the given number of frames in a hidden window with a fixed time step and no sound, "
+            "write the time taken by each part of every frame to the benchmark output, then quit")
+
+        ("benchmark-fps", bpo::value<float>()->default_value(60.f), "frames per simulated second in benchmark mode")
+
+        ("benchmark-path", bpo::value<Files::EscapeHashString>()->default_value(""),
+            "file with keyframes \"<time> <x> <y> <z> [<yaw> [<pitch>]]\" (seconds, degrees) for the player to follow in benchmark mode")
+
+        ("benchmark-output", bpo::value<Files::EscapeHashString>()->default_value("benchmark.csv"),
+            "file to write the benchmark timings to, as CSV or as JSON if the name ends in .json");
 
     bpo::parsed_options valid_opts = bpo::command_line_parser(argc, argv)
         .options(desc).allow_unregistered().run();
@@ -242,6 +254,9 @@ bool parseOptions (int argc, char** argv, OMW::Engine& engine, Files::Configurat
     engine.setFallbackValues(variables["fallback"].as<FallbackMap>().mMap);
     engine.setActivationDistanceOverride (variables["activate-dist"].as<int>());
     engine.enableFontExport(variables["export-fonts"].as<bool>());
+    engine.setBenchmark(variables["benchmark"].as<int>(), variables["benchmark-fps"].as<float>(),
+        variables["benchmark-path"].as<Files::EscapeHashString>().toStdString(),
+        variables["benchmark-output"].as<Files::EscapeHashString>().toStdString());
 
     return true;
 }
@@ -10,6 +10,7 @@
 namespace osg
 {
     class Vec3f;
+    class Stats;
 }
 
 namespace ESM
@@ -32,6 +33,11 @@ namespace Loading
     class Listener;
 }
 
+namespace MWMechanics
+{
+    class PathfindingQueue;
+}
+
 namespace MWBase
 {
     /// \brief Interface for game mechanics manager (implemented in MWMechanics)
@@ -241,6 +247,11 @@ namespace MWBase
             virtual void applyWerewolfAcrobatics(const MWWorld::Ptr& actor) = 0;
 
             virtual void cleanupSummonedCreature(const MWWorld::Ptr& caster, int creatureActorId) = 0;
+
+            /// @return The queue servicing the path searches of AI packages.
+            virtual MWMechanics::PathfindingQueue* getPathfindingQueue() = 0;
+
+            virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const = 0;
     };
 }
 
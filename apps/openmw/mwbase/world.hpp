@@ -62,6 +62,7 @@ namespace MWWorld
     class TimeStamp;
     class ESMStore;
     class RefData;
+    struct SavedCells;
 
     typedef std::vector<std::pair<MWWorld::Ptr,MWMechanics::Movement> > PtrMovementList;
 }
@@ -103,14 +104,20 @@ namespace MWBase
             virtual int countSavedGameRecords() const = 0;
             virtual int countSavedGameCells() const = 0;
 
-            virtual void write (ESM::ESMWriter& writer, Loading::Listener& listener) const = 0;
+            virtual void write (ESM::ESMWriter& writer, Loading::Listener& listener, MWWorld::SavedCells* cells = NULL) const = 0;
+            ///< \param cells If not NULL, the cells are only captured into \a cells instead of being written, along with
+            /// the position in the stream of \a writer where their records belong.
 
             virtual void readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap) = 0;
 
-            virtual MWWorld::CellStore *getExterior (int x, int y) = 0;
+            virtual MWWorld::CellStore *getExterior (int x, int y, bool load = true) = 0;
+            ///< \param load Load the references of the cell. If false, the cell may be in any state,
+            /// see MWWorld::CellStore::getState.
 
-            virtual MWWorld::CellStore *getInterior (const std::string& name) = 0;
+            virtual MWWorld::CellStore *getInterior (const std::string& name, bool load = true) = 0;
+            ///< \param load Load the references of the cell. If false, the cell may be in any state,
+            /// see MWWorld::CellStore::getState.
 
             virtual MWWorld::CellStore *getCell (const ESM::CellId& id) = 0;
 
@@ -21,6 +21,8 @@
 #include <components/interpreter/interpreter.hpp>
 #include <components/interpreter/defines.hpp>
 
+#include <components/misc/profiler.hpp>
+
 #include "../mwbase/environment.hpp"
 #include "../mwbase/world.hpp"
 #include "../mwbase/journal.hpp"
@@ -68,6 +70,7 @@ namespace MWDialogue
         for (; it != dialogs.end(); ++it)
         {
             mDialogueMap[Misc::StringUtils::lowerCase(it->mId)] = *it;
+            mInfoIndex.add(*it);
         }
     }
 
@@ -114,6 +117,8 @@ namespace MWDialogue
 
     void DialogueManager::startDialogue (const MWWorld::Ptr& actor)
     {
+        Misc::ProfileZone zone("Start dialogue");
+
         updateGlobals();
 
         // Dialogue with dead actor (e.g. through script) should not be allowed.
@@ -145,7 +150,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (actor, mChoice, mTalkedTo);
+        Filter filter (actor, mChoice, mTalkedTo, &mInfoIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator it = dialogs.begin(); it != dialogs.end(); ++it)
         {
@@ -267,7 +272,7 @@ namespace MWDialogue
 
     void DialogueManager::executeTopic (const std::string& topic)
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -335,6 +340,8 @@ namespace MWDialogue
 
     void DialogueManager::updateTopics()
     {
+        Misc::ProfileZone zone("Update dialogue topics");
+
         updateGlobals();
 
         std::list<std::string> keywordList;
@@ -345,7 +352,7 @@ namespace MWDialogue
         const MWWorld::Store<ESM::Dialogue> &dialogs =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
 
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
         for (MWWorld::Store<ESM::Dialogue>::iterator iter = dialogs.begin(); iter != dialogs.end(); ++iter)
         {
@@ -471,7 +478,7 @@ namespace MWDialogue
 
         if (mDialogueMap.find(mLastTopic) != mDialogueMap.end())
         {
-            Filter filter (mActor, mChoice, mTalkedTo);
+            Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
             if (mDialogueMap[mLastTopic].mType == ESM::Dialogue::Topic
                     || mDialogueMap[mLastTopic].mType == ESM::Dialogue::Greeting)
@@ -595,7 +602,7 @@ namespace MWDialogue
 
     bool DialogueManager::checkServiceRefused()
     {
-        Filter filter (mActor, mChoice, mTalkedTo);
+        Filter filter (mActor, mChoice, mTalkedTo, &mInfoIndex);
 
         const MWWorld::Store<ESM::Dialogue> &dialogues =
             MWBase::Environment::get().getWorld()->getStore().get<ESM::Dialogue>();
@@ -643,7 +650,7 @@ namespace MWDialogue
         const ESM::Dialogue *dial = store.get<ESM::Dialogue>().find(topic);
 
         const MWMechanics::CreatureStats& creatureStats = actor.getClass().getCreatureStats(actor);
-        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer());
+        Filter filter(actor, 0, creatureStats.hasTalkedToPlayer(), &mInfoIndex);
         const ESM::DialInfo *info = filter.search(*dial, false);
         if(info != NULL)
         {
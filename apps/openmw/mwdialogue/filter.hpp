@@ -14,12 +14,19 @@ namespace ESM
 namespace MWDialogue
 {
     class SelectWrapper;
+    class InfoIndex;
 
     class Filter
     {
             MWWorld::Ptr mActor;
             int mChoice;
             bool mTalkedToPlayer;
+            const InfoIndex* mIndex;
+            std::string mPlayerCellName;
+
+            std::vector<const ESM::DialInfo *> getInfos (const ESM::Dialogue& dialogue, bool anyCell) const;
+            ///< @return The infos of \a dialogue that need to be tested, in their original order.
+            /// @param anyCell Include infos for cells other than the player's.
 
             bool testActor (const ESM::DialInfo& info) const;
             ///< Is this the right actor for this \a info?
@@ -53,7 +60,8 @@ namespace MWDialogue
 
         public:
 
-            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer);
+            Filter (const MWWorld::Ptr& actor, int choice, bool talkedToPlayer, const InfoIndex* index = NULL);
+            ///< @param index Used to skip infos that can not apply to \a actor. Optional.
 
             std::vector<const ESM::DialInfo *> list (const ESM::Dialogue& dialogue,
                 bool fallbackToInfoRefusal, bool searchAll, bool invertDisposition=false) const;
@@ -0,0 +1,111 @@
+#include "infoindex.hpp"
+
+#include <algorithm>
+#include <typeinfo>
+
+#include <components/esm/loaddial.hpp>
+#include <components/esm/loadinfo.hpp>
+#include <components/esm/loadnpc.hpp>
+#include <components/misc/stringops.hpp>
+
+#include "../mwworld/class.hpp"
+
+namespace
+{
+    void append (std::vector<std::pair<size_t, const ESM::DialInfo*> >& infos,
+        const std::unordered_map<std::string, std::vector<std::pair<size_t, const ESM::DialInfo*> > >& buckets,
+        const std::string& key)
+    {
+        if (key.empty())
+            return;
+
+        std::unordered_map<std::string, std::vector<std::pair<size_t, const ESM::DialInfo*> > >::const_iterator found =
+            buckets.find (Misc::StringUtils::lowerCase (key));
+        if (found != buckets.end())
+            infos.insert (infos.end(), found->second.begin(), found->second.end());
+    }
+}
+
+namespace MWDialogue
+{
+    void InfoIndex::add (const ESM::Dialogue& dialogue)
+    {
+        getIndex (dialogue);
+    }
+
+    std::vector<const ESM::DialInfo*> InfoIndex::getCandidates (const ESM::Dialogue& dialogue, const MWWorld::Ptr& actor,
+        const std::string* cellName) const
+    {
+        const DialogueIndex& index = getIndex (dialogue);
+
+        InfoList infos;
+        append (infos, index.mActors, actor.getCellRef().getRefId());
+
+        // creatures only have topics specific to their ID
+        if (actor.getTypeName() == typeid (ESM::NPC).name())
+        {
+            const ESM::NPC* npc = actor.get<ESM::NPC>()->mBase;
+            append (infos, index.mRaces, npc->mRace);
+            append (infos, index.mClasses, npc->mClass);
+            append (infos, index.mFactions, actor.getClass().getPrimaryFaction (actor));
+
+            if (cellName)
+            {
+                // supports partial matches, just like getPcCell
+                std::string lowerCellName = Misc::StringUtils::lowerCase (*cellName);
+                for (Buckets::const_iterator it = index.mCells.begin(); it != index.mCells.end(); ++it)
+                    if (lowerCellName.compare (0, it->first.size(), it->first) == 0)
+                        infos.insert (infos.end(), it->second.begin(), it->second.end());
+            }
+            else
+            {
+                for (Buckets::const_iterator it = index.mCells.begin(); it != index.mCells.end(); ++it)
+                    infos.insert (infos.end(), it->second.begin(), it->second.end());
+            }
+
+            infos.insert (infos.end(), index.mOther.begin(), index.mOther.end());
+        }
+
+        std::sort (infos.begin(), infos.end());
+
+        std::vector<const ESM::DialInfo*> result;
+        result.reserve (infos.size());
+        for (InfoList::const_iterator it = infos.begin(); it != infos.end(); ++it)
+            result.push_back (it->second);
+        return result;
+    }
+
+    const InfoIndex::DialogueIndex& InfoIndex::getIndex (const ESM::Dialogue& dialogue) const
+    {
+        std::map<const ESM::Dialogue*, DialogueIndex>::iterator found = mDialogues.find (&dialogue);
+        if (found != mDialogues.end())
+            return found->second;
+
+        DialogueIndex& index = mDialogues[&dialogue];
+
+        size_t i = 0;
+        for (ESM::Dialogue::InfoContainer::const_iterator iter = dialogue.mInfo.begin();
+            iter != dialogue.mInfo.end(); ++iter, ++i)
+        {
+            const ESM::DialInfo& info = *iter;
+            std::pair<size_t, const ESM::DialInfo*> entry (i, &info);
+
+            // Each info goes to one bucket. An actor can only match the infos in the buckets of its own
+            // actor ID, race, class and faction, and in the buckets of cells that the player's cell starts with.
+            if (!info.mActor.empty())
+                index.mActors[Misc::StringUtils::lowerCase (info.mActor)].push_back (entry);
+            else if (!info.mRace.empty())
+                index.mRaces[Misc::StringUtils::lowerCase (info.mRace)].push_back (entry);
+            else if (!info.mClass.empty())
+                index.mClasses[Misc::StringUtils::lowerCase (info.mClass)].push_back (entry);
+            else if (!info.mFactionLess && !info.mFaction.empty())
+                index.mFactions[Misc::StringUtils::lowerCase (info.mFaction)].push_back (entry);
+            else if (!info.mCell.empty())
+                index.mCells[Misc::StringUtils::lowerCase (info.mCell)].push_back (entry);
+            else
+                index.mOther.push_back (entry);
+        }
+
+        return index;
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef GAME_MWDIALOGUE_INFOINDEX_H
+#define GAME_MWDIALOGUE_INFOINDEX_H
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../mwworld/ptr.hpp"
+
+namespace ESM
+{
+    struct DialInfo;
+    struct Dialogue;
+}
+
+namespace MWDialogue
+{
+    /// \brief Groups the infos of each dialogue by their most selective speaker condition
+    /// (actor, race, class, faction or cell), so that Filter only needs to test the infos that can apply to an actor.
+    class InfoIndex
+    {
+        public:
+
+            void add (const ESM::Dialogue& dialogue);
+            ///< Index \a dialogue now, rather than on its first use.
+
+            std::vector<const ESM::DialInfo*> getCandidates (const ESM::Dialogue& dialogue, const MWWorld::Ptr& actor,
+                const std::string* cellName) const;
+            ///< @return The infos of \a dialogue that may apply to \a actor, in their original order.
+            /// All conditions of the result still need to be tested.
+            /// @param cellName Name of the cell the player is in, or NULL to include the infos for any cell.
+
+        private:
+
+            typedef std::vector<std::pair<size_t, const ESM::DialInfo*> > InfoList;
+            typedef std::unordered_map<std::string, InfoList> Buckets;
+
+            struct DialogueIndex
+            {
+                Buckets mActors;
+                Buckets mRaces;
+                Buckets mClasses;
+                Buckets mFactions;
+                Buckets mCells;
+                InfoList mOther;
+            };
+
+            const DialogueIndex& getIndex (const ESM::Dialogue& dialogue) const;
+
+            // Dialogues are copied by the DialogueManager, so the copies get their own entries
+            mutable std::map<const ESM::Dialogue*, DialogueIndex> mDialogues;
+    };
+}
+
+#endif
@@ -1,11 +1,11 @@
 #ifndef GAME_MWDIALOGUE_KEYWORDSEARCH_H
 #define GAME_MWDIALOGUE_KEYWORDSEARCH_H
 
-#include <map>
 #include <cctype>
 #include <stdexcept>
+#include <utility>
 #include <vector>
-#include <algorithm>    // std::reverse
+#include <algorithm>
 
 #include <components/misc/stringops.hpp>
 
@@ -26,46 +26,74 @@ public:
         value_t mValue;
     };
 
+    KeywordSearch ()
+        : mCompiled (false)
+    {
+        clear ();
+    }
+
     void seed (string_t keyword, value_t value)
     {
         if (keyword.empty())
             return;
-        seed_impl  (/*std::move*/ (keyword), /*std::move*/ (value), 0, mRoot);
+
+        size_t node = 0;
+        for (Point i = keyword.begin(); i != keyword.end(); ++i)
+        {
+            CharType ch = Misc::StringUtils::toLower (*i);
+            typename Node::Children& children = mNodes[node].mChildren;
+            typename Node::Children::iterator child = std::lower_bound (children.begin(), children.end(),
+                std::make_pair (ch, size_t(0)));
+            if (child != children.end() && child->first == ch)
+                node = child->second;
+            else
+            {
+                size_t depth = mNodes[node].mDepth + 1;
+                children.insert (child, std::make_pair (ch, mNodes.size()));
+                node = mNodes.size();
+                mNodes.push_back (Node (depth));
+            }
+        }
+
+        if (mNodes[node].mKeyword != sNone)
+        {
+            if (mKeywords[mNodes[node].mKeyword].first == keyword)
+                throw std::runtime_error ("duplicate keyword inserted");
+            return; // the first of several spellings of a keyword wins
+        }
+
+        mNodes[node].mKeyword = mKeywords.size();
+        mKeywords.push_back (std::make_pair (/*std::move*/ (keyword), /*std::move*/ (value)));
+        mCompiled = false;
     }
 
     void clear ()
     {
-        mRoot.mChildren.clear ();
-        mRoot.mKeyword.clear ();
+        mNodes.clear ();
+        mNodes.push_back (Node (0));
+        mKeywords.clear ();
+        mCompiled = false;
     }
 
     bool containsKeyword (string_t keyword, value_t& value)
     {
-        typename Entry::childen_t::iterator current;
-        typename Entry::childen_t::iterator next;
-
-        current = mRoot.mChildren.find (Misc::StringUtils::toLower (*keyword.begin()));
-        if (current == mRoot.mChildren.end())
-            return false;
-        else if (current->second.mKeyword.size() && Misc::StringUtils::ciEqual(current->second.mKeyword, keyword))
-        {
-            value = current->second.mValue;
-            return true;
-        }
-
-        for (Point i = ++keyword.begin(); i != keyword.end(); ++i)
+        size_t node = 0;
+        for (Point i = keyword.begin(); i != keyword.end(); ++i)
         {
-            next = current->second.mChildren.find(Misc::StringUtils::toLower (*i));
-            if (next == current->second.mChildren.end())
+            const typename Node::Children& children = mNodes[node].mChildren;
+            CharType ch = Misc::StringUtils::toLower (*i);
+            typename Node::Children::const_iterator child = std::lower_bound (children.begin(), children.end(),
+                std::make_pair (ch, size_t(0)));
+            if (child == children.end() || child->first != ch)
                 return false;
-            if (Misc::StringUtils::ciEqual(next->second.mKeyword, keyword))
-            {
-                value = next->second.mValue;
-                return true;
-            }
-            current = next;
+            node = child->second;
         }
-        return false;
+
+        if (mNodes[node].mKeyword == sNone)
+            return false;
+
+        value = mKeywords[mNodes[node].mKeyword].second;
+        return true;
     }
 
     static bool sortMatches(const Match& left, const Match& right)
@@ -75,86 +103,50 @@ public:
 
     void highlightKeywords (Point beg, Point end, std::vector<Match>& out)
     {
-        std::vector<Match> matches;
+        compile ();
+
+        // Single pass of the automaton over the text. Keywords are reported where they end, keep the longest
+        // keyword for each start of a word. Keywords may end within a word.
+        std::vector<size_t> longest (end - beg, sNone);
+        size_t state = 0;
         for (Point i = beg; i != end; ++i)
         {
-            // check if previous character marked start of new word
-            if (i != beg)
+            CharType ch = Misc::StringUtils::toLower (*i);
+            size_t next = findTransition (state, ch);
+            while (next == sNone && state != 0)
             {
-                Point prev = i;
-                --prev;
-                if(isalpha(*prev))
-                    continue;
+                state = mFailure[state];
+                next = findTransition (state, ch);
             }
+            state = next == sNone ? 0 : next;
 
-
-            // check first character
-            typename Entry::childen_t::iterator candidate = mRoot.mChildren.find (Misc::StringUtils::toLower (*i));
-
-            // no match, on to next character
-            if (candidate == mRoot.mChildren.end ())
-                continue;
-
-            // see how far the match goes
-            Point j = i;
-
-            // some keywords might be longer variations of other keywords, so we definitely need a list of candidates
-            // the first element in the pair is length of the match, i.e. depth from the first character on
-            std::vector< typename std::pair<int, typename Entry::childen_t::iterator> > candidates;
-
-            while ((j + 1) != end)
+            for (size_t found = mOutput[state]; found != sNone; found = mOutput[mFailure[found]])
             {
-                typename Entry::childen_t::iterator next = candidate->second.mChildren.find (Misc::StringUtils::toLower (*++j));
+                size_t size = mNodes[found].mDepth;
+                size_t first = (i - beg) + 1 - size;
 
-                if (next == candidate->second.mChildren.end ())
-                {
-                    if (candidate->second.mKeyword.size() > 0)
-                        candidates.push_back(std::make_pair((j-i), candidate));
-                    break;
-                }
-
-                candidate = next;
+                // check if previous character marked start of new word
+                if (first != 0 && isalpha(*(beg + (first - 1))))
+                    continue;
 
-                if (candidate->second.mKeyword.size() > 0)
-                    candidates.push_back(std::make_pair((j-i), candidate));
+                if (longest[first] == sNone || mNodes[longest[first]].mDepth < size)
+                    longest[first] = found;
             }
+        }
 
-            if (candidates.empty())
-                continue; // didn't match enough to disambiguate, on to next character
-
-            // shorter candidates will be added to the vector first. however, we want to check against longer candidates first
-            std::reverse(candidates.begin(), candidates.end());
-
-            for (typename std::vector< std::pair<int, typename Entry::childen_t::iterator> >::iterator it = candidates.begin();
-                 it != candidates.end(); ++it)
-            {
-                candidate = it->second;
-                // try to match the rest of the keyword
-                Point k = i + it->first;
-                typename string_t::const_iterator t = candidate->second.mKeyword.begin () + (k - i);
-
-
-                while (k != end && t != candidate->second.mKeyword.end ())
-                {
-                    if (Misc::StringUtils::toLower (*k) != Misc::StringUtils::toLower (*t))
-                        break;
-
-                    ++k, ++t;
-                }
-
-                // didn't match full keyword, try the next candidate
-                if (t != candidate->second.mKeyword.end ())
-                    continue;
+        // matches are ordered by their start, longer keywords that start within a match are resolved below
+        std::vector<Match> matches;
+        for (size_t first = 0; first < longest.size(); ++first)
+        {
+            if (longest[first] == sNone)
+                continue;
 
-                // found a keyword, but there might still be longer keywords that start somewhere _within_ this keyword
-                // we will resolve these overlapping keywords later, choosing the longest one in case of conflict
-                Match match;
-                match.mValue = candidate->second.mValue;
-                match.mBeg = i;
-                match.mEnd = k;
-                matches.push_back(match);
-                break;
-            }
+            const Node& node = mNodes[longest[first]];
+            Match match;
+            match.mValue = mKeywords[node.mKeyword].second;
+            match.mBeg = beg + first;
+            match.mEnd = match.mBeg + node.mDepth;
+            matches.push_back(match);
         }
 
         // resolve overlapping keywords
@@ -201,56 +193,107 @@ public:
 
 private:
 
-    struct Entry
+    typedef typename string_t::value_type CharType;
+
+    static const size_t sNone = static_cast<size_t>(-1);
+
+    // Trie of the lower case keywords, extended by seed()
+    struct Node
     {
-        typedef std::map <wchar_t, Entry> childen_t;
+        typedef std::vector<std::pair<CharType, size_t> > Children;
 
-        string_t mKeyword;
-        value_t mValue;
-        childen_t mChildren;
+        explicit Node (size_t depth) : mDepth (depth), mKeyword (sNone) {}
+
+        Children mChildren; // sorted by character
+        size_t mDepth;
+        size_t mKeyword; // index into mKeywords, or sNone
     };
 
-    void seed_impl (string_t keyword, value_t value, size_t depth, Entry  & entry)
+    /// Compile the trie into an Aho-Corasick automaton with flat transition tables, if it changed since the last search.
+    /// The cost is linear in the total length of the keywords.
+    void compile ()
     {
-        int ch = Misc::StringUtils::toLower (keyword.at (depth));
+        if (mCompiled)
+            return;
 
-        typename Entry::childen_t::iterator j = entry.mChildren.find (ch);
+        size_t numNodes = mNodes.size();
 
-        if (j == entry.mChildren.end ())
+        mEdgeOffsets.assign (numNodes + 1, 0);
+        mEdgeChars.clear ();
+        mEdgeTargets.clear ();
+        for (size_t node = 0; node < numNodes; ++node)
         {
-            entry.mChildren [ch].mValue = /*std::move*/ (value);
-            entry.mChildren [ch].mKeyword = /*std::move*/ (keyword);
+            mEdgeOffsets[node] = mEdgeChars.size();
+            const typename Node::Children& children = mNodes[node].mChildren;
+            for (typename Node::Children::const_iterator it = children.begin(); it != children.end(); ++it)
+            {
+                mEdgeChars.push_back (it->first);
+                mEdgeTargets.push_back (it->second);
+            }
         }
-        else
+        mEdgeOffsets[numNodes] = mEdgeChars.size();
+
+        // breadth first, so that failure links always point to finished nodes
+        mFailure.assign (numNodes, 0);
+        mOutput.assign (numNodes, sNone);
+        std::vector<size_t> queue;
+        queue.reserve (numNodes);
+        queue.push_back (0);
+        for (size_t index = 0; index < queue.size(); ++index)
         {
-            if (j->second.mKeyword.size () > 0)
-            {
-                if (keyword == j->second.mKeyword)
-                    throw std::runtime_error ("duplicate keyword inserted");
+            size_t node = queue[index];
 
-                value_t pushValue = /*std::move*/ (j->second.mValue);
-                string_t pushKeyword = /*std::move*/ (j->second.mKeyword);
+            if (mNodes[node].mKeyword != sNone)
+                mOutput[node] = node;
+            else if (node != 0)
+                mOutput[node] = mOutput[mFailure[node]];
 
-                if (depth >= pushKeyword.size ())
-                    throw std::runtime_error ("unexpected");
-
-                if (depth+1 < pushKeyword.size())
+            for (size_t edge = mEdgeOffsets[node]; edge < mEdgeOffsets[node+1]; ++edge)
+            {
+                size_t child = mEdgeTargets[edge];
+                if (node != 0)
                 {
-                    seed_impl (/*std::move*/ (pushKeyword), /*std::move*/ (pushValue), depth+1, j->second);
-                    j->second.mKeyword.clear ();
+                    size_t failure = mFailure[node];
+                    size_t next = findTransition (failure, mEdgeChars[edge]);
+                    while (next == sNone && failure != 0)
+                    {
+                        failure = mFailure[failure];
+                        next = findTransition (failure, mEdgeChars[edge]);
+                    }
+                    mFailure[child] = next == sNone ? 0 : next;
                 }
+                queue.push_back (child);
             }
-            if (depth+1 == keyword.size())
-                j->second.mKeyword = value;
-            else // depth+1 < keyword.size()
-                seed_impl (/*std::move*/ (keyword), /*std::move*/ (value), depth+1, j->second);
         }
 
+        mCompiled = true;
+    }
+
+    size_t findTransition (size_t node, CharType ch) const
+    {
+        typename std::vector<CharType>::const_iterator first = mEdgeChars.begin() + mEdgeOffsets[node];
+        typename std::vector<CharType>::const_iterator last = mEdgeChars.begin() + mEdgeOffsets[node+1];
+        typename std::vector<CharType>::const_iterator found = std::lower_bound (first, last, ch);
+        if (found == last || *found != ch)
+            return sNone;
+        return mEdgeTargets[found - mEdgeChars.begin()];
     }
 
-    Entry mRoot;
+    std::vector<Node> mNodes;
+    std::vector<std::pair<string_t, value_t> > mKeywords;
+
+    // the compiled automaton
+    bool mCompiled;
+    std::vector<size_t> mEdgeOffsets; // per node, into mEdgeChars and mEdgeTargets
+    std::vector<CharType> mEdgeChars;
+    std::vector<size_t> mEdgeTargets;
+    std::vector<size_t> mFailure;
+    std::vector<size_t> mOutput; // per node, the deepest node along the failure links that ends a keyword, or sNone
 };
 
+template <typename string_t, typename value_t>
+const size_t KeywordSearch<string_t, value_t>::sNone;
+
 }
 
 #endif
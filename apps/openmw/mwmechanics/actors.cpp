@@ -10,6 +10,7 @@
 #include <components/sceneutil/positionattitudetransform.hpp>
 
 #include <components/settings/settings.hpp>
+#include <components/misc/profiler.hpp>
 
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/class.hpp"
@@ -1068,6 +1069,8 @@ namespace MWMechanics
 
     void Actors::update (float duration, bool paused)
     {
+        Misc::ProfileZone zone("Actors");
+
         if(!paused)
         {
             static float timerUpdateAITargets = 0;
@@ -90,6 +90,9 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const ESM::Pathgr
         return false;
     }
 
+    // pick up the result of a path search that was deferred to a worker thread
+    mPathFinder.updatePendingPath();
+
     // handle path building and shortcutting
     ESM::Pathgrid::Point start = pos.pos;
 
@@ -107,7 +110,7 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const ESM::Pathgr
         {
             if (wasShortcutting || doesPathNeedRecalc(dest, actor.getCell())) // if need to rebuild path
             {
-                mPathFinder.buildSyncedPath(start, dest, actor.getCell());
+                mPathFinder.buildSyncedPathAsync(start, dest, actor.getCell());
                 mRotateOnTheRunChecks = 3;
 
                 // give priority to go directly on target if there is minimal opportunity
@@ -139,7 +142,15 @@ bool MWMechanics::AiPackage::pathTo(const MWWorld::Ptr& actor, const ESM::Pathgr
         mTimer = 0;
     }
 
-    if (isDestReached || mPathFinder.checkPathCompleted(pos.pos[0], pos.pos[1])) // if path is finished
+    bool isPathCompleted = isDestReached || mPathFinder.checkPathCompleted(pos.pos[0], pos.pos[1]);
+    if (isPathCompleted && !isDestReached && mPathFinder.isPathPending())
+    {
+        // no path to follow until the search on the pathfinding queue has finished, wait in place
+        actor.getClass().getMovementSettings(actor).mPosition[1] = 0;
+        return false;
+    }
+
+    if (isPathCompleted) // if path is finished
     {
         // turn to destination point
         zTurn(actor, getZAngleToPoint(start, dest));
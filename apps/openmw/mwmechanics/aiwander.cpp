@@ -113,7 +113,8 @@ namespace MWMechanics
     
     AiWander::AiWander(int distance, int duration, int timeOfDay, const std::vector<unsigned char>& idle, bool repeat):
         mDistance(distance), mDuration(duration), mRemainingDuration(duration), mTimeOfDay(timeOfDay), mIdle(idle),
-        mRepeat(repeat), mStoredInitialActorPosition(false), mInitialActorPosition(osg::Vec3f(0, 0, 0)), mHasDestination(false), mDestination(osg::Vec3f(0, 0, 0))
+        mRepeat(repeat), mStoredInitialActorPosition(false), mInitialActorPosition(osg::Vec3f(0, 0, 0)), mHasDestination(false), mDestination(osg::Vec3f(0, 0, 0)),
+        mPendingPathAction(PendingPath_None)
     {
         mIdle.resize(8, 0);
         init();
@@ -209,16 +210,28 @@ namespace MWMechanics
 
         ESM::Position pos = actor.getRefData().getPosition();
 
+        // Pick up the result of a path search that is running on the pathfinding queue
+        bool pathArrived = mPathFinder.updatePendingPath();
+        if (!mPathFinder.isPathPending())
+        {
+            PendingPathAction action = mPendingPathAction;
+            mPendingPathAction = PendingPath_None;
+            if (pathArrived)
+                onPendingPathArrived(storage, action);
+        }
+
         // If there is already a destination due to the package having been interrupted by a combat or pursue package,
         // rebuild a path to it
-        if (!mPathFinder.isPathConstructed() && mHasDestination)
+        if (!mPathFinder.isPathConstructed() && !mPathFinder.isPathPending() && mHasDestination)
         {
             ESM::Pathgrid::Point dest(PathFinder::MakePathgridPoint(mDestination));
             ESM::Pathgrid::Point start(PathFinder::MakePathgridPoint(pos));
 
-            mPathFinder.buildSyncedPath(start, dest, actor.getCell());
+            mPathFinder.buildSyncedPathAsync(start, dest, actor.getCell());
 
-            if (mPathFinder.isPathConstructed())
+            if (mPathFinder.isPathPending())
+                mPendingPathAction = PendingPath_Walk;
+            else if (mPathFinder.isPathConstructed())
                 storage.setState(Wander_Walking);
         }
         
@@ -265,7 +278,7 @@ namespace MWMechanics
 
         // If the package has a wander distance but no pathgrid is available,
         // randomly idle or wander near spawn point
-        if(storage.mAllowedNodes.empty() && mDistance > 0 && !storage.mIsWanderingManually) {
+        if(storage.mAllowedNodes.empty() && mDistance > 0 && !storage.mIsWanderingManually && !mPathFinder.isPathPending()) {
             // Typically want to idle for a short time before the next wander
             if (Misc::Rng::rollDice(100) >= 96) {
                 wanderNearStart(actor, storage, mDistance);
@@ -301,8 +314,8 @@ namespace MWMechanics
 
         if ((wanderState == Wander_MoveNow) && storage.mCanWanderAlongPathGrid)
         {
-            // Construct a new path if there isn't one
-            if(!mPathFinder.isPathConstructed())
+            // Construct a new path if there isn't one and none is being searched for
+            if(!mPathFinder.isPathConstructed() && !mPathFinder.isPathPending())
             {
                 if (!storage.mAllowedNodes.empty())
                 {
@@ -339,7 +352,7 @@ namespace MWMechanics
 
     void AiWander::returnToStartLocation(const MWWorld::Ptr& actor, AiWanderStorage& storage, ESM::Position& pos)
     {
-        if (!mPathFinder.isPathConstructed())
+        if (!mPathFinder.isPathConstructed() && !mPathFinder.isPathPending())
         {
             mDestination = mInitialActorPosition;
             ESM::Pathgrid::Point dest(PathFinder::MakePathgridPoint(mDestination));
@@ -348,9 +361,11 @@ namespace MWMechanics
             ESM::Pathgrid::Point start(PathFinder::MakePathgridPoint(pos));
 
             // don't take shortcuts for wandering
-            mPathFinder.buildSyncedPath(start, dest, actor.getCell());
+            mPathFinder.buildSyncedPathAsync(start, dest, actor.getCell());
 
-            if (mPathFinder.isPathConstructed())
+            if (mPathFinder.isPathPending())
+                mPendingPathAction = PendingPath_Walk;
+            else if (mPathFinder.isPathConstructed())
             {
                 storage.setState(Wander_Walking);
                 mHasDestination = true;
@@ -382,7 +397,13 @@ namespace MWMechanics
             // Check if land creature will walk onto water or if water creature will swim onto land
             if ((!isWaterCreature && !destinationIsAtWater(actor, mDestination)) ||
                 (isWaterCreature && !destinationThroughGround(currentPositionVec3f, mDestination))) {
-                mPathFinder.buildSyncedPath(currentPosition, destinationPosition, actor.getCell());
+                mPathFinder.buildSyncedPathAsync(currentPosition, destinationPosition, actor.getCell());
+                if (mPathFinder.isPathPending())
+                {
+                    // the destination is appended once the search has finished
+                    mPendingPathAction = PendingPath_WalkManually;
+                    return;
+                }
                 mPathFinder.addPointToPath(destinationPosition);
 
                 if (mPathFinder.isPathConstructed())
@@ -662,15 +683,27 @@ namespace MWMechanics
         ESM::Pathgrid::Point start(PathFinder::MakePathgridPoint(actorPos));
 
         // don't take shortcuts for wandering
-        mPathFinder.buildSyncedPath(start, dest, actor.getCell());
+        mPathFinder.buildSyncedPathAsync(start, dest, actor.getCell());
 
+        if (mPathFinder.isPathPending())
+        {
+            mPendingPathAction = PendingPath_WalkToNode;
+            mPendingNode = storage.mAllowedNodes[randNode];
+            mDestination = osg::Vec3f(dest.mX, dest.mY, dest.mZ);
+        }
+        else
+            onPathToNodeFinished(storage, randNode, dest);
+    }
+
+    void AiWander::onPathToNodeFinished(AiWanderStorage& storage, unsigned int node, const ESM::Pathgrid::Point& dest)
+    {
         if (mPathFinder.isPathConstructed())
         {
             mDestination = osg::Vec3f(dest.mX, dest.mY, dest.mZ);
             mHasDestination = true;
             // Remove this node as an option and add back the previously used node (stops NPC from picking the same node):
-            ESM::Pathgrid::Point temp = storage.mAllowedNodes[randNode];
-            storage.mAllowedNodes.erase(storage.mAllowedNodes.begin() + randNode);
+            ESM::Pathgrid::Point temp = storage.mAllowedNodes[node];
+            storage.mAllowedNodes.erase(storage.mAllowedNodes.begin() + node);
             // check if mCurrentNode was taken out of mAllowedNodes
             if (storage.mTrimCurrentNode && storage.mAllowedNodes.size() > 1)
                 storage.mTrimCurrentNode = false;
@@ -682,7 +715,47 @@ namespace MWMechanics
         }
         // Choose a different node and delete this one from possible nodes because it is uncreachable:
         else
-            storage.mAllowedNodes.erase(storage.mAllowedNodes.begin() + randNode);
+            storage.mAllowedNodes.erase(storage.mAllowedNodes.begin() + node);
+    }
+
+    void AiWander::onPendingPathArrived(AiWanderStorage& storage, PendingPathAction action)
+    {
+        switch (action)
+        {
+            case PendingPath_Walk:
+                if (mPathFinder.isPathConstructed())
+                {
+                    storage.setState(Wander_Walking);
+                    mHasDestination = true;
+                }
+                break;
+            case PendingPath_WalkManually:
+                mPathFinder.addPointToPath(PathFinder::MakePathgridPoint(mDestination));
+                storage.setState(Wander_Walking, true);
+                mHasDestination = true;
+                break;
+            case PendingPath_WalkToNode:
+            {
+                // The allowed nodes may have been repopulated while the search was running
+                for (unsigned int i = 0; i < storage.mAllowedNodes.size(); ++i)
+                {
+                    const ESM::Pathgrid::Point& node = storage.mAllowedNodes[i];
+                    if (node.mX == mPendingNode.mX && node.mY == mPendingNode.mY && node.mZ == mPendingNode.mZ)
+                    {
+                        onPathToNodeFinished(storage, i, PathFinder::MakePathgridPoint(mDestination));
+                        return;
+                    }
+                }
+                if (mPathFinder.isPathConstructed())
+                {
+                    mHasDestination = true;
+                    storage.setState(Wander_Walking);
+                }
+                break;
+            }
+            case PendingPath_None:
+                break;
+        }
     }
 
     void AiWander::ToWorldCoordinates(ESM::Pathgrid::Point& point, const ESM::Cell * cell)
@@ -953,6 +1026,7 @@ namespace MWMechanics
         , mStoredInitialActorPosition(wander->mStoredInitialActorPosition)
         , mHasDestination(false)
         , mDestination(osg::Vec3f(0, 0, 0))
+        , mPendingPathAction(PendingPath_None)
     {
         if (mStoredInitialActorPosition)
             mInitialActorPosition = wander->mInitialActorPosition;
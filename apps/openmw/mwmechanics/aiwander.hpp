@@ -104,6 +104,20 @@ namespace MWMechanics
             bool mHasDestination;
             osg::Vec3f mDestination;
 
+            /// What to do once the path search that is running on the pathfinding queue has finished
+            enum PendingPathAction
+            {
+                PendingPath_None,
+                PendingPath_Walk,
+                PendingPath_WalkManually,
+                PendingPath_WalkToNode
+            };
+            PendingPathAction mPendingPathAction;
+            ESM::Pathgrid::Point mPendingNode;
+
+            void onPendingPathArrived(AiWanderStorage& storage, PendingPathAction action);
+            void onPathToNodeFinished(AiWanderStorage& storage, unsigned int node, const ESM::Pathgrid::Point& dest);
+
             void getAllowedNodes(const MWWorld::Ptr& actor, const ESM::Cell* cell, AiWanderStorage& storage);
 
             void trimAllowedNodes(std::vector<ESM::Pathgrid::Point>& nodes, const PathFinder& pathfinder);
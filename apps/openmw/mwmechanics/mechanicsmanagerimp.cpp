@@ -236,9 +236,9 @@ namespace MWMechanics
 
     // mWatchedTimeToStartDrowning = -1 for correct drowning state check,
     // if stats.getTimeToStartDrowning() == 0 already on game start
-    MechanicsManager::MechanicsManager()
+    MechanicsManager::MechanicsManager(SceneUtil::WorkQueue* workQueue)
     : mWatchedTimeToStartDrowning(-1), mWatchedStatsEmpty (true), mUpdatePlayer (true), mClassSelected (false),
-      mRaceSelected (false), mAI(true)
+      mRaceSelected (false), mAI(true), mPathfindingQueue(workQueue)
     {
         //buildPlayer no longer here, needs to be done explicitly after all subsystems are up and running
     }
@@ -418,6 +418,8 @@ namespace MWMechanics
             mActors.addActor(ptr, true);
         }
 
+        mPathfindingQueue.update();
+
         mActors.update(duration, paused);
         mObjects.update(duration, paused);
     }
@@ -1480,6 +1482,7 @@ namespace MWMechanics
 
     void MechanicsManager::clear()
     {
+        mPathfindingQueue.clear();
         mActors.clear();
         mStolenItems.clear();
         mClassSelected = false;
@@ -1630,4 +1633,14 @@ namespace MWMechanics
         mActors.cleanupSummonedCreature(caster.getClass().getCreatureStats(caster), creatureActorId);
     }
 
+    PathfindingQueue* MechanicsManager::getPathfindingQueue()
+    {
+        return &mPathfindingQueue;
+    }
+
+    void MechanicsManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
+    {
+        mPathfindingQueue.reportStats(frameNumber, stats);
+    }
+
 }
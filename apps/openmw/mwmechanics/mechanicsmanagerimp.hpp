@@ -9,12 +9,18 @@
 #include "npcstats.hpp"
 #include "objects.hpp"
 #include "actors.hpp"
+#include "pathfindingqueue.hpp"
 
 namespace MWWorld
 {
     class CellStore;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWMechanics
 {
     class MechanicsManager : public MWBase::MechanicsManager
@@ -39,6 +45,8 @@ namespace MWMechanics
             Objects mObjects;
             Actors mActors;
 
+            PathfindingQueue mPathfindingQueue;
+
             typedef std::pair<std::string, bool> Owner; // < Owner id, bool isFaction >
             typedef std::map<Owner, int> OwnerMap; // < Owner, number of stolen items with this id from this owner >
             typedef std::map<std::string, OwnerMap> StolenItemsMap;
@@ -50,7 +58,7 @@ namespace MWMechanics
             ///< build player according to stored class/race/birthsign information. Will
             /// default to the values of the ESM::NPC object, if no explicit information is given.
 
-            MechanicsManager();
+            MechanicsManager(SceneUtil::WorkQueue* workQueue);
 
             virtual void add (const MWWorld::Ptr& ptr);
             ///< Register an object for management
@@ -206,6 +214,10 @@ namespace MWMechanics
 
             virtual void cleanupSummonedCreature(const MWWorld::Ptr& caster, int creatureActorId);
 
+            virtual PathfindingQueue* getPathfindingQueue();
+
+            virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
         private:
             void reportCrime (const MWWorld::Ptr& ptr, const MWWorld::Ptr& victim,
                                       OffenseType type, int arg=0);
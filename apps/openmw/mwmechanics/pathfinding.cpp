@@ -4,6 +4,7 @@
 
 #include "../mwbase/world.hpp"
 #include "../mwbase/environment.hpp"
+#include "../mwbase/mechanicsmanager.hpp"
 
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/cellstore.hpp"
@@ -129,6 +130,18 @@ namespace MWMechanics
     {
         if(!mPath.empty())
             mPath.clear();
+
+        mRequest = NULL;
+        mRequestTail.clear();
+    }
+
+    void PathFinder::updatePathgrid(const MWWorld::CellStore* cell)
+    {
+        if(mCell != cell || !mPathgrid)
+        {
+            mCell = cell;
+            mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*mCell->getCell());
+        }
     }
 
     /*
@@ -171,25 +184,27 @@ namespace MWMechanics
                                const ESM::Pathgrid::Point &endPoint,
                                const MWWorld::CellStore* cell)
     {
-        mPath.clear();
+        updatePathgrid(cell);
+        mPath = findPath(startPoint, endPoint, mCell, mPathgrid);
+    }
 
-        if(mCell != cell || !mPathgrid)
-        {
-            mCell = cell;
-            mPathgrid = MWBase::Environment::get().getWorld()->getStore().get<ESM::Pathgrid>().search(*mCell->getCell());
-        }
+    std::list<ESM::Pathgrid::Point> PathFinder::findPath(const ESM::Pathgrid::Point &startPoint,
+                                                         const ESM::Pathgrid::Point &endPoint,
+                                                         const MWWorld::CellStore* cell, const ESM::Pathgrid* pathgrid)
+    {
+        std::list<ESM::Pathgrid::Point> path;
 
         // Refer to AiWander reseach topic on openmw forums for some background.
         // Maybe there is no pathgrid for this cell.  Just go to destination and let
         // physics take care of any blockages.
-        if(!mPathgrid || mPathgrid->mPoints.empty())
+        if(!pathgrid || pathgrid->mPoints.empty())
         {
-            mPath.push_back(endPoint);
-            return;
+            path.push_back(endPoint);
+            return path;
         }
 
         // NOTE: GetClosestPoint expects local coordinates
-        CoordinateConverter converter(mCell->getCell());
+        CoordinateConverter converter(cell->getCell());
 
         // NOTE: It is possible that GetClosestPoint returns a pathgrind point index
         //       that is unreachable in some situations. e.g. actor is standing
@@ -197,22 +212,22 @@ namespace MWMechanics
         //       point right behind the wall that is closer than any pathgrid
         //       point outside the wall
         osg::Vec3f startPointInLocalCoords(converter.toLocalVec3(startPoint));
-        int startNode = GetClosestPoint(mPathgrid, startPointInLocalCoords);
+        int startNode = GetClosestPoint(pathgrid, startPointInLocalCoords);
 
         osg::Vec3f endPointInLocalCoords(converter.toLocalVec3(endPoint));
-        std::pair<int, bool> endNode = getClosestReachablePoint(mPathgrid, cell,
+        std::pair<int, bool> endNode = getClosestReachablePoint(pathgrid, cell,
             endPointInLocalCoords,
                 startNode);
 
         // if it's shorter for actor to travel from start to end, than to travel from either
         // start or end to nearest pathgrid point, just travel from start to end.
         float startToEndLength2 = (endPointInLocalCoords - startPointInLocalCoords).length2();
-        float endTolastNodeLength2 = DistanceSquared(mPathgrid->mPoints[endNode.first], endPointInLocalCoords);
-        float startTo1stNodeLength2 = DistanceSquared(mPathgrid->mPoints[startNode], startPointInLocalCoords);
+        float endTolastNodeLength2 = DistanceSquared(pathgrid->mPoints[endNode.first], endPointInLocalCoords);
+        float startTo1stNodeLength2 = DistanceSquared(pathgrid->mPoints[startNode], startPointInLocalCoords);
         if ((startToEndLength2 < startTo1stNodeLength2) || (startToEndLength2 < endTolastNodeLength2))
         {
-            mPath.push_back(endPoint);
-            return;
+            path.push_back(endPoint);
+            return path;
         }
 
         // AiWander has logic that depends on whether a path was created,
@@ -222,16 +237,16 @@ namespace MWMechanics
         //       nodes are the same
         if(startNode == endNode.first)
         {
-            ESM::Pathgrid::Point temp(mPathgrid->mPoints[startNode]);
+            ESM::Pathgrid::Point temp(pathgrid->mPoints[startNode]);
             converter.toWorld(temp);
-            mPath.push_back(temp);
+            path.push_back(temp);
         }
         else
         {
-            mPath = mCell->aStarSearch(startNode, endNode.first);
+            path = cell->aStarSearch(startNode, endNode.first);
 
             // convert supplied path to world coordinates
-            for (std::list<ESM::Pathgrid::Point>::iterator iter(mPath.begin()); iter != mPath.end(); ++iter)
+            for (std::list<ESM::Pathgrid::Point>::iterator iter(path.begin()); iter != path.end(); ++iter)
             {
                 converter.toWorld(*iter);
             }
@@ -250,7 +265,9 @@ namespace MWMechanics
         //
         // The AI routines will have to deal with such situations.
         if(endNode.second)
-            mPath.push_back(endPoint);
+            path.push_back(endPoint);
+
+        return path;
     }
 
     float PathFinder::getZAngleToNext(float x, float y) const
@@ -302,17 +319,62 @@ namespace MWMechanics
     void PathFinder::buildSyncedPath(const ESM::Pathgrid::Point &startPoint,
         const ESM::Pathgrid::Point &endPoint,
         const MWWorld::CellStore* cell)
+    {
+        mRequest = NULL;
+        mRequestTail.clear();
+
+        updatePathgrid(cell);
+        applySyncedPath(findPath(startPoint, endPoint, mCell, mPathgrid));
+    }
+
+    void PathFinder::buildSyncedPathAsync(const ESM::Pathgrid::Point &startPoint,
+        const ESM::Pathgrid::Point &endPoint,
+        const MWWorld::CellStore* cell)
+    {
+        // a search for the same destination is already underway, keep waiting for it
+        if (mRequest && mRequest->getCell() == cell
+                && distance(mRequest->getEndPoint(), endPoint) <= 10)
+            return;
+
+        mRequestTail.clear();
+
+        updatePathgrid(cell);
+        mRequest = MWBase::Environment::get().getMechanicsManager()->getPathfindingQueue()->request(startPoint, endPoint, mCell, mPathgrid);
+
+        updatePendingPath();
+    }
+
+    bool PathFinder::updatePendingPath()
+    {
+        if (!mRequest || !mRequest->isDone())
+            return false;
+
+        osg::ref_ptr<PathRequest> request = mRequest;
+        mRequest = NULL;
+
+        if (request->isAborted())
+        {
+            mRequestTail.clear();
+            return false;
+        }
+
+        applySyncedPath(request->getPath());
+        mPath.splice(mPath.end(), mRequestTail);
+        return true;
+    }
+
+    void PathFinder::applySyncedPath(const std::list<ESM::Pathgrid::Point>& path)
     {
         if (mPath.size() < 2)
         {
             // if path has one point, then it's the destination.
             // don't need to worry about bad path for this case
-            buildPath(startPoint, endPoint, cell);
+            mPath = path;
         }
         else
         {
             const ESM::Pathgrid::Point oldStart(*getPath().begin());
-            buildPath(startPoint, endPoint, cell);
+            mPath = path;
             if (mPath.size() >= 2)
             {
                 // if 2nd waypoint of new path == 1st waypoint of old, 
@@ -7,6 +7,8 @@
 #include <components/esm/defs.hpp>
 #include <components/esm/loadpgrd.hpp>
 
+#include "pathfindingqueue.hpp"
+
 namespace MWWorld
 {
     class CellStore;
@@ -56,6 +58,11 @@ namespace MWMechanics
             void buildPath(const ESM::Pathgrid::Point &startPoint, const ESM::Pathgrid::Point &endPoint,
                            const MWWorld::CellStore* cell);
 
+            /// Compute a path without touching any PathFinder state. Safe to call from a worker thread.
+            /// @param pathgrid The pathgrid of \a cell, may be NULL
+            static std::list<ESM::Pathgrid::Point> findPath(const ESM::Pathgrid::Point &startPoint, const ESM::Pathgrid::Point &endPoint,
+                                                            const MWWorld::CellStore* cell, const ESM::Pathgrid* pathgrid);
+
             bool checkPathCompleted(float x, float y, float tolerance = PathTolerance);
             ///< \Returns true if we are within \a tolerance units of the last path point.
 
@@ -91,9 +98,29 @@ namespace MWMechanics
             void buildSyncedPath(const ESM::Pathgrid::Point &startPoint, const ESM::Pathgrid::Point &endPoint,
                 const MWWorld::CellStore* cell);
 
+            /** Like buildSyncedPath(), but the search goes through the PathfindingQueue and may complete on a later frame.
+            @note
+                Until the result arrives the previous path is kept, or the path stays empty if there was none.
+                Use isPathPending() to tell "still searching" from "no path found", and call
+                updatePendingPath() every frame to pick up the result.
+             */
+            void buildSyncedPathAsync(const ESM::Pathgrid::Point &startPoint, const ESM::Pathgrid::Point &endPoint,
+                const MWWorld::CellStore* cell);
+
+            /// Apply the result of a finished asynchronous search, if there is one.
+            /// \return true if the path was replaced.
+            bool updatePendingPath();
+
+            bool isPathPending() const
+            {
+                return mRequest.valid();
+            }
+
             void addPointToPath(const ESM::Pathgrid::Point &point)
             {
                 mPath.push_back(point);
+                if (mRequest)
+                    mRequestTail.push_back(point);
             }
 
             /// utility function to convert a osg::Vec3f to a Pathgrid::Point
@@ -151,10 +178,18 @@ namespace MWMechanics
             }
 
         private:
+            void updatePathgrid(const MWWorld::CellStore* cell);
+
+            void applySyncedPath(const std::list<ESM::Pathgrid::Point>& path);
+
             std::list<ESM::Pathgrid::Point> mPath;
 
             const ESM::Pathgrid *mPathgrid;
             const MWWorld::CellStore* mCell;
+
+            osg::ref_ptr<PathRequest> mRequest;
+            // points added with addPointToPath() while mRequest is pending, re-appended once it is applied
+            std::list<ESM::Pathgrid::Point> mRequestTail;
     };
 }
 
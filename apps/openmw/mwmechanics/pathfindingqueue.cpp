@@ -0,0 +1,121 @@
+#include "pathfindingqueue.hpp"
+
+#include <osg/Stats>
+
+#include <components/settings/settings.hpp>
+
+#include "pathfinding.hpp"
+
+namespace MWMechanics
+{
+
+    PathRequest::PathRequest(const ESM::Pathgrid::Point& startPoint, const ESM::Pathgrid::Point& endPoint,
+                             const MWWorld::CellStore* cell, const ESM::Pathgrid* pathgrid)
+        : mStartPoint(startPoint)
+        , mEndPoint(endPoint)
+        , mCell(cell)
+        , mPathgrid(pathgrid)
+        , mSubmitTick(osg::Timer::instance()->tick())
+        , mCompleteTick(0)
+        , mAborted(0)
+    {
+    }
+
+    void PathRequest::doWork()
+    {
+        if (mAborted == 0)
+            mPath = PathFinder::findPath(mStartPoint, mEndPoint, mCell, mPathgrid);
+
+        mCompleteTick = osg::Timer::instance()->tick();
+    }
+
+    void PathRequest::abort()
+    {
+        mAborted.exchange(1);
+    }
+
+    bool PathRequest::isAborted() const
+    {
+        return mAborted > 0;
+    }
+
+    double PathRequest::getLatency() const
+    {
+        return osg::Timer::instance()->delta_s(mSubmitTick, mCompleteTick);
+    }
+
+    PathfindingQueue::PathfindingQueue(SceneUtil::WorkQueue* workQueue)
+        : mWorkQueue(workQueue)
+        , mFrameBudget(Settings::Manager::getFloat("pathfinding budget", "Game") / 1000.0)
+        , mTimeSpent(0.0)
+        , mLatency(0.0)
+    {
+    }
+
+    PathfindingQueue::~PathfindingQueue()
+    {
+        clear();
+    }
+
+    osg::ref_ptr<PathRequest> PathfindingQueue::request(const ESM::Pathgrid::Point &startPoint, const ESM::Pathgrid::Point &endPoint,
+                                                        const MWWorld::CellStore *cell, const ESM::Pathgrid *pathgrid)
+    {
+        osg::ref_ptr<PathRequest> request (new PathRequest(startPoint, endPoint, cell, pathgrid));
+
+        // Without a pathgrid the search is trivial, no point in deferring it
+        if (!mWorkQueue || !pathgrid || mTimeSpent < mFrameBudget)
+        {
+            osg::Timer_t startTick = osg::Timer::instance()->tick();
+            request->doWork();
+            request->signalDone();
+            mTimeSpent += osg::Timer::instance()->delta_s(startTick, osg::Timer::instance()->tick());
+            return request;
+        }
+
+        // path requests are small and latency sensitive, so put them ahead of preloading work
+        mWorkQueue->addWorkItem(request, true);
+        mPending.push_back(request);
+        return request;
+    }
+
+    void PathfindingQueue::update()
+    {
+        mTimeSpent = 0.0;
+
+        double latency = 0.0;
+        unsigned int completed = 0;
+        for (std::vector<osg::ref_ptr<PathRequest> >::iterator it = mPending.begin(); it != mPending.end();)
+        {
+            if ((*it)->isDone())
+            {
+                latency += (*it)->getLatency();
+                ++completed;
+                it = mPending.erase(it);
+            }
+            else
+                ++it;
+        }
+
+        if (completed > 0)
+            mLatency = latency / completed;
+        else if (mPending.empty())
+            mLatency = 0.0;
+    }
+
+    void PathfindingQueue::clear()
+    {
+        for (std::vector<osg::ref_ptr<PathRequest> >::iterator it = mPending.begin(); it != mPending.end(); ++it)
+            (*it)->abort();
+        for (std::vector<osg::ref_ptr<PathRequest> >::iterator it = mPending.begin(); it != mPending.end(); ++it)
+            (*it)->waitTillDone();
+        mPending.clear();
+        mLatency = 0.0;
+    }
+
+    void PathfindingQueue::reportStats(unsigned int frameNumber, osg::Stats *stats) const
+    {
+        stats->setAttribute(frameNumber, "Path Queue", mPending.size());
+        stats->setAttribute(frameNumber, "Path Latency", mLatency * 1000.0);
+    }
+
+}
@@ -0,0 +1,98 @@
+#ifndef GAME_MWMECHANICS_PATHFINDINGQUEUE_H
+#define GAME_MWMECHANICS_PATHFINDINGQUEUE_H
+
+#include <list>
+#include <vector>
+
+#include <osg/ref_ptr>
+#include <osg/Timer>
+
+#include <OpenThreads/Atomic>
+
+#include <components/esm/loadpgrd.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+namespace osg
+{
+    class Stats;
+}
+
+namespace MWWorld
+{
+    class CellStore;
+}
+
+namespace MWMechanics
+{
+    /// @brief A single path search, performed either on the main thread or on a WorkQueue thread.
+    /// @note The cell and pathgrid must stay valid until the request is done (see PathfindingQueue::clear()).
+    class PathRequest : public SceneUtil::WorkItem
+    {
+    public:
+        PathRequest(const ESM::Pathgrid::Point& startPoint, const ESM::Pathgrid::Point& endPoint,
+                    const MWWorld::CellStore* cell, const ESM::Pathgrid* pathgrid);
+
+        virtual void doWork();
+
+        virtual void abort();
+
+        bool isAborted() const;
+
+        const ESM::Pathgrid::Point& getEndPoint() const { return mEndPoint; }
+        const MWWorld::CellStore* getCell() const { return mCell; }
+
+        /// Only valid once isDone() returns true.
+        const std::list<ESM::Pathgrid::Point>& getPath() const { return mPath; }
+
+        /// Time from submission to completion in seconds. Only valid once isDone() returns true.
+        double getLatency() const;
+
+    private:
+        ESM::Pathgrid::Point mStartPoint;
+        ESM::Pathgrid::Point mEndPoint;
+        const MWWorld::CellStore* mCell;
+        const ESM::Pathgrid* mPathgrid;
+
+        std::list<ESM::Pathgrid::Point> mPath;
+
+        osg::Timer_t mSubmitTick;
+        osg::Timer_t mCompleteTick;
+
+        /// Set on the main thread, read by the worker
+        OpenThreads::Atomic mAborted;
+    };
+
+    /// @brief Services path requests for the AI packages.
+    /// Requests are resolved immediately while the per-frame time budget lasts; once it is used up,
+    /// further requests are handed to the WorkQueue and their results picked up by the PathFinder on a later frame.
+    class PathfindingQueue
+    {
+    public:
+        PathfindingQueue(SceneUtil::WorkQueue* workQueue);
+        ~PathfindingQueue();
+
+        /// Submit a path search. If the returned request is not done yet, it will complete asynchronously.
+        osg::ref_ptr<PathRequest> request(const ESM::Pathgrid::Point& startPoint, const ESM::Pathgrid::Point& endPoint,
+                                          const MWWorld::CellStore* cell, const ESM::Pathgrid* pathgrid);
+
+        /// Call once per frame, before the AI update. Resets the frame budget and collects finished requests.
+        void update();
+
+        /// Abort and wait for all pending requests. Call before the cells the requests refer to are unloaded.
+        void clear();
+
+        void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        std::vector<osg::ref_ptr<PathRequest> > mPending;
+
+        double mFrameBudget;
+        double mTimeSpent;
+
+        double mLatency;
+    };
+}
+
+#endif
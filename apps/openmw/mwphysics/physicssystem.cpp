@@ -24,6 +24,7 @@
 #include <components/esm/loadgmst.hpp>
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/unrefqueue.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/nifosg/particle.hpp> // FindRecIndexVisitor
 
@@ -685,6 +686,8 @@ namespace MWPhysics
         , mParentNode(parentNode)
     {
         mResourceSystem->addResourceManager(mShapeManager.get());
+        if (!mResourceSystem->getDiskCacheDirectory().empty())
+            mShapeManager->setDiskCacheDirectory(mResourceSystem->getDiskCacheDirectory() + "/collision");
 
         mCollisionConfiguration = new btDefaultCollisionConfiguration();
         mDispatcher = new btCollisionDispatcher(mCollisionConfiguration);
@@ -1354,6 +1357,8 @@ namespace MWPhysics
 
     const PtrVelocityList& PhysicsSystem::applyQueuedMovement(float dt)
     {
+        Misc::ProfileZone zone("Physics movement");
+
         mMovementResults.clear();
 
         mTimeAccum += dt;
@@ -1437,6 +1442,8 @@ namespace MWPhysics
 
     void PhysicsSystem::stepSimulation(float dt)
     {
+        Misc::ProfileZone zone("Physics simulation");
+
         for (std::set<Object*>::iterator it = mAnimatedObjects.begin(); it != mAnimatedObjects.end(); ++it)
             (*it)->animateCollisionShapes(mCollisionWorld);
 
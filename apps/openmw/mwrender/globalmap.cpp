@@ -1,6 +1,11 @@
 #include "globalmap.hpp"
 
 #include <climits>
+#include <functional>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
 
 #include <osg/Image>
 #include <osg/Texture2D>
@@ -17,6 +22,8 @@
 
 #include <components/sceneutil/workqueue.hpp>
 
+#include <components/misc/profiler.hpp>
+
 #include <components/esm/globalmap.hpp>
 
 #include "../mwbase/environment.hpp"
@@ -29,6 +36,12 @@
 namespace
 {
 
+    // Increase when the way the map is generated changes, to invalidate existing cache entries
+    const int sMapCacheVersion = 1;
+
+    // Width and height of a map tile in cells
+    const int sTileCells = 16;
+
     // Create a screen-aligned quad with given texture coordinates.
     // Assumes a top-left origin of the sampled image.
     osg::ref_ptr<osg::Geometry> createTexturedQuad(float leftTexCoord, float topTexCoord, float rightTexCoord, float bottomTexCoord)
@@ -97,132 +110,264 @@ namespace
 namespace MWRender
 {
 
+    /// @brief Generates the base map texels of a rectangle of cells. Several tiles can be generated in parallel,
+    /// since each of them writes to a separate area of the images.
     class CreateMapWorkItem : public SceneUtil::WorkItem
     {
     public:
-        CreateMapWorkItem(int width, int height, int minX, int minY, int maxX, int maxY, int cellSize, const MWWorld::Store<ESM::Land>& landStore)
-            : mWidth(width), mHeight(height), mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mCellSize(cellSize), mLandStore(landStore)
+        CreateMapWorkItem(osg::Image* image, osg::Image* alphaImage, int minX, int minY, int maxX, int maxY, int originX, int originY,
+                          int cellSize, const MWWorld::Store<ESM::Land>& landStore, const std::string& cacheDir)
+            : mImage(image), mAlphaImage(alphaImage)
+            , mMinX(minX), mMinY(minY), mMaxX(maxX), mMaxY(maxY), mOriginX(originX), mOriginY(originY)
+            , mCellSize(cellSize), mLandStore(landStore), mCacheDir(cacheDir)
         {
         }
 
         virtual void doWork()
         {
-            osg::ref_ptr<osg::Image> image = new osg::Image;
-            image->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
-            unsigned char* data = image->data();
-
-            osg::ref_ptr<osg::Image> alphaImage = new osg::Image;
-            alphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
-            unsigned char* alphaData = alphaImage->data();
+            Misc::ProfileZone zone("Global map tile");
 
-            for (int x = mMinX; x <= mMaxX; ++x)
+            std::vector<const ESM::Land*> lands;
+            lands.reserve((mMaxX-mMinX+1) * (mMaxY-mMinY+1));
+            for (int y = mMinY; y <= mMaxY; ++y)
             {
-                for (int y = mMinY; y <= mMaxY; ++y)
+                for (int x = mMinX; x <= mMaxX; ++x)
                 {
                     const ESM::Land* land = mLandStore.search (x,y);
+                    if (land && !(land->mDataTypes & ESM::Land::DATA_WNAM))
+                        land = NULL;
+                    lands.push_back(land);
+                }
+            }
+
+            std::string path;
+            if (!mCacheDir.empty())
+            {
+                path = getCachePath(lands);
+                if (readCache(path))
+                    return;
+            }
+
+            // The colour of a texel only depends on the height of the WNAM vertex it falls on, so colour
+            // all 256 heights once and reduce the per-texel work to table lookups.
+            unsigned char colors[256][4];
+            for (int i=0; i<256; ++i)
+                getColor(static_cast<signed char>(i), colors[i]);
+
+            std::vector<int> vertices (mCellSize);
+            for (int i=0; i<mCellSize; ++i)
+                vertices[i] = static_cast<int>(float(i)/float(mCellSize) * 9);
+
+            const int width = mImage->s();
+            unsigned char* data = mImage->data();
+            unsigned char* alphaData = mAlphaImage->data();
+
+            std::vector<const ESM::Land*>::const_iterator landIt = lands.begin();
+            for (int y = mMinY; y <= mMaxY; ++y)
+            {
+                for (int x = mMinX; x <= mMaxX; ++x, ++landIt)
+                {
+                    const ESM::Land* land = *landIt;
 
                     for (int cellY=0; cellY<mCellSize; ++cellY)
                     {
+                        int texelY = (y-mOriginY) * mCellSize + cellY;
+                        int texelX = (x-mOriginX) * mCellSize;
+                        unsigned char* row = data + (texelY * width + texelX) * 3;
+                        unsigned char* alphaRow = alphaData + texelY * width + texelX;
+
+                        if (!land)
+                        {
+                            const unsigned char* color = colors[static_cast<unsigned char>(SCHAR_MIN)];
+                            for (int cellX=0; cellX<mCellSize; ++cellX)
+                            {
+                                row[cellX*3] = color[0];
+                                row[cellX*3+1] = color[1];
+                                row[cellX*3+2] = color[2];
+                                alphaRow[cellX] = color[3];
+                            }
+                            continue;
+                        }
+
+                        const signed char* wnam = land->mWnam + vertices[cellY] * 9;
                         for (int cellX=0; cellX<mCellSize; ++cellX)
                         {
-                            int vertexX = static_cast<int>(float(cellX)/float(mCellSize) * 9);
-                            int vertexY = static_cast<int>(float(cellY) / float(mCellSize) * 9);
+                            const unsigned char* color = colors[static_cast<unsigned char>(wnam[vertices[cellX]])];
+                            row[cellX*3] = color[0];
+                            row[cellX*3+1] = color[1];
+                            row[cellX*3+2] = color[2];
+                            alphaRow[cellX] = color[3];
+                        }
+                    }
+                }
+            }
 
-                            int texelX = (x-mMinX) * mCellSize + cellX;
-                            int texelY = (y-mMinY) * mCellSize + cellY;
+            if (!path.empty())
+                writeCache(path);
+        }
 
-                            unsigned char r,g,b;
+    private:
+        static void getColor(signed char height, unsigned char* color)
+        {
+            unsigned char r,g,b;
 
-                            float y2 = 0;
-                            if (land && (land->mDataTypes & ESM::Land::DATA_WNAM))
-                                y2 = (land->mWnam[vertexY * 9 + vertexX] << 4) / 2048.f;
-                            else
-                                y2 = (SCHAR_MIN << 4) / 2048.f;
-                            if (y2 < 0)
-                            {
-                                r = static_cast<unsigned char>(14 * y2 + 38);
-                                g = static_cast<unsigned char>(20 * y2 + 56);
-                                b = static_cast<unsigned char>(18 * y2 + 51);
-                            }
-                            else if (y2 < 0.3f)
-                            {
-                                if (y2 < 0.1f)
-                                    y2 *= 8.f;
-                                else
-                                {
-                                    y2 -= 0.1f;
-                                    y2 += 0.8f;
-                                }
-                                r = static_cast<unsigned char>(66 - 32 * y2);
-                                g = static_cast<unsigned char>(48 - 23 * y2);
-                                b = static_cast<unsigned char>(33 - 16 * y2);
-                            }
-                            else
-                            {
-                                y2 -= 0.3f;
-                                y2 *= 1.428f;
-                                r = static_cast<unsigned char>(34 - 29 * y2);
-                                g = static_cast<unsigned char>(25 - 20 * y2);
-                                b = static_cast<unsigned char>(17 - 12 * y2);
-                            }
+            float y2 = (height << 4) / 2048.f;
+            if (y2 < 0)
+            {
+                r = static_cast<unsigned char>(14 * y2 + 38);
+                g = static_cast<unsigned char>(20 * y2 + 56);
+                b = static_cast<unsigned char>(18 * y2 + 51);
+            }
+            else if (y2 < 0.3f)
+            {
+                if (y2 < 0.1f)
+                    y2 *= 8.f;
+                else
+                {
+                    y2 -= 0.1f;
+                    y2 += 0.8f;
+                }
+                r = static_cast<unsigned char>(66 - 32 * y2);
+                g = static_cast<unsigned char>(48 - 23 * y2);
+                b = static_cast<unsigned char>(33 - 16 * y2);
+            }
+            else
+            {
+                y2 -= 0.3f;
+                y2 *= 1.428f;
+                r = static_cast<unsigned char>(34 - 29 * y2);
+                g = static_cast<unsigned char>(25 - 20 * y2);
+                b = static_cast<unsigned char>(17 - 12 * y2);
+            }
 
-                            data[texelY * mWidth * 3 + texelX * 3] = r;
-                            data[texelY * mWidth * 3 + texelX * 3+1] = g;
-                            data[texelY * mWidth * 3 + texelX * 3+2] = b;
+            color[0] = r;
+            color[1] = g;
+            color[2] = b;
+            color[3] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
+        }
 
-                            alphaData[texelY * mWidth+ texelX] = (y2 < 0) ? static_cast<unsigned char>(0) : static_cast<unsigned char>(255);
-                        }
-                    }
+        std::string getHeader() const
+        {
+            std::ostringstream header;
+            header << "OpenMW global map tile " << sMapCacheVersion << " " << mCellSize << " "
+                   << mMinX << " " << mMinY << " " << mMaxX << " " << mMaxY;
+            return header.str();
+        }
+
+        /// The entry for a tile is named after a hash of the WNAM data of its cells, so that it is
+        /// invalidated by any change of the load order that affects the map.
+        std::string getCachePath(const std::vector<const ESM::Land*>& lands) const
+        {
+            std::string key = getHeader();
+            for (std::vector<const ESM::Land*>::const_iterator it = lands.begin(); it != lands.end(); ++it)
+            {
+                if (*it)
+                {
+                    key += '\1';
+                    key.append(reinterpret_cast<const char*>((*it)->mWnam), sizeof((*it)->mWnam));
                 }
+                else
+                    key += '\0';
+            }
+
+            std::ostringstream name;
+            name << std::hex << std::hash<std::string>()(key) << ".bin";
+            return (boost::filesystem::path(mCacheDir) / name.str()).string();
+        }
+
+        size_t getTileSize() const
+        {
+            return static_cast<size_t>((mMaxX-mMinX+1) * mCellSize) * static_cast<size_t>((mMaxY-mMinY+1) * mCellSize);
+        }
+
+        bool readCache(const std::string& path)
+        {
+            boost::filesystem::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+            if (!file.is_open())
+                return false;
+
+            std::string header;
+            if (!std::getline(file, header) || header != getHeader())
+                return false;
+
+            // RGB texels followed by alpha texels, row by row
+            std::vector<unsigned char> buffer (getTileSize() * 4);
+            file.read(reinterpret_cast<char*>(&buffer[0]), buffer.size());
+            if (file.gcount() != static_cast<std::streamsize>(buffer.size()))
+                return false;
+
+            copyTile(&buffer[0], true);
+            return true;
+        }
+
+        void writeCache(const std::string& path)
+        {
+            std::vector<unsigned char> buffer (getTileSize() * 4);
+            copyTile(&buffer[0], false);
+
+            // other instances of the game may be writing the same tile, so write to a unique file and move it into place
+            boost::filesystem::path tmpPath = boost::filesystem::path(path).parent_path() / boost::filesystem::unique_path("%%%%%%%%%%%%.tmp");
+            bool good = false;
+            {
+                boost::filesystem::ofstream file(tmpPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+                file << getHeader() << '\n';
+                file.write(reinterpret_cast<const char*>(&buffer[0]), buffer.size());
+                good = file.good();
             }
 
-            mBaseTexture = new osg::Texture2D;
-            mBaseTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
-            mBaseTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
-            mBaseTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
-            mBaseTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
-            mBaseTexture->setImage(image);
-            mBaseTexture->setResizeNonPowerOfTwoHint(false);
-
-            mAlphaTexture = new osg::Texture2D;
-            mAlphaTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
-            mAlphaTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
-            mAlphaTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
-            mAlphaTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
-            mAlphaTexture->setImage(alphaImage);
-            mAlphaTexture->setResizeNonPowerOfTwoHint(false);
-
-            mOverlayImage = new osg::Image;
-            mOverlayImage->allocateImage(mWidth, mHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE);
-            assert(mOverlayImage->isDataContiguous());
-
-            memset(mOverlayImage->data(), 0, mOverlayImage->getTotalSizeInBytes());
-
-            mOverlayTexture = new osg::Texture2D;
-            mOverlayTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
-            mOverlayTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
-            mOverlayTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
-            mOverlayTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
-            mOverlayTexture->setResizeNonPowerOfTwoHint(false);
-            mOverlayTexture->setInternalFormat(GL_RGBA);
-            mOverlayTexture->setTextureSize(mWidth, mHeight);
+            boost::system::error_code ec;
+            if (good)
+                boost::filesystem::rename(tmpPath, path, ec);
+            if (!good || ec)
+            {
+                std::cerr << "Failed to write global map cache '" << path << "'" << std::endl;
+                boost::filesystem::remove(tmpPath, ec);
+            }
         }
 
-        int mWidth, mHeight;
+        /// Copy the texels of this tile between the images and a packed buffer.
+        void copyTile(unsigned char* buffer, bool toImage)
+        {
+            const int width = mImage->s();
+            const int tileWidth = (mMaxX-mMinX+1) * mCellSize;
+            const int tileHeight = (mMaxY-mMinY+1) * mCellSize;
+            const int left = (mMinX-mOriginX) * mCellSize;
+            const int bottom = (mMinY-mOriginY) * mCellSize;
+
+            unsigned char* rgb = buffer;
+            unsigned char* alpha = buffer + getTileSize() * 3;
+            for (int row=0; row<tileHeight; ++row)
+            {
+                unsigned char* imageRow = mImage->data() + ((bottom + row) * width + left) * 3;
+                unsigned char* alphaImageRow = mAlphaImage->data() + (bottom + row) * width + left;
+                if (toImage)
+                {
+                    memcpy(imageRow, rgb, tileWidth * 3);
+                    memcpy(alphaImageRow, alpha, tileWidth);
+                }
+                else
+                {
+                    memcpy(rgb, imageRow, tileWidth * 3);
+                    memcpy(alpha, alphaImageRow, tileWidth);
+                }
+                rgb += tileWidth * 3;
+                alpha += tileWidth;
+            }
+        }
+
+        osg::ref_ptr<osg::Image> mImage;
+        osg::ref_ptr<osg::Image> mAlphaImage;
         int mMinX, mMinY, mMaxX, mMaxY;
+        int mOriginX, mOriginY;
         int mCellSize;
         const MWWorld::Store<ESM::Land>& mLandStore;
-
-        osg::ref_ptr<osg::Texture2D> mBaseTexture;
-        osg::ref_ptr<osg::Texture2D> mAlphaTexture;
-
-        osg::ref_ptr<osg::Image> mOverlayImage;
-        osg::ref_ptr<osg::Texture2D> mOverlayTexture;
+        std::string mCacheDir;
     };
 
-    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue)
+    GlobalMap::GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cacheDir)
         : mRoot(root)
         , mWorkQueue(workQueue)
+        , mCacheDir(cacheDir)
         , mWidth(0)
         , mHeight(0)
         , mMinX(0), mMaxX(0)
@@ -230,6 +375,17 @@ namespace MWRender
 
     {
         mCellSize = Settings::Manager::getInt("global map cell size", "Map");
+
+        if (!mCacheDir.empty())
+        {
+            boost::system::error_code ec;
+            boost::filesystem::create_directories(mCacheDir, ec);
+            if (ec)
+            {
+                std::cerr << "Failed to create global map cache directory '" << mCacheDir << "': " << ec.message() << std::endl;
+                mCacheDir.clear();
+            }
+        }
     }
 
     GlobalMap::~GlobalMap()
@@ -239,8 +395,8 @@ namespace MWRender
         for (CameraVector::iterator it = mActiveCameras.begin(); it != mActiveCameras.end(); ++it)
             removeCamera(*it);
 
-        if (mWorkItem)
-            mWorkItem->waitTillDone();
+        for (std::vector<osg::ref_ptr<CreateMapWorkItem> >::iterator it = mWorkItems.begin(); it != mWorkItems.end(); ++it)
+            (*it)->waitTillDone();
     }
 
     void GlobalMap::render ()
@@ -265,8 +421,24 @@ namespace MWRender
         mWidth = mCellSize*(mMaxX-mMinX+1);
         mHeight = mCellSize*(mMaxY-mMinY+1);
 
-        mWorkItem = new CreateMapWorkItem(mWidth, mHeight, mMinX, mMinY, mMaxX, mMaxY, mCellSize, esmStore.get<ESM::Land>());
-        mWorkQueue->addWorkItem(mWorkItem);
+        mBaseImage = new osg::Image;
+        mBaseImage->allocateImage(mWidth, mHeight, 1, GL_RGB, GL_UNSIGNED_BYTE);
+
+        mAlphaImage = new osg::Image;
+        mAlphaImage->allocateImage(mWidth, mHeight, 1, GL_ALPHA, GL_UNSIGNED_BYTE);
+
+        // split the map into tiles, so that all work threads can generate it
+        for (int y = mMinY; y <= mMaxY; y += sTileCells)
+        {
+            for (int x = mMinX; x <= mMaxX; x += sTileCells)
+            {
+                osg::ref_ptr<CreateMapWorkItem> workItem = new CreateMapWorkItem(mBaseImage, mAlphaImage, x, y,
+                        std::min(x + sTileCells - 1, mMaxX), std::min(y + sTileCells - 1, mMaxY), mMinX, mMinY,
+                        mCellSize, esmStore.get<ESM::Land>(), mCacheDir);
+                mWorkItems.push_back(workItem);
+                mWorkQueue->addWorkItem(workItem);
+            }
+        }
     }
 
     void GlobalMap::worldPosToImageSpace(float x, float z, float& imageX, float& imageY)
@@ -552,19 +724,48 @@ namespace MWRender
 
     void GlobalMap::ensureLoaded()
     {
-        if (mWorkItem)
-        {
-            mWorkItem->waitTillDone();
+        if (mWorkItems.empty())
+            return;
 
-            mOverlayImage = mWorkItem->mOverlayImage;
-            mBaseTexture = mWorkItem->mBaseTexture;
-            mAlphaTexture = mWorkItem->mAlphaTexture;
-            mOverlayTexture = mWorkItem->mOverlayTexture;
+        for (std::vector<osg::ref_ptr<CreateMapWorkItem> >::iterator it = mWorkItems.begin(); it != mWorkItems.end(); ++it)
+            (*it)->waitTillDone();
+        mWorkItems.clear();
+
+        mBaseTexture = new osg::Texture2D;
+        mBaseTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        mBaseTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+        mBaseTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        mBaseTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+        mBaseTexture->setImage(mBaseImage);
+        mBaseTexture->setResizeNonPowerOfTwoHint(false);
+
+        mAlphaTexture = new osg::Texture2D;
+        mAlphaTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        mAlphaTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+        mAlphaTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        mAlphaTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+        mAlphaTexture->setImage(mAlphaImage);
+        mAlphaTexture->setResizeNonPowerOfTwoHint(false);
+
+        mBaseImage = NULL;
+        mAlphaImage = NULL;
+
+        mOverlayImage = new osg::Image;
+        mOverlayImage->allocateImage(mWidth, mHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+        assert(mOverlayImage->isDataContiguous());
 
-            requestOverlayTextureUpdate(0, 0, mWidth, mHeight, osg::ref_ptr<osg::Texture2D>(), true, false);
+        memset(mOverlayImage->data(), 0, mOverlayImage->getTotalSizeInBytes());
 
-            mWorkItem = NULL;
-        }
+        mOverlayTexture = new osg::Texture2D;
+        mOverlayTexture->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
+        mOverlayTexture->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
+        mOverlayTexture->setFilter(osg::Texture::MIN_FILTER, osg::Texture::LINEAR);
+        mOverlayTexture->setFilter(osg::Texture::MAG_FILTER, osg::Texture::LINEAR);
+        mOverlayTexture->setResizeNonPowerOfTwoHint(false);
+        mOverlayTexture->setInternalFormat(GL_RGBA);
+        mOverlayTexture->setTextureSize(mWidth, mHeight);
+
+        requestOverlayTextureUpdate(0, 0, mWidth, mHeight, osg::ref_ptr<osg::Texture2D>(), true, false);
     }
 
     void GlobalMap::markForRemoval(osg::Camera *camera)
@@ -32,7 +32,9 @@ namespace MWRender
     class GlobalMap
     {
     public:
-        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue);
+        /// @param cacheDir Directory to store the generated map in, so it does not have to be generated again
+        ///  on the next launch. If empty, the map is not cached.
+        GlobalMap(osg::Group* root, SceneUtil::WorkQueue* workQueue, const std::string& cacheDir);
         ~GlobalMap();
 
         void render();
@@ -120,8 +122,14 @@ namespace MWRender
         // CPU copy of overlay
         osg::ref_ptr<osg::Image> mOverlayImage;
 
+        // Base map images while they are being generated
+        osg::ref_ptr<osg::Image> mBaseImage;
+        osg::ref_ptr<osg::Image> mAlphaImage;
+
         osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
-        osg::ref_ptr<CreateMapWorkItem> mWorkItem;
+        std::vector<osg::ref_ptr<CreateMapWorkItem> > mWorkItems;
+
+        std::string mCacheDir;
 
         int mWidth;
         int mHeight;
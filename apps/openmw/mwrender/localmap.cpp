@@ -8,6 +8,7 @@
 #include <osg/Texture2D>
 #include <osg/ComputeBoundsVisitor>
 #include <osg/LightSource>
+#include <osg/ValueObject>
 
 #include <osgDB/ReadFile>
 
@@ -172,6 +173,8 @@ osg::ref_ptr<osg::Camera> LocalMap::createOrthographicCamera(float x, float y, f
 
     camera->setCullMask(Mask_Scene|Mask_SimpleWater|Mask_Terrain);
     camera->setNodeMask(Mask_RenderToTexture);
+    // the map is rendered only once, so the terrain must not be loaded in the background
+    camera->setUserValue("SyncTerrain", true);
 
     osg::ref_ptr<osg::StateSet> stateset = new osg::StateSet;
 
@@ -0,0 +1,275 @@
+#include "objectpaging.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <osg/Group>
+#include <osg/MatrixTransform>
+#include <osg/Stats>
+
+#include <OpenThreads/ScopedLock>
+
+#include <components/esm/loadcell.hpp>
+#include <components/esm/loadstat.hpp>
+
+#include <components/misc/profiler.hpp>
+
+#include <components/resource/objectcache.hpp>
+#include <components/resource/scenemanager.hpp>
+
+#include <components/sceneutil/optimizer.hpp>
+#include <components/sceneutil/positionattitudetransform.hpp>
+#include <components/sceneutil/workqueue.hpp>
+
+#include <components/settings/settings.hpp>
+
+#include "../mwworld/cellstore.hpp"
+#include "../mwworld/esmreaderpool.hpp"
+#include "../mwworld/esmstore.hpp"
+
+namespace
+{
+
+    const float sCellSize = 8192.f;
+
+    /// @brief Prepares a copy of an object's scene graph for merging, by removing everything that can not be baked into static geometry.
+    class PrepareMergeVisitor : public osg::NodeVisitor
+    {
+    public:
+        PrepareMergeVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            // controllers, billboards, particles etc. need their callbacks, the frozen result is close enough at a distance
+            node.setUpdateCallback(NULL);
+            node.setCullCallback(NULL);
+            node.setDataVariance(osg::Object::STATIC);
+
+            osg::Group* group = node.asGroup();
+            if (group)
+            {
+                for (int i=static_cast<int>(group->getNumChildren())-1; i>=0; --i)
+                {
+                    osg::Node* child = group->getChild(i);
+                    // hidden nodes (e.g. collision shapes and markers) must not end up in merged geometry
+                    if (child->getNodeMask() == 0 || (child->asDrawable() && std::string(child->className()) != "Geometry"))
+                        group->removeChild(i);
+                }
+            }
+
+            traverse(node);
+        }
+    };
+
+    /// Place a copy of the object \a ref, relative to \a chunkCenter.
+    osg::ref_ptr<osg::Node> createObjectCopy(const osg::Node* templateNode, const ESM::CellRef& ref, const osg::Vec3f& chunkCenter)
+    {
+        osg::ref_ptr<osg::Node> copy = static_cast<osg::Node*>(templateNode->clone(osg::CopyOp::DEEP_COPY_NODES|osg::CopyOp::DEEP_COPY_DRAWABLES
+                                                                                     |osg::CopyOp::DEEP_COPY_ARRAYS|osg::CopyOp::DEEP_COPY_PRIMITIVES));
+        PrepareMergeVisitor visitor;
+        copy->accept(visitor);
+
+        // same rotation order as for objects in the active cells, see MWWorld::Scene
+        const float* rot = ref.mPos.rot;
+        osg::Quat attitude = osg::Quat(rot[2], osg::Vec3f(0,0,-1))
+                * osg::Quat(rot[1], osg::Vec3f(0,-1,0))
+                * osg::Quat(rot[0], osg::Vec3f(-1,0,0));
+
+        osg::ref_ptr<osg::MatrixTransform> transform (new osg::MatrixTransform);
+        transform->setDataVariance(osg::Object::STATIC);
+        transform->setMatrix(osg::Matrix::scale(osg::Vec3f(ref.mScale, ref.mScale, ref.mScale))
+                             * osg::Matrix::rotate(attitude)
+                             * osg::Matrix::translate(ref.mPos.asVec3() - chunkCenter));
+        transform->addChild(copy);
+        return transform;
+    }
+
+}
+
+namespace MWRender
+{
+
+class CreateObjectChunkWorkItem : public SceneUtil::WorkItem
+{
+public:
+    CreateObjectChunkWorkItem(ObjectPaging* objectPaging, const std::string& id, float size, const osg::Vec2f& center)
+        : mObjectPaging(objectPaging)
+        , mId(id)
+        , mSize(size)
+        , mCenter(center)
+    {
+    }
+
+    virtual void doWork()
+    {
+        osg::ref_ptr<osg::Node> node = mObjectPaging->createChunk(mSize, mCenter);
+        mObjectPaging->mCache->addEntryToObjectCache(mId, node.get());
+
+        // only remove the request once the chunk is in the cache, so that it is not requested twice
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mObjectPaging->mPendingChunksMutex);
+        mObjectPaging->mPendingChunks.erase(mId);
+    }
+
+private:
+    ObjectPaging* mObjectPaging;
+    std::string mId;
+    float mSize;
+    osg::Vec2f mCenter;
+};
+
+ObjectPaging::ObjectPaging(Resource::SceneManager *sceneManager, const MWWorld::ESMStore &store, MWWorld::ESMReaderPool *readerPool, SceneUtil::WorkQueue *workQueue)
+    : ResourceManager(NULL)
+    , mSceneManager(sceneManager)
+    , mStore(store)
+    , mReaderPool(readerPool)
+    , mWorkQueue(workQueue)
+    , mMinSize(Settings::Manager::getFloat("object paging min size", "Terrain"))
+{
+    const MWWorld::Store<ESM::Cell>& cells = mStore.get<ESM::Cell>();
+    for (MWWorld::Store<ESM::Cell>::iterator it = cells.extBegin(); it != cells.extEnd(); ++it)
+        mCells[std::make_pair(it->getGridX(), it->getGridY())] = &*it;
+}
+
+ObjectPaging::~ObjectPaging()
+{
+    // the work items refer to us, so wait for the ones that are still queued or running
+    waitForPendingChunks();
+}
+
+void ObjectPaging::waitForPendingChunks()
+{
+    PendingChunks pending;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+        pending = mPendingChunks;
+    }
+    for (PendingChunks::iterator it = pending.begin(); it != pending.end(); ++it)
+        it->second->waitTillDone();
+}
+
+std::string ObjectPaging::getChunkId(float size, const osg::Vec2f &center) const
+{
+    std::ostringstream stream;
+    stream << size << " " << center.x() << " " << center.y();
+    return stream.str();
+}
+
+osg::ref_ptr<osg::Node> ObjectPaging::requestChunk(float size, const osg::Vec2f &center)
+{
+    std::string id = getChunkId(size, center);
+
+    osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(id);
+    if (obj)
+        return obj->asNode();
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+    if (mPendingChunks.find(id) != mPendingChunks.end())
+        return NULL;
+
+    // the work item may have finished between the cache lookup and taking the lock
+    obj = mCache->getRefFromObjectCache(id);
+    if (obj)
+        return obj->asNode();
+
+    osg::ref_ptr<CreateObjectChunkWorkItem> workItem = new CreateObjectChunkWorkItem(this, id, size, center);
+    mPendingChunks[id] = workItem;
+    mWorkQueue->addWorkItem(workItem);
+    return NULL;
+}
+
+osg::ref_ptr<osg::Node> ObjectPaging::createChunk(float size, const osg::Vec2f &center)
+{
+    Misc::ProfileZone zone("Object chunk");
+
+    int numCells = std::max(1, static_cast<int>(std::floor(size + 0.5f)));
+    int startX = static_cast<int>(std::floor(center.x() - size/2.f + 0.5f));
+    int startY = static_cast<int>(std::floor(center.y() - size/2.f + 0.5f));
+
+    osg::Vec3f worldCenter (center.x() * sCellSize, center.y() * sCellSize, 0.f);
+    float minRadius = size * sCellSize * mMinSize / 2.f;
+
+    osg::ref_ptr<osg::Group> group (new osg::Group);
+
+    const MWWorld::Store<ESM::Static>& statics = mStore.get<ESM::Static>();
+    for (int x=startX; x<startX+numCells; ++x)
+    {
+        for (int y=startY; y<startY+numCells; ++y)
+        {
+            std::map<std::pair<int, int>, const ESM::Cell*>::const_iterator found = mCells.find(std::make_pair(x, y));
+            if (found == mCells.end())
+                continue;
+
+            ESM::CellRefTracker refs;
+            {
+                MWWorld::ESMReaderPool::ScopedReaders readers (*mReaderPool);
+                MWWorld::CellStore::readRefs(found->second, readers.get(), refs);
+            }
+
+            // later content files override or delete the references of earlier ones
+            std::map<ESM::RefNum, ESM::CellRef> merged;
+            std::vector<ESM::CellRef> unnumbered;
+            for (ESM::CellRefTracker::const_iterator it = refs.begin(); it != refs.end(); ++it)
+            {
+                if (!it->first.mRefNum.hasContentFile())
+                    unnumbered.push_back(it->first);
+                else if (it->second)
+                    merged.erase(it->first.mRefNum);
+                else
+                    merged[it->first.mRefNum] = it->first;
+            }
+            for (std::map<ESM::RefNum, ESM::CellRef>::const_iterator it = merged.begin(); it != merged.end(); ++it)
+                unnumbered.push_back(it->second);
+
+            for (std::vector<ESM::CellRef>::const_iterator it = unnumbered.begin(); it != unnumbered.end(); ++it)
+            {
+                const ESM::Static* stat = statics.search(it->mRefID);
+                if (!stat || stat->mModel.empty())
+                    continue;
+
+                osg::ref_ptr<const osg::Node> templateNode;
+                try
+                {
+                    templateNode = mSceneManager->getTemplate("meshes\\" + stat->mModel);
+                }
+                catch (std::exception& e)
+                {
+                    std::cerr << "Failed to load model for distant object " << it->mRefID << ": " << e.what() << std::endl;
+                    continue;
+                }
+
+                osg::ref_ptr<osg::Node> copy = createObjectCopy(templateNode, *it, worldCenter);
+                if (copy->getBound().radius() < minRadius)
+                    continue;
+                group->addChild(copy);
+            }
+        }
+    }
+
+    if (group->getNumChildren() == 0)
+        return group;
+
+    // the copies are not shared, so the transforms can be flattened into the vertices and the geometry merged by state
+    SceneUtil::Optimizer optimizer;
+    optimizer.optimize(group, SceneUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS | SceneUtil::Optimizer::REMOVE_REDUNDANT_NODES
+                       | SceneUtil::Optimizer::MERGE_GEOMETRY);
+
+    osg::ref_ptr<SceneUtil::PositionAttitudeTransform> pat (new SceneUtil::PositionAttitudeTransform);
+    pat->setPosition(worldCenter);
+    pat->addChild(group);
+    return pat;
+}
+
+void ObjectPaging::reportStats(unsigned int frameNumber, osg::Stats *stats) const
+{
+    stats->setAttribute(frameNumber, "Object Chunk", mCache->getCacheSize());
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+    stats->setAttribute(frameNumber, "Object Pending", mPendingChunks.size());
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef OPENMW_MWRENDER_OBJECTPAGING_H
+#define OPENMW_MWRENDER_OBJECTPAGING_H
+
+#include <map>
+
+#include <OpenThreads/Mutex>
+
+#include <components/resource/resourcemanager.hpp>
+#include <components/terrain/quadtreeworld.hpp>
+
+namespace ESM
+{
+    struct Cell;
+}
+
+namespace Resource
+{
+    class SceneManager;
+}
+
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
+namespace MWWorld
+{
+    class ESMStore;
+    class ESMReaderPool;
+}
+
+namespace MWRender
+{
+
+    class CreateObjectChunkWorkItem;
+
+    /// @brief Creates merged, static geometry of the objects in distant cells, to be rendered with the distant terrain.
+    /// @par Only the statics of the exterior cells are included, as they are placed in the content files. Objects that are
+    ///  small compared to the chunk are left out, so that larger, more distant chunks get coarser.
+    class ObjectPaging : public Resource::ResourceManager, public Terrain::QuadTreeWorld::ObjectChunkManager
+    {
+    public:
+        ObjectPaging(Resource::SceneManager* sceneManager, const MWWorld::ESMStore& store, MWWorld::ESMReaderPool* readerPool, SceneUtil::WorkQueue* workQueue);
+        ~ObjectPaging();
+
+        virtual osg::ref_ptr<osg::Node> requestChunk(float size, const osg::Vec2f& center);
+
+        /// Wait until all requested chunks have been created.
+        void waitForPendingChunks();
+
+        virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
+
+    private:
+        friend class CreateObjectChunkWorkItem;
+
+        std::string getChunkId(float size, const osg::Vec2f& center) const;
+
+        osg::ref_ptr<osg::Node> createChunk(float size, const osg::Vec2f& center);
+
+        Resource::SceneManager* mSceneManager;
+        const MWWorld::ESMStore& mStore;
+        osg::ref_ptr<MWWorld::ESMReaderPool> mReaderPool;
+        osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        /// Objects smaller than this fraction of the chunk width are left out
+        float mMinSize;
+
+        /// The exterior cells from the content files. The store of cells may grow while we're reading from worker threads,
+        /// so we keep our own index of them.
+        std::map<std::pair<int, int>, const ESM::Cell*> mCells;
+
+        typedef std::map<std::string, osg::ref_ptr<CreateObjectChunkWorkItem> > PendingChunks;
+        PendingChunks mPendingChunks;
+        mutable OpenThreads::Mutex mPendingChunksMutex;
+    };
+
+}
+
+#endif
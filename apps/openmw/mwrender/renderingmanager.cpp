@@ -49,6 +49,7 @@
 #include "camera.hpp"
 #include "water.hpp"
 #include "terrainstorage.hpp"
+#include "objectpaging.hpp"
 #include "util.hpp"
 
 namespace MWRender
@@ -219,7 +220,11 @@ namespace MWRender
                                              Settings::Manager::getBool("auto use terrain specular maps", "Shaders"));
 
         if (distantTerrain)
-            mTerrain.reset(new Terrain::QuadTreeWorld(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage, Mask_Terrain, Mask_PreCompile));
+        {
+            Terrain::QuadTreeWorld* quadTreeWorld = new Terrain::QuadTreeWorld(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage, Mask_Terrain, Mask_PreCompile);
+            quadTreeWorld->setWorkQueue(mWorkQueue.get());
+            mTerrain.reset(quadTreeWorld);
+        }
         else
             mTerrain.reset(new Terrain::TerrainGrid(sceneRoot, mRootNode, mResourceSystem, mTerrainStorage, Mask_Terrain, Mask_PreCompile));
 
@@ -289,6 +294,9 @@ namespace MWRender
     {
         // let background loading thread finish before we delete anything else
         mWorkQueue = NULL;
+
+        if (mObjectPaging)
+            mResourceSystem->removeResourceManager(mObjectPaging.get());
     }
 
     MWRender::Objects& RenderingManager::getObjects()
@@ -334,6 +342,16 @@ namespace MWRender
         mWorkQueue->addWorkItem(workItem);
     }
 
+    void RenderingManager::initObjectPaging(const MWWorld::ESMStore &store, MWWorld::ESMReaderPool *readerPool)
+    {
+        if (!Settings::Manager::getBool("distant terrain", "Terrain") || !Settings::Manager::getBool("object paging", "Terrain"))
+            return;
+
+        mObjectPaging.reset(new ObjectPaging(mResourceSystem->getSceneManager(), store, readerPool, mWorkQueue.get()));
+        mResourceSystem->addResourceManager(mObjectPaging.get());
+        static_cast<Terrain::QuadTreeWorld*>(mTerrain.get())->setObjectChunkManager(mObjectPaging.get());
+    }
+
     double RenderingManager::getReferenceTime() const
     {
         return mViewer->getFrameStamp()->getReferenceTime();
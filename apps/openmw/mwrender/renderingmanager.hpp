@@ -48,6 +48,12 @@ namespace Fallback
     class Map;
 }
 
+namespace MWWorld
+{
+    class ESMStore;
+    class ESMReaderPool;
+}
+
 namespace SceneUtil
 {
     class WorkQueue;
@@ -67,6 +73,7 @@ namespace MWRender
     class Water;
     class TerrainStorage;
     class LandManager;
+    class ObjectPaging;
 
     class RenderingManager : public MWRender::RenderingInterface
     {
@@ -85,6 +92,10 @@ namespace MWRender
 
         void preloadCommonAssets();
 
+        /// Render the statics of distant cells along with the distant terrain, if enabled in the settings.
+        /// @note Must be called once the content files are loaded.
+        void initObjectPaging(const MWWorld::ESMStore& store, MWWorld::ESMReaderPool* readerPool);
+
         double getReferenceTime() const;
 
         osg::Group* getLightRoot();
@@ -227,6 +238,8 @@ namespace MWRender
         std::unique_ptr<Pathgrid> mPathgrid;
         std::unique_ptr<Objects> mObjects;
         std::unique_ptr<Water> mWater;
+        // must outlive the terrain, which renders its chunks
+        std::unique_ptr<ObjectPaging> mObjectPaging;
         std::unique_ptr<Terrain::World> mTerrain;
         TerrainStorage* mTerrainStorage;
         std::unique_ptr<SkyManager> mSky;
@@ -9,6 +9,7 @@
 #include <components/esm/loadscpt.hpp>
 
 #include <components/misc/stringops.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/compiler/scanner.hpp>
 #include <components/compiler/context.hpp>
@@ -90,6 +91,8 @@ namespace MWScript
 
     void ScriptManager::run (const std::string& name, Interpreter::Context& interpreterContext)
     {
+        Misc::ProfileZone zone("Script");
+
         // compile script
         ScriptCollection::iterator iter = mScripts.find (name);
 
@@ -7,6 +7,7 @@
 #include <osg/Matrixf>
 
 #include <components/misc/rng.hpp>
+#include <components/misc/profiler.hpp>
 
 #include <components/vfs/manager.hpp>
 
@@ -1031,6 +1032,8 @@ namespace MWSound
 
     void SoundManager::update(float duration)
     {
+        Misc::ProfileZone zone("SoundManager");
+
         if(!mOutput->isInitialized())
             return;
 
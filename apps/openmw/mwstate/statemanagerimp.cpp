@@ -9,10 +9,15 @@
 
 #include <components/settings/settings.hpp>
 
+#include <components/sceneutil/workqueue.hpp>
+
 #include <osg/Image>
 
 #include <osgDB/Registry>
 
+#include <OpenThreads/Atomic>
+#include <OpenThreads/Thread>
+
 #include <boost/filesystem/fstream.hpp>
 #include <boost/filesystem/operations.hpp>
 
@@ -31,16 +36,148 @@
 #include "../mwworld/cellstore.hpp"
 #include "../mwworld/esmstore.hpp"
 #include "../mwworld/inventorystore.hpp"
+#include "../mwworld/savedcells.hpp"
 
 #include "../mwmechanics/npcstats.hpp"
 #include "../mwmechanics/actorutil.hpp"
+#include "../mwmechanics/pathfindingqueue.hpp"
 
 #include "../mwscript/globalscripts.hpp"
 
+namespace MWState
+{
+    /// Worker thread item: serialize the captured cells of a saved game and write it to its file.
+    class SaveGameWriter : public SceneUtil::WorkItem
+    {
+    public:
+        /// @param data The saved game without the cell records, taken over by the writer.
+        /// @param cells The cells to write at cells.mPosition in \a data, taken over by the writer.
+        SaveGameWriter(const boost::filesystem::path& path, std::string& data, MWWorld::SavedCells& cells)
+            : mPath(path)
+            , mProgress(0)
+        {
+            mData.swap(data);
+            mCells.mCells.swap(cells.mCells);
+            mCells.mPosition = cells.mPosition;
+        }
+
+        virtual void doWork()
+        {
+            // Write to a temporary file and move it into place when complete, so that a failed or interrupted write
+            // doesn't trash the existing save file we are overwriting.
+            boost::filesystem::path tmpPath (mPath.string() + ".tmp");
+            try
+            {
+                insertCells();
+
+                {
+                    boost::filesystem::ofstream filestream (tmpPath, std::ios::binary | std::ios::trunc);
+
+                    const size_t chunkSize = 1024*1024;
+                    for (size_t pos = 0; pos < mData.size(); pos += chunkSize)
+                    {
+                        size_t size = std::min(chunkSize, mData.size() - pos);
+                        filestream.write(&mData[pos], size);
+                        if (filestream.fail())
+                            throw std::runtime_error("Write operation failed (file stream)");
+                        setProgress(0.5f + 0.5f * (pos + size) / mData.size());
+                    }
+
+                    filestream.close();
+                    if (filestream.fail())
+                        throw std::runtime_error("Write operation failed (file stream)");
+                }
+
+                boost::filesystem::rename(tmpPath, mPath);
+            }
+            catch (const std::exception& e)
+            {
+                mError = e.what();
+
+                boost::system::error_code ec;
+                boost::filesystem::remove(tmpPath, ec);
+            }
+
+            std::string().swap(mData);
+            std::vector<MWWorld::SavedCell>().swap(mCells.mCells);
+        }
+
+        const boost::filesystem::path& getPath() const
+        {
+            return mPath;
+        }
+
+        /// Fraction of the work that is done, can be called at any time.
+        float getProgress() const
+        {
+            return static_cast<unsigned int>(mProgress) / 1000.f;
+        }
+
+        /// @return Empty if the file was written successfully.
+        /// @note Only valid once isDone() returns true.
+        const std::string& getError() const
+        {
+            return mError;
+        }
+
+    private:
+        /// Serialize the cells and insert their records into mData.
+        void insertCells()
+        {
+            if (mCells.mCells.empty())
+                return;
+
+            // The cell records are written with a writer of their own. Its header is dropped, the header in
+            // mData already counts the cells.
+            std::ostringstream stream;
+
+            ESM::ESMWriter writer;
+            writer.setFormat (ESM::SavedGame::sCurrentFormat);
+            writer.setVersion(0);
+            writer.setType(0);
+            writer.setAuthor("");
+            writer.setDescription("");
+            writer.save (stream);
+
+            std::streamoff headerSize = stream.tellp();
+
+            for (size_t i = 0; i < mCells.mCells.size(); ++i)
+            {
+                mCells.mCells[i].write (writer);
+                setProgress(0.5f * (i + 1) / mCells.mCells.size());
+            }
+
+            writer.close();
+
+            if (stream.fail())
+                throw std::runtime_error("Write operation failed (memory stream)");
+
+            std::string records = stream.str();
+            mData.insert(static_cast<size_t>(static_cast<std::streamoff>(mCells.mPosition)),
+                         records, static_cast<size_t>(headerSize), std::string::npos);
+        }
+
+        void setProgress(float progress)
+        {
+            mProgress.exchange(static_cast<unsigned int>(progress * 1000));
+        }
+
+        boost::filesystem::path mPath;
+        std::string mData;
+        MWWorld::SavedCells mCells;
+        /// In thousandths, set by the worker thread
+        OpenThreads::Atomic mProgress;
+        std::string mError;
+    };
+}
+
 void MWState::StateManager::cleanup (bool force)
 {
     if (mState!=State_NoGame || force)
     {
+        // path searches in flight refer to cells that are about to be cleared
+        MWBase::Environment::get().getMechanicsManager()->getPathfindingQueue()->clear();
+
         MWBase::Environment::get().getSoundManager()->clear();
         MWBase::Environment::get().getDialogueManager()->clear();
         MWBase::Environment::get().getJournal()->clear();
@@ -83,10 +220,89 @@ std::map<int, int> MWState::StateManager::buildContentFileIndexMap (const ESM::E
     return map;
 }
 
-MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game)
+MWState::StateManager::StateManager (const boost::filesystem::path& saves, const std::string& game, SceneUtil::WorkQueue* workQueue)
 : mQuitRequest (false), mAskLoadRecent(false), mState (State_NoGame), mCharacterManager (saves, game), mTimePlayed (0)
+, mWorkQueue (workQueue), mPendingSaveCharacter (NULL)
+{
+
+}
+
+MWState::StateManager::~StateManager()
+{
+    if (mPendingSave)
+    {
+        mPendingSave->waitTillDone();
+        if (!mPendingSave->getError().empty())
+            std::cerr << "Failed to save game: " << mPendingSave->getError() << std::endl;
+    }
+}
+
+void MWState::StateManager::writeSaveFile (osg::ref_ptr<SaveGameWriter> writer, Character* character)
+{
+    mPendingSave = writer;
+    mPendingSaveCharacter = character;
+
+    if (mWorkQueue)
+        mWorkQueue->addWorkItem(writer, true);
+    else
+    {
+        writer->doWork();
+        writer->signalDone();
+    }
+}
+
+void MWState::StateManager::finishPendingSave (bool wait)
 {
+    if (!mPendingSave)
+        return;
+
+    if (wait && !mPendingSave->isDone())
+    {
+        Loading::Listener& listener = *MWBase::Environment::get().getWindowManager()->getLoadingScreen();
+        listener.setLabel("#{sNotifyMessage4}", true);
+        listener.setProgressRange(100);
+
+        Loading::ScopedLoad load(&listener);
+        while (!mPendingSave->isDone())
+        {
+            listener.setProgress(static_cast<size_t>(mPendingSave->getProgress() * 100));
+            OpenThreads::Thread::microSleep(10000);
+        }
+    }
+
+    if (!mPendingSave->isDone())
+        return;
+
+    osg::ref_ptr<SaveGameWriter> save = mPendingSave;
+    Character* character = mPendingSaveCharacter;
+    mPendingSave = NULL;
+    mPendingSaveCharacter = NULL;
+
+    if (save->getError().empty())
+        return;
+
+    std::stringstream error;
+    error << "Failed to save game: " << save->getError();
+
+    std::cerr << error.str() << std::endl;
+
+    std::vector<std::string> buttons;
+    buttons.push_back("#{sOk}");
+    MWBase::Environment::get().getWindowManager()->interactiveMessageBox(error.str(), buttons);
 
+    // If no file was written, clean up the slot
+    if (character && !boost::filesystem::exists(save->getPath()))
+    {
+        for (Character::SlotIterator it = character->begin(); it != character->end(); ++it)
+        {
+            if (it->mPath == save->getPath())
+            {
+                character->deleteSlot(&*it);
+                character->cleanup();
+                break;
+            }
+        }
+    }
 }
 
 void MWState::StateManager::requestQuit()
@@ -170,6 +386,9 @@ void MWState::StateManager::endGame()
 
 void MWState::StateManager::saveGame (const std::string& description, const Slot *slot)
 {
+    // one save at a time, the slot of the previous one may still change
+    finishPendingSave(true);
+
     MWState::Character* character = getCurrentCharacter();
 
     try
@@ -221,7 +440,10 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         // Write to a memory stream first. If there is an exception during the save process, we don't want to trash the
         // existing save file we are overwriting.
+        // The cells are by far the largest part of a saved game. They are only captured here and serialized along
+        // with the file I/O on a background thread.
         std::stringstream stream;
+        MWWorld::SavedCells cells;
 
         ESM::ESMWriter writer;
 
@@ -265,27 +487,26 @@ void MWState::StateManager::saveGame (const std::string& description, const Slot
 
         MWBase::Environment::get().getJournal()->write (writer, listener);
         MWBase::Environment::get().getDialogueManager()->write (writer, listener);
-        MWBase::Environment::get().getWorld()->write (writer, listener);
+        MWBase::Environment::get().getWorld()->write (writer, listener, &cells);
         MWBase::Environment::get().getScriptManager()->getGlobalScripts().write (writer, listener);
         MWBase::Environment::get().getWindowManager()->write(writer, listener);
         MWBase::Environment::get().getMechanicsManager()->write(writer, listener);
         MWBase::Environment::get().getInputManager()->write(writer, listener);
 
         // Ensure we have written the number of records that was estimated
-        if (writer.getRecordCount() != recordCount+1) // 1 extra for TES3 record
-            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writer.getRecordCount() << std::endl;
+        int writtenCount = writer.getRecordCount() + static_cast<int>(cells.mCells.size());
+        if (writtenCount != recordCount+1) // 1 extra for TES3 record
+            std::cerr << "Warning: number of written savegame records does not match. Estimated: " << recordCount+1 << ", written: " << writtenCount << std::endl;
 
         writer.close();
 
         if (stream.fail())
             throw std::runtime_error("Write operation failed (memory stream)");
 
-        // All good, write to file
-        boost::filesystem::ofstream filestream (slot->mPath, std::ios::binary);
-        filestream << stream.rdbuf();
-
-        if (filestream.fail())
-            throw std::runtime_error("Write operation failed (file stream)");
+        // All good, the game state is captured. Leave the cell records and the file I/O to a background thread,
+        // errors are reported by finishPendingSave.
+        std::string data = stream.str();
+        writeSaveFile(new SaveGameWriter(slot->mPath, data, cells), character);
 
         Settings::Manager::setString ("character", "Saves",
             slot->mPath.parent_path().filename().string());
@@ -359,6 +580,8 @@ void MWState::StateManager::loadGame(const std::string& filepath)
 
 void MWState::StateManager::loadGame (const Character *character, const std::string& filepath)
 {
+    finishPendingSave(true);
+
     try
     {
         cleanup();
@@ -557,6 +780,10 @@ void MWState::StateManager::quickLoad()
 
 void MWState::StateManager::deleteGame(const MWState::Character *character, const MWState::Slot *slot)
 {
+    // don't report the result yet, that could invalidate the slot
+    if (mPendingSave)
+        mPendingSave->waitTillDone();
+
     mCharacterManager.deleteSlot(character, slot);
 }
 
@@ -579,6 +806,8 @@ void MWState::StateManager::update (float duration)
 {
     mTimePlayed += duration;
 
+    finishPendingSave(false);
+
     // Note: It would be nicer to trigger this from InputManager, i.e. the very beginning of the frame update.
     if (mAskLoadRecent)
     {
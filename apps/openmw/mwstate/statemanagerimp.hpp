@@ -3,14 +3,23 @@
 
 #include <map>
 
+#include <osg/ref_ptr>
+
 #include "../mwbase/statemanager.hpp"
 
 #include <boost/filesystem/path.hpp>
 
 #include "charactermanager.hpp"
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace MWState
 {
+    class SaveGameWriter;
+
     class StateManager : public MWBase::StateManager
     {
             bool mQuitRequest;
@@ -19,10 +28,22 @@ namespace MWState
             CharacterManager mCharacterManager;
             double mTimePlayed;
 
+            osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+            // Saved game that is being written to disk in the background
+            osg::ref_ptr<SaveGameWriter> mPendingSave;
+            Character* mPendingSaveCharacter;
+
         private:
 
             void cleanup (bool force = false);
 
+            void writeSaveFile (osg::ref_ptr<SaveGameWriter> writer, Character* character);
+            ///< Write the file on the work queue if there is one, otherwise right away.
+
+            void finishPendingSave (bool wait);
+            ///< Report the result of the background save, if it is done or \a wait is true.
+
             bool verifyProfile (const ESM::SavedGame& profile) const;
 
             void writeScreenshot (std::vector<char>& imageData) const;
@@ -31,7 +52,10 @@ namespace MWState
 
         public:
 
-            StateManager (const boost::filesystem::path& saves, const std::string& game);
+            /// @param workQueue Used for writing saved games in the background, may be NULL.
+            StateManager (const boost::filesystem::path& saves, const std::string& game, SceneUtil::WorkQueue* workQueue);
+
+            virtual ~StateManager();
 
             virtual void requestQuit();
 
@@ -54,6 +78,8 @@ namespace MWState
             virtual void saveGame (const std::string& description, const Slot *slot = 0);
             ///< Write a saved game to \a slot or create a new slot if \a slot == 0.
             ///
+            /// The game state is serialized right away, writing the file is finished in the background.
+            ///
             /// \note Slot must belong to the current character.
 
             ///Saves a file, using supplied filename, overwritting if needed
@@ -2,12 +2,15 @@
 
 #include <iostream>
 
+#include <OpenThreads/ScopedLock>
+
 #include <components/resource/scenemanager.hpp>
 #include <components/resource/resourcesystem.hpp>
 #include <components/resource/bulletshapemanager.hpp>
 #include <components/resource/keyframemanager.hpp>
 #include <components/misc/resourcehelpers.hpp>
 #include <components/misc/stringops.hpp>
+#include <components/misc/profiler.hpp>
 #include <components/nifosg/nifloader.hpp>
 #include <components/terrain/world.hpp>
 #include <components/esmterrain/storage.hpp>
@@ -20,6 +23,7 @@
 #include "../mwrender/landmanager.hpp"
 
 #include "cellstore.hpp"
+#include "esmreaderpool.hpp"
 #include "manualref.hpp"
 #include "class.hpp"
 
@@ -90,6 +94,8 @@ namespace MWWorld
         /// Preload work to be called from the worker thread.
         virtual void doWork()
         {
+            Misc::ProfileZone zone("Preload cell");
+
             if (mIsExterior)
             {
                 try
@@ -168,6 +174,51 @@ namespace MWWorld
         std::vector<osg::ref_ptr<const osg::Object> > mPreloadedObjects;
     };
 
+    /// Worker thread item: read the references of a cell from the content files.
+    class ReadRefsItem : public SceneUtil::WorkItem
+    {
+    public:
+        /// Constructor to be called from the main thread.
+        ReadRefsItem(const ESM::Cell* cell, ESMReaderPool* readerPool, const std::shared_ptr<PreparedRefs>& refs)
+            : mCell(cell)
+            , mReaderPool(readerPool)
+            , mRefs(refs)
+            , mAbort(false)
+        {
+        }
+
+        virtual void abort()
+        {
+            mAbort = true;
+        }
+
+        virtual void doWork()
+        {
+            if (mAbort)
+                return;
+
+            Misc::ProfileZone zone("Read cell references");
+
+            ESM::CellRefTracker refs;
+            {
+                ESMReaderPool::ScopedReaders readers (*mReaderPool);
+                CellStore::readRefs(mCell, readers.get(), refs);
+            }
+
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mRefs->mMutex);
+            mRefs->mRefs.swap(refs);
+            mRefs->mReady = true;
+        }
+
+    private:
+        // the ESM::Cell record is owned by the ESMStore, unlike the CellStore it can't go away while we're working
+        const ESM::Cell* mCell;
+        osg::ref_ptr<ESMReaderPool> mReaderPool;
+        std::shared_ptr<PreparedRefs> mRefs;
+
+        volatile bool mAbort;
+    };
+
     /// Worker thread item: update the resource system's cache, effectively deleting unused entries.
     class UpdateCacheItem : public SceneUtil::WorkItem
     {
@@ -232,17 +283,19 @@ namespace MWWorld
             std::cerr << "Error: can't preload, no work queue set " << std::endl;
             return;
         }
-        if (cell->getState() == CellStore::State_Unloaded)
-        {
-            std::cerr << "Error: can't preload objects for unloaded cell" << std::endl;
-            return;
-        }
 
         PreloadMap::iterator found = mPreloadCells.find(cell);
         if (found != mPreloadCells.end())
         {
-            // already preloaded, nothing to do other than updating the timestamp
+            // already preloaded or being preloaded, update the timestamp
             found->second.mTimeStamp = timestamp;
+
+            // once the references are read, we can list the models to preload
+            if (found->second.mReadingRefs && found->second.mWorkItem->isDone())
+            {
+                found->second.mWorkItem = createPreloadItem(cell);
+                found->second.mReadingRefs = false;
+            }
             return;
         }
 
@@ -264,16 +317,37 @@ namespace MWWorld
             if (oldestTimestamp + threshold < timestamp)
             {
                 oldestCell->second.mWorkItem->abort();
+                oldestCell->first->setPreparedRefs(std::shared_ptr<PreparedRefs>());
                 mPreloadCells.erase(oldestCell);
             }
             else
                 return;
         }
 
+        if (cell->getState() == CellStore::State_Unloaded && mReaderPool && !cell->getCell()->mContextList.empty())
+        {
+            std::shared_ptr<PreparedRefs> refs = std::make_shared<PreparedRefs>();
+            cell->setPreparedRefs(refs);
+
+            osg::ref_ptr<ReadRefsItem> item (new ReadRefsItem(cell->getCell(), mReaderPool, refs));
+            mWorkQueue->addWorkItem(item);
+
+            mPreloadCells[cell] = PreloadEntry(timestamp, item, true);
+            return;
+        }
+
+        mPreloadCells[cell] = PreloadEntry(timestamp, createPreloadItem(cell));
+    }
+
+    osg::ref_ptr<SceneUtil::WorkItem> CellPreloader::createPreloadItem(CellStore *cell)
+    {
+        // list the object IDs, using the prepared references if there are any
+        if (cell->getState() == CellStore::State_Unloaded)
+            cell->preload();
+
         osg::ref_ptr<PreloadItem> item (new PreloadItem(cell, mResourceSystem->getSceneManager(), mBulletShapeManager, mResourceSystem->getKeyframeManager(), mTerrain, mLandManager, mPreloadInstances));
         mWorkQueue->addWorkItem(item);
-
-        mPreloadCells[cell] = PreloadEntry(timestamp, item);
+        return item;
     }
 
     void CellPreloader::notifyLoaded(CellStore *cell)
@@ -302,6 +376,7 @@ namespace MWWorld
                 mUnrefQueue->push(it->second.mWorkItem);
             }
 
+            it->first->setPreparedRefs(std::shared_ptr<PreparedRefs>());
             mPreloadCells.erase(it++);
         }
     }
@@ -317,6 +392,7 @@ namespace MWWorld
                     it->second.mWorkItem->abort();
                     mUnrefQueue->push(it->second.mWorkItem);
                 }
+                it->first->setPreparedRefs(std::shared_ptr<PreparedRefs>());
                 mPreloadCells.erase(it++);
             }
             else
@@ -362,6 +438,11 @@ namespace MWWorld
         mWorkQueue = workQueue;
     }
 
+    void CellPreloader::setReaderPool(ESMReaderPool *readerPool)
+    {
+        mReaderPool = readerPool;
+    }
+
     void CellPreloader::setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue)
     {
         mUnrefQueue = unrefQueue;
@@ -380,6 +461,8 @@ namespace MWWorld
 
         virtual void doWork()
         {
+            Misc::ProfileZone zone("Preload terrain");
+
             for (unsigned int i=0; i<mTerrainViews.size() && i<mPreloadPositions.size() && !mAbort; ++i)
             {
                 mWorld->preload(mTerrainViews[i], mPreloadPositions[i]);
@@ -31,6 +31,7 @@ namespace MWRender
 namespace MWWorld
 {
     class CellStore;
+    class ESMReaderPool;
 
     class CellPreloader
     {
@@ -39,7 +40,9 @@ namespace MWWorld
         ~CellPreloader();
 
         /// Ask a background thread to preload rendering meshes and collision shapes for objects in this cell.
-        /// @note The cell itself must be in State_Loaded or State_Preloaded.
+        /// @note If the cell is in State_Unloaded, its references are read in the background first (see setReaderPool),
+        /// and the models are only preloaded once a later call finds that done. The main thread then only has to insert
+        /// the references when the cell gets loaded.
         void preload(MWWorld::CellStore* cell, double timestamp);
 
         void notifyLoaded(MWWorld::CellStore* cell);
@@ -65,6 +68,10 @@ namespace MWWorld
 
         void setWorkQueue(osg::ref_ptr<SceneUtil::WorkQueue> workQueue);
 
+        /// Set the readers to use for reading the references of unloaded cells in the background.
+        /// If not set, the references are read in the main thread.
+        void setReaderPool(ESMReaderPool* readerPool);
+
         void setUnrefQueue(SceneUtil::UnrefQueue* unrefQueue);
 
         void setTerrainPreloadPositions(const std::vector<osg::Vec3f>& positions);
@@ -75,6 +82,7 @@ namespace MWWorld
         Terrain::World* mTerrain;
         MWRender::LandManager* mLandManager;
         osg::ref_ptr<SceneUtil::WorkQueue> mWorkQueue;
+        osg::ref_ptr<ESMReaderPool> mReaderPool;
         osg::ref_ptr<SceneUtil::UnrefQueue> mUnrefQueue;
         double mExpiryDelay;
         unsigned int mMinCacheSize;
@@ -85,20 +93,26 @@ namespace MWWorld
 
         struct PreloadEntry
         {
-            PreloadEntry(double timestamp, osg::ref_ptr<SceneUtil::WorkItem> workItem)
+            PreloadEntry(double timestamp, osg::ref_ptr<SceneUtil::WorkItem> workItem, bool readingRefs = false)
                 : mTimeStamp(timestamp)
                 , mWorkItem(workItem)
+                , mReadingRefs(readingRefs)
             {
             }
             PreloadEntry()
                 : mTimeStamp(0.0)
+                , mReadingRefs(false)
             {
             }
 
             double mTimeStamp;
             osg::ref_ptr<SceneUtil::WorkItem> mWorkItem;
+            // mWorkItem is reading the references of the cell, the models are not being preloaded yet
+            bool mReadingRefs;
         };
-        typedef std::map<const MWWorld::CellStore*, PreloadEntry> PreloadMap;
+
+        osg::ref_ptr<SceneUtil::WorkItem> createPreloadItem(MWWorld::CellStore* cell);
+        typedef std::map<MWWorld::CellStore*, PreloadEntry> PreloadMap;
 
         // Cells that are currently being preloaded, or have already finished preloading
         PreloadMap mPreloadCells;
@@ -16,6 +16,7 @@
 #include "esmstore.hpp"
 #include "containerstore.hpp"
 #include "cellstore.hpp"
+#include "savedcells.hpp"
 
 MWWorld::CellStore *MWWorld::Cells::getCellStore (const ESM::Cell *cell)
 {
@@ -70,21 +71,12 @@ MWWorld::Ptr MWWorld::Cells::getPtrAndCache (const std::string& name, CellStore&
     return ptr;
 }
 
-void MWWorld::Cells::writeCell (ESM::ESMWriter& writer, CellStore& cell) const
+void MWWorld::Cells::saveCell (SavedCell& saved, CellStore& cell) const
 {
     if (cell.getState()!=CellStore::State_Loaded)
         cell.load ();
 
-    ESM::CellState cellState;
-
-    cell.saveState (cellState);
-
-    writer.startRecord (ESM::REC_CSTA);
-    cellState.mId.save (writer);
-    cellState.save (writer);
-    cell.writeFog(writer);
-    cell.writeReferences (writer);
-    writer.endRecord (ESM::REC_CSTA);
+    cell.save (saved);
 }
 
 MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader)
@@ -93,7 +85,7 @@ MWWorld::Cells::Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReade
   mIdCacheIndex (0)
 {}
 
-MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
+MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y, bool load)
 {
     std::map<std::pair<int, int>, CellStore>::iterator result =
         mExteriors.find (std::make_pair (x, y));
@@ -124,7 +116,7 @@ MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
             std::make_pair (x, y), CellStore (cell, mStore, mReader))).first;
     }
 
-    if (result->second.getState()!=CellStore::State_Loaded)
+    if (load && result->second.getState()!=CellStore::State_Loaded)
     {
         result->second.load ();
     }
@@ -132,7 +124,7 @@ MWWorld::CellStore *MWWorld::Cells::getExterior (int x, int y)
     return &result->second;
 }
 
-MWWorld::CellStore *MWWorld::Cells::getInterior (const std::string& name)
+MWWorld::CellStore *MWWorld::Cells::getInterior (const std::string& name, bool load)
 {
     std::string lowerName = Misc::StringUtils::lowerCase(name);
     std::map<std::string, CellStore>::iterator result = mInteriors.find (lowerName);
@@ -144,7 +136,7 @@ MWWorld::CellStore *MWWorld::Cells::getInterior (const std::string& name)
         result = mInteriors.insert (std::make_pair (lowerName, CellStore (cell, mStore, mReader))).first;
     }
 
-    if (result->second.getState()!=CellStore::State_Loaded)
+    if (load && result->second.getState()!=CellStore::State_Loaded)
     {
         result->second.load ();
     }
@@ -297,7 +289,33 @@ void MWWorld::Cells::write (ESM::ESMWriter& writer, Loading::Listener& progress)
         iter!=mExteriors.end(); ++iter)
         if (iter->second.hasState())
         {
-            writeCell (writer, iter->second);
+            SavedCell saved;
+            saveCell (saved, iter->second);
+            saved.write (writer);
+            progress.increaseProgress();
+        }
+
+    for (std::map<std::string, CellStore>::iterator iter (mInteriors.begin());
+        iter!=mInteriors.end(); ++iter)
+        if (iter->second.hasState())
+        {
+            SavedCell saved;
+            saveCell (saved, iter->second);
+            saved.write (writer);
+            progress.increaseProgress();
+        }
+}
+
+void MWWorld::Cells::save (SavedCells& cells, Loading::Listener& progress) const
+{
+    cells.mCells.reserve (countSavedGameRecords());
+
+    for (std::map<std::pair<int, int>, CellStore>::iterator iter (mExteriors.begin());
+        iter!=mExteriors.end(); ++iter)
+        if (iter->second.hasState())
+        {
+            cells.mCells.push_back (SavedCell());
+            saveCell (cells.mCells.back(), iter->second);
             progress.increaseProgress();
         }
 
@@ -305,7 +323,8 @@ void MWWorld::Cells::write (ESM::ESMWriter& writer, Loading::Listener& progress)
         iter!=mInteriors.end(); ++iter)
         if (iter->second.hasState())
         {
-            writeCell (writer, iter->second);
+            cells.mCells.push_back (SavedCell());
+            saveCell (cells.mCells.back(), iter->second);
             progress.increaseProgress();
         }
 }
@@ -23,6 +23,8 @@ namespace Loading
 namespace MWWorld
 {
     class ESMStore;
+    struct SavedCell;
+    struct SavedCells;
 
     /// \brief Cell container
     class Cells
@@ -41,7 +43,7 @@ namespace MWWorld
 
             Ptr getPtrAndCache (const std::string& name, CellStore& cellStore);
 
-            void writeCell (ESM::ESMWriter& writer, CellStore& cell) const;
+            void saveCell (SavedCell& saved, CellStore& cell) const;
 
         public:
 
@@ -49,9 +51,11 @@ namespace MWWorld
 
             Cells (const MWWorld::ESMStore& store, std::vector<ESM::ESMReader>& reader);
 
-            CellStore *getExterior (int x, int y);
+            CellStore *getExterior (int x, int y, bool load = true);
+            ///< \param load Load the references of the cell. If false, the cell may be in any state.
 
-            CellStore *getInterior (const std::string& name);
+            CellStore *getInterior (const std::string& name, bool load = true);
+            ///< \param load Load the references of the cell. If false, the cell may be in any state.
 
             CellStore *getCell (const ESM::CellId& id);
 
@@ -76,6 +80,9 @@ namespace MWWorld
 
             void write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
 
+            /// Like write(), but only capture the cells, so they can be written later without touching the game state.
+            void save (SavedCells& cells, Loading::Listener& progress) const;
+
             bool readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap);
     };
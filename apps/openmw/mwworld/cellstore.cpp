@@ -3,6 +3,8 @@
 #include <iostream>
 #include <algorithm>
 
+#include <OpenThreads/ScopedLock>
+
 #include <components/esm/cellstate.hpp>
 #include <components/esm/cellid.hpp>
 #include <components/esm/esmreader.hpp>
@@ -22,11 +24,23 @@
 
 #include "ptr.hpp"
 #include "esmstore.hpp"
+#include "savedcells.hpp"
 #include "class.hpp"
 #include "containerstore.hpp"
 
 namespace
 {
+    void listIds (const ESM::CellRefTracker& refs, std::vector<std::string>& ids)
+    {
+        for (ESM::CellRefTracker::const_iterator it = refs.begin(); it != refs.end(); ++it)
+        {
+            if (!it->second)
+                ids.push_back (Misc::StringUtils::lowerCase (it->first.mRefID));
+        }
+
+        std::sort (ids.begin(), ids.end());
+    }
+
     template<typename T>
     MWWorld::Ptr searchInContainerList (MWWorld::CellRefList<T>& containerList, const std::string& id)
     {
@@ -65,7 +79,7 @@ namespace
     }
 
     template<typename RecordType, typename T>
-    void writeReferenceCollection (ESM::ESMWriter& writer,
+    void saveReferenceCollection (MWWorld::SavedCell& cell,
         const MWWorld::CellRefList<T>& collection)
     {
         if (!collection.mList.empty())
@@ -86,13 +100,10 @@ namespace
                     continue;
                 }
 
-                RecordType state;
-                iter->save (state);
-
-                // recordId currently unused
-                writer.writeHNT ("OBJE", collection.mList.front().mBase->sRecordId);
+                std::shared_ptr<RecordType> state (new RecordType);
+                iter->save (*state);
 
-                state.save (writer);
+                cell.mReferences.push_back (std::make_pair (collection.mList.front().mBase->sRecordId, state));
             }
         }
     }
@@ -232,7 +243,7 @@ namespace MWWorld
         {
             mMovedHere.insert(std::make_pair(object.getBase(), from));
         }
-        updateMergedRefs();
+        addMergedRef(object.getBase());
     }
 
     MWWorld::Ptr CellStore::moveTo(const Ptr &object, CellStore *cellToMoveTo)
@@ -278,14 +289,14 @@ namespace MWWorld
                 originalCell->moveTo(object, cellToMoveTo);
             }
 
-            updateMergedRefs();
+            removeMergedRef(object.getBase());
             return MWWorld::Ptr(object.getBase(), cellToMoveTo);
         }
 
         cellToMoveTo->moveFrom(object, this);
         mMovedToAnotherCell.insert(std::make_pair(object.getBase(), cellToMoveTo));
 
-        updateMergedRefs();
+        removeMergedRef(object.getBase());
         return MWWorld::Ptr(object.getBase(), cellToMoveTo);
     }
 
@@ -326,6 +337,56 @@ namespace MWWorld
         MergeVisitor visitor(mMergedRefs, mMovedHere, mMovedToAnotherCell);
         forEachInternal(visitor);
         visitor.merge();
+
+        // keep the keys, the same IDs usually come back
+        for (RefIdIndex::iterator it = mRefIdIndex.begin(); it != mRefIdIndex.end(); ++it)
+            it->second.clear();
+
+        std::string id;
+        for (std::vector<LiveCellRefBase*>::const_iterator it = mMergedRefs.begin(); it != mMergedRefs.end(); ++it)
+        {
+            id = (*it)->mRef.getRefId();
+            Misc::StringUtils::lowerCaseInPlace(id);
+            mRefIdIndex[id].push_back(*it);
+        }
+    }
+
+    void CellStore::addMergedRef(LiveCellRefBase* ref)
+    {
+        mMergedRefs.push_back(ref);
+        mRefIdIndex[Misc::StringUtils::lowerCase(ref->mRef.getRefId())].push_back(ref);
+    }
+
+    void CellStore::removeMergedRef(LiveCellRefBase* ref)
+    {
+        std::vector<LiveCellRefBase*>::iterator found = std::find(mMergedRefs.begin(), mMergedRefs.end(), ref);
+        if (found != mMergedRefs.end())
+            mMergedRefs.erase(found);
+
+        RefIdIndex::iterator bucket = mRefIdIndex.find(Misc::StringUtils::lowerCase(ref->mRef.getRefId()));
+        if (bucket != mRefIdIndex.end())
+        {
+            found = std::find(bucket->second.begin(), bucket->second.end(), ref);
+            if (found != bucket->second.end())
+                bucket->second.erase(found);
+        }
+    }
+
+    LiveCellRefBase* CellStore::searchRefIdIndex (const std::string& id) const
+    {
+        if (mState != State_Loaded)
+            return NULL;
+
+        RefIdIndex::const_iterator found = mRefIdIndex.find(Misc::StringUtils::lowerCase(id));
+        if (found == mRefIdIndex.end())
+            return NULL;
+
+        for (std::vector<LiveCellRefBase*>::const_iterator it = found->second.begin(); it != found->second.end(); ++it)
+        {
+            if (isAccessible((*it)->mData, (*it)->mRef))
+                return *it;
+        }
+        return NULL;
     }
 
     CellStore::CellStore (const ESM::Cell *cell, const MWWorld::ESMStore& esmStore, std::vector<ESM::ESMReader>& readerList)
@@ -362,39 +423,28 @@ namespace MWWorld
         if (mState==State_Preloaded)
             return std::binary_search (mIds.begin(), mIds.end(), id);
 
-        return searchConst (id).isEmpty();
+        return searchRefIdIndex (id) != NULL;
     }
 
-    template <typename PtrType>
-    struct SearchVisitor
-    {
-        PtrType mFound;
-        std::string mIdToFind;
-        bool operator()(const PtrType& ptr)
-        {
-            if (ptr.getCellRef().getRefId() == mIdToFind)
-            {
-                mFound = ptr;
-                return false;
-            }
-            return true;
-        }
-    };
-
     Ptr CellStore::search (const std::string& id)
     {
-        SearchVisitor<MWWorld::Ptr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEach(searchVisitor);
-        return searchVisitor.mFound;
+        if (mState != State_Loaded)
+            return Ptr();
+
+        // like forEach, the returned object may be modified
+        if (!mMergedRefs.empty())
+            mHasState = true;
+
+        if (LiveCellRefBase* ref = searchRefIdIndex (id))
+            return Ptr(ref, this);
+        return Ptr();
     }
 
     ConstPtr CellStore::searchConst (const std::string& id) const
     {
-        SearchVisitor<MWWorld::ConstPtr> searchVisitor;
-        searchVisitor.mIdToFind = id;
-        forEachConst(searchVisitor);
-        return searchVisitor.mFound;
+        if (LiveCellRefBase* ref = searchRefIdIndex (id))
+            return ConstPtr(ref, this);
+        return ConstPtr();
     }
 
     Ptr CellStore::searchViaActorId (int id)
@@ -464,113 +514,100 @@ namespace MWWorld
 
     void CellStore::listRefs()
     {
-        std::vector<ESM::ESMReader>& esm = mReader;
-
         assert (mCell);
 
         if (mCell->mContextList.empty())
             return; // this is a dynamically generated cell -> skipping.
 
-        // Load references from all plugins that do something with this cell.
-        for (size_t i = 0; i < mCell->mContextList.size(); i++)
+        if (mPreparedRefs)
         {
-            try
-            {
-                // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
-
-                ESM::CellRef ref;
-
-                // Get each reference in turn
-                bool deleted = false;
-                while (mCell->getNextRef (esm[index], ref, deleted))
-                {
-                    if (deleted)
-                        continue;
-
-                    // Don't list reference if it was moved to a different cell.
-                    ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
-                        continue;
-                    }
-
-                    mIds.push_back (Misc::StringUtils::lowerCase (ref.mRefID));
-                }
-            }
-            catch (std::exception& e)
+            // keep the prepared references around for load()
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPreparedRefs->mMutex);
+            if (mPreparedRefs->mReady)
             {
-                std::cerr << "An error occurred listing references for cell " << getCell()->getDescription() << ": " << e.what() << std::endl;
+                listIds (mPreparedRefs->mRefs, mIds);
+                return;
             }
         }
 
-        // List moved references, from separately tracked list.
-        for (ESM::CellRefTracker::const_iterator it = mCell->mLeasedRefs.begin(); it != mCell->mLeasedRefs.end(); ++it)
-        {
-            const ESM::CellRef &ref = it->first;
-            bool deleted = it->second;
-
-            if (!deleted)
-                mIds.push_back(Misc::StringUtils::lowerCase(ref.mRefID));
-        }
-
-        std::sort (mIds.begin(), mIds.end());
+        ESM::CellRefTracker refs;
+        readRefs (mCell, mReader, refs);
+        listIds (refs, mIds);
     }
 
     void CellStore::loadRefs()
     {
-        std::vector<ESM::ESMReader>& esm = mReader;
-
         assert (mCell);
 
         if (mCell->mContextList.empty())
             return; // this is a dynamically generated cell -> skipping.
 
+        ESM::CellRefTracker refs;
+        bool prepared = false;
+        if (mPreparedRefs)
+        {
+            // Don't wait for the worker thread if it isn't done yet, it may not even have started on this cell
+            OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPreparedRefs->mMutex);
+            if (mPreparedRefs->mReady)
+            {
+                refs.swap(mPreparedRefs->mRefs);
+                prepared = true;
+            }
+        }
+        mPreparedRefs.reset();
+
+        if (!prepared)
+            readRefs (mCell, mReader, refs);
+
         std::map<ESM::RefNum, std::string> refNumToID; // used to detect refID modifications
 
+        for (ESM::CellRefTracker::iterator it = refs.begin(); it != refs.end(); ++it)
+            loadRef (it->first, it->second, refNumToID);
+
+        updateMergedRefs();
+    }
+
+    void CellStore::readRefs(const ESM::Cell *cell, std::vector<ESM::ESMReader>& readers, ESM::CellRefTracker& refs)
+    {
         // Load references from all plugins that do something with this cell.
-        for (size_t i = 0; i < mCell->mContextList.size(); i++)
+        for (size_t i = 0; i < cell->mContextList.size(); i++)
         {
             try
             {
                 // Reopen the ESM reader and seek to the right position.
-                int index = mCell->mContextList.at(i).index;
-                mCell->restore (esm[index], i);
+                int index = cell->mContextList.at(i).index;
+                cell->restore (readers[index], i);
 
                 ESM::CellRef ref;
                 ref.mRefNum.mContentFile = ESM::RefNum::RefNum_NoContentFile;
 
                 // Get each reference in turn
                 bool deleted = false;
-                while(mCell->getNextRef(esm[index], ref, deleted))
+                while(cell->getNextRef(readers[index], ref, deleted))
                 {
                     // Don't load reference if it was moved to a different cell.
                     ESM::MovedCellRefTracker::const_iterator iter =
-                        std::find(mCell->mMovedRefs.begin(), mCell->mMovedRefs.end(), ref.mRefNum);
-                    if (iter != mCell->mMovedRefs.end()) {
+                        std::find(cell->mMovedRefs.begin(), cell->mMovedRefs.end(), ref.mRefNum);
+                    if (iter != cell->mMovedRefs.end()) {
                         continue;
                     }
 
-                    loadRef (ref, deleted, refNumToID);
+                    refs.push_back (std::make_pair (ref, deleted));
                 }
             }
             catch (std::exception& e)
             {
-                std::cerr << "An error occurred loading references for cell " << getCell()->getDescription() << ": " << e.what() << std::endl;
+                std::cerr << "An error occurred loading references for cell " << cell->getDescription() << ": " << e.what() << std::endl;
             }
         }
 
         // Load moved references, from separately tracked list.
-        for (ESM::CellRefTracker::const_iterator it = mCell->mLeasedRefs.begin(); it != mCell->mLeasedRefs.end(); ++it)
-        {
-            ESM::CellRef &ref = const_cast<ESM::CellRef&>(it->first);
-            bool deleted = it->second;
-
-            loadRef (ref, deleted, refNumToID);
-        }
+        refs.insert (refs.end(), cell->mLeasedRefs.begin(), cell->mLeasedRefs.end());
+    }
 
-        updateMergedRefs();
+    void CellStore::setPreparedRefs(const std::shared_ptr<PreparedRefs>& refs)
+    {
+        mPreparedRefs = refs;
     }
 
     bool CellStore::isExterior() const
@@ -697,12 +734,16 @@ namespace MWWorld
         state.mLastRespawn = mLastRespawn.toEsm();
     }
 
-    void CellStore::writeFog(ESM::ESMWriter &writer) const
+    void CellStore::save (SavedCell& cell) const
     {
+        saveState (cell.mState);
+
+        // copy the fog, the window manager replaces it while the game goes on
         if (mFogState.get())
-        {
-            mFogState->save(writer, mCell->mData.mFlags & ESM::Cell::Interior);
-        }
+            cell.mFog.reset (new ESM::FogState (*mFogState));
+        cell.mInterior = (mCell->mData.mFlags & ESM::Cell::Interior) != 0;
+
+        saveReferences (cell);
     }
 
     void CellStore::readFog(ESM::ESMReader &reader)
@@ -711,38 +752,34 @@ namespace MWWorld
         mFogState->load(reader);
     }
 
-    void CellStore::writeReferences (ESM::ESMWriter& writer) const
-    {
-        writeReferenceCollection<ESM::ObjectState> (writer, mActivators);
-        writeReferenceCollection<ESM::ObjectState> (writer, mPotions);
-        writeReferenceCollection<ESM::ObjectState> (writer, mAppas);
-        writeReferenceCollection<ESM::ObjectState> (writer, mArmors);
-        writeReferenceCollection<ESM::ObjectState> (writer, mBooks);
-        writeReferenceCollection<ESM::ObjectState> (writer, mClothes);
-        writeReferenceCollection<ESM::ContainerState> (writer, mContainers);
-        writeReferenceCollection<ESM::CreatureState> (writer, mCreatures);
-        writeReferenceCollection<ESM::DoorState> (writer, mDoors);
-        writeReferenceCollection<ESM::ObjectState> (writer, mIngreds);
-        writeReferenceCollection<ESM::CreatureLevListState> (writer, mCreatureLists);
-        writeReferenceCollection<ESM::ObjectState> (writer, mItemLists);
-        writeReferenceCollection<ESM::ObjectState> (writer, mLights);
-        writeReferenceCollection<ESM::ObjectState> (writer, mLockpicks);
-        writeReferenceCollection<ESM::ObjectState> (writer, mMiscItems);
-        writeReferenceCollection<ESM::NpcState> (writer, mNpcs);
-        writeReferenceCollection<ESM::ObjectState> (writer, mProbes);
-        writeReferenceCollection<ESM::ObjectState> (writer, mRepairs);
-        writeReferenceCollection<ESM::ObjectState> (writer, mStatics);
-        writeReferenceCollection<ESM::ObjectState> (writer, mWeapons);
-        writeReferenceCollection<ESM::ObjectState> (writer, mBodyParts);
+    void CellStore::saveReferences (SavedCell& cell) const
+    {
+        saveReferenceCollection<ESM::ObjectState> (cell, mActivators);
+        saveReferenceCollection<ESM::ObjectState> (cell, mPotions);
+        saveReferenceCollection<ESM::ObjectState> (cell, mAppas);
+        saveReferenceCollection<ESM::ObjectState> (cell, mArmors);
+        saveReferenceCollection<ESM::ObjectState> (cell, mBooks);
+        saveReferenceCollection<ESM::ObjectState> (cell, mClothes);
+        saveReferenceCollection<ESM::ContainerState> (cell, mContainers);
+        saveReferenceCollection<ESM::CreatureState> (cell, mCreatures);
+        saveReferenceCollection<ESM::DoorState> (cell, mDoors);
+        saveReferenceCollection<ESM::ObjectState> (cell, mIngreds);
+        saveReferenceCollection<ESM::CreatureLevListState> (cell, mCreatureLists);
+        saveReferenceCollection<ESM::ObjectState> (cell, mItemLists);
+        saveReferenceCollection<ESM::ObjectState> (cell, mLights);
+        saveReferenceCollection<ESM::ObjectState> (cell, mLockpicks);
+        saveReferenceCollection<ESM::ObjectState> (cell, mMiscItems);
+        saveReferenceCollection<ESM::NpcState> (cell, mNpcs);
+        saveReferenceCollection<ESM::ObjectState> (cell, mProbes);
+        saveReferenceCollection<ESM::ObjectState> (cell, mRepairs);
+        saveReferenceCollection<ESM::ObjectState> (cell, mStatics);
+        saveReferenceCollection<ESM::ObjectState> (cell, mWeapons);
+        saveReferenceCollection<ESM::ObjectState> (cell, mBodyParts);
 
         for (MovedRefTracker::const_iterator it = mMovedToAnotherCell.begin(); it != mMovedToAnotherCell.end(); ++it)
         {
             LiveCellRefBase* base = it->first;
-            ESM::RefNum refNum = base->mRef.getRefNum();
-            ESM::CellId movedTo = it->second->getCell()->getCellId();
-
-            refNum.save(writer, true, "MVRF");
-            movedTo.save(writer);
+            cell.mMovedReferences.push_back(std::make_pair(base->mRef.getRefNum(), it->second->getCell()->getCellId()));
         }
     }
 
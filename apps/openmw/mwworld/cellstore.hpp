@@ -7,6 +7,9 @@
 #include <typeinfo>
 #include <map>
 #include <memory>
+#include <unordered_map>
+
+#include <OpenThreads/Mutex>
 
 #include "livecellref.hpp"
 #include "cellreflist.hpp"
@@ -31,6 +34,7 @@
 #include <components/esm/loadnpc.hpp>
 #include <components/esm/loadmisc.hpp>
 #include <components/esm/loadbody.hpp>
+#include <components/esm/loadcell.hpp>
 
 #include "../mwmechanics/pathgrid.hpp"  // TODO: maybe belongs in mwworld
 
@@ -47,6 +51,19 @@ namespace ESM
 namespace MWWorld
 {
     class ESMStore;
+    struct SavedCell;
+
+    /// \brief References of a cell that are being read from the content files ahead of time by a worker thread
+    /// @see CellStore::setPreparedRefs
+    struct PreparedRefs
+    {
+        PreparedRefs() : mReady(false) {}
+
+        OpenThreads::Mutex mMutex;
+        /// Set by the worker thread once mRefs is complete
+        bool mReady;
+        ESM::CellRefTracker mRefs;
+    };
 
     /// \brief Mutable state of a cell
     class CellStore
@@ -74,6 +91,8 @@ namespace MWWorld
             std::vector<std::string> mIds;
             float mWaterLevel;
 
+            std::shared_ptr<PreparedRefs> mPreparedRefs;
+
             MWWorld::TimeStamp mLastRespawn;
 
             // List of refs owned by this cell
@@ -110,15 +129,28 @@ namespace MWWorld
             // Merged list of ref's currently in this cell - i.e. with added refs from mMovedHere, removed refs from mMovedToAnotherCell
             std::vector<LiveCellRefBase*> mMergedRefs;
 
+            typedef std::unordered_map<std::string, std::vector<LiveCellRefBase*> > RefIdIndex;
+            // mMergedRefs by lower case ref ID, in the same order. Kept in sync with mMergedRefs.
+            RefIdIndex mRefIdIndex;
+
             // Get the Ptr for the given ref which originated from this cell (possibly moved to another cell at this point).
             Ptr getCurrentPtr(MWWorld::LiveCellRefBase* ref);
 
             /// Moves object from the given cell to this cell.
             void moveFrom(const MWWorld::Ptr& object, MWWorld::CellStore* from);
 
-            /// Repopulate mMergedRefs.
+            /// Repopulate mMergedRefs and mRefIdIndex.
             void updateMergedRefs();
 
+            /// Append \a ref to mMergedRefs and mRefIdIndex.
+            void addMergedRef(LiveCellRefBase* ref);
+
+            /// Remove \a ref from mMergedRefs and mRefIdIndex.
+            void removeMergedRef(LiveCellRefBase* ref);
+
+            /// @return The first accessible reference with the given ID, or NULL
+            LiveCellRefBase* searchRefIdIndex (const std::string& id) const;
+
             // helper function for forEachInternal
             template<class Visitor, class List>
             bool forEachImp (Visitor& visitor, List& list)
@@ -193,7 +225,7 @@ namespace MWWorld
                 mHasState = true;
                 CellRefList<T>& list = get<T>();
                 LiveCellRefBase* ret = &list.insert(*ref);
-                updateMergedRefs();
+                addMergedRef(ret);
                 return ret;
             }
 
@@ -217,6 +249,16 @@ namespace MWWorld
             /// unloaded.
             /// @note Will not account for moved references which may exist in Loaded state. Use search() instead if the cell is loaded.
 
+            /// Read the references of \a cell from the content files, using \a readers, and append them to \a refs.
+            /// References moved to a different cell are skipped, references moved into \a cell are included.
+            /// @note Only accesses the ESM::Cell record and \a readers, so may be called from a worker thread.
+            static void readRefs (const ESM::Cell *cell, std::vector<ESM::ESMReader>& readers, ESM::CellRefTracker& refs);
+
+            /// Provide the references of this cell that a worker thread is reading with readRefs. If they are ready by the time
+            /// the cell gets loaded, they are used instead of reading the references again, otherwise they are discarded.
+            /// Pass an empty pointer to release them when the cell is no longer being preloaded.
+            void setPreparedRefs (const std::shared_ptr<PreparedRefs>& refs);
+
             Ptr search (const std::string& id);
             ///< Will return an empty Ptr if cell is not loaded. Does not check references in
             /// containers.
@@ -357,11 +399,12 @@ namespace MWWorld
 
             void saveState (ESM::CellState& state) const;
 
-            void writeFog (ESM::ESMWriter& writer) const;
+            /// Capture the state, fog and changed references of this cell for a saved game.
+            void save (SavedCell& cell) const;
 
             void readFog (ESM::ESMReader& reader);
 
-            void writeReferences (ESM::ESMWriter& writer) const;
+            void saveReferences (SavedCell& cell) const;
 
             struct GetCellStoreCallback
             {
@@ -1,5 +1,6 @@
 #include "containerstore.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <typeinfo>
 #include <stdexcept>
@@ -57,8 +58,26 @@ namespace
 
         return MWWorld::Ptr();
     }
+
+    bool isRemoved (const MWWorld::ContainerStoreIterator& iter)
+    {
+        return iter->getRefData().getCount() == 0;
+    }
 }
 
+MWWorld::ContainerStoreStackIndex::ContainerStoreStackIndex() : mValid (false) {}
+
+MWWorld::ContainerStoreStackIndex::ContainerStoreStackIndex (const ContainerStoreStackIndex& index) : mValid (false) {}
+
+MWWorld::ContainerStoreStackIndex& MWWorld::ContainerStoreStackIndex::operator= (const ContainerStoreStackIndex& index)
+{
+    mItems.clear();
+    mValid = false;
+    return *this;
+}
+
+MWWorld::ContainerStoreStackIndex::~ContainerStoreStackIndex() {}
+
 template<typename T>
 MWWorld::ContainerStoreIterator MWWorld::ContainerStore::getState (CellRefList<T>& collection,
     const ESM::ObjectState& state)
@@ -150,19 +169,19 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::end()
 int MWWorld::ContainerStore::count(const std::string &id)
 {
     int total=0;
-    for (MWWorld::ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
-        if (Misc::StringUtils::ciEqual(iter->getCellRef().getRefId(), id))
-            total += iter->getRefData().getCount();
+    const std::vector<ContainerStoreIterator>& items = getStackCandidates(id);
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (items.begin()); iter!=items.end(); ++iter)
+        total += (*iter)->getRefData().getCount();
     return total;
 }
 
 int MWWorld::ContainerStore::restockCount(const std::string &id)
 {
     int total=0;
-    for (MWWorld::ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
-        if (Misc::StringUtils::ciEqual(iter->getCellRef().getRefId(), id))
-            if (iter->getCellRef().getSoul().empty())
-                total += iter->getRefData().getCount();
+    const std::vector<ContainerStoreIterator>& items = getStackCandidates(id);
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (items.begin()); iter!=items.end(); ++iter)
+        if ((*iter)->getCellRef().getSoul().empty())
+            total += (*iter)->getRefData().getCount();
     return total;
 }
 
@@ -194,11 +213,12 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::unstack(const Ptr &ptr,
 MWWorld::ContainerStoreIterator MWWorld::ContainerStore::restack(const MWWorld::Ptr& item)
 {
     MWWorld::ContainerStoreIterator retval = end();
-    for (MWWorld::ContainerStoreIterator iter (begin()); iter != end(); ++iter)
+    const std::vector<ContainerStoreIterator>& items = getStackCandidates(item.getCellRef().getRefId());
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (items.begin()); iter != items.end(); ++iter)
     {
-        if (item == *iter)
+        if (item == **iter)
         {
-            retval = iter;
+            retval = *iter;
             break;
         }
     }
@@ -206,13 +226,13 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::restack(const MWWorld::
     if (retval == end())
         throw std::runtime_error("item is not from this container");
 
-    for (MWWorld::ContainerStoreIterator iter (begin()); iter != end(); ++iter)
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (items.begin()); iter != items.end(); ++iter)
     {
-        if (stacks(*iter, item))
+        if (stacks(**iter, item))
         {
-            iter->getRefData().setCount(iter->getRefData().getCount() + item.getRefData().getCount());
+            (*iter)->getRefData().setCount((*iter)->getRefData().getCount() + item.getRefData().getCount());
             item.getRefData().setCount(0);
-            retval = iter;
+            retval = *iter;
             break;
         }
     }
@@ -341,8 +361,6 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::add (const Ptr& itemPtr
 
 MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr, int count)
 {
-    int type = getType(ptr);
-
     const MWWorld::ESMStore &esmStore =
         MWBase::Environment::get().getWorld()->getStore();
 
@@ -352,14 +370,13 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
     {
         int realCount = count * ptr.getClass().getValue(ptr);
 
-        for (MWWorld::ContainerStoreIterator iter (begin(type)); iter!=end(); ++iter)
+        const std::vector<ContainerStoreIterator>& gold = getStackCandidates(MWWorld::ContainerStore::sGoldId);
+        if (!gold.empty())
         {
-            if (Misc::StringUtils::ciEqual((*iter).getCellRef().getRefId(), MWWorld::ContainerStore::sGoldId))
-            {
-                iter->getRefData().setCount(iter->getRefData().getCount() + realCount);
-                flagAsModified();
-                return iter;
-            }
+            MWWorld::ContainerStoreIterator iter = gold.front();
+            iter->getRefData().setCount(iter->getRefData().getCount() + realCount);
+            flagAsModified();
+            return iter;
         }
 
         MWWorld::ManualRef ref(esmStore, MWWorld::ContainerStore::sGoldId, realCount);
@@ -367,15 +384,17 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addImp (const Ptr& ptr,
     }
 
     // determine whether to stack or not
-    for (MWWorld::ContainerStoreIterator iter (begin(type)); iter!=end(); ++iter)
+    const std::vector<ContainerStoreIterator>& candidates = getStackCandidates(ptr.getCellRef().getRefId());
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (candidates.begin()); iter!=candidates.end(); ++iter)
     {
-        if (stacks(*iter, ptr))
+        if (stacks(**iter, ptr))
         {
             // stack
-            iter->getRefData().setCount( iter->getRefData().getCount() + count );
+            MWWorld::ContainerStoreIterator stack = *iter;
+            stack->getRefData().setCount( stack->getRefData().getCount() + count );
 
             flagAsModified();
-            return iter;
+            return stack;
         }
     }
     // if we got here, this means no stacking
@@ -404,17 +423,45 @@ MWWorld::ContainerStoreIterator MWWorld::ContainerStore::addNewStack (const Cons
 
     it->getRefData().setCount(count);
 
+    if (mStackIndex.mValid)
+        mStackIndex.mItems[Misc::StringUtils::lowerCase(it->getCellRef().getRefId())].push_back(it);
+
     flagAsModified();
     return it;
 }
 
+const std::vector<MWWorld::ContainerStoreIterator>& MWWorld::ContainerStore::getStackCandidates (const std::string& id)
+{
+    if (!mStackIndex.mValid)
+    {
+        mStackIndex.mItems.clear();
+        for (ContainerStoreIterator iter (begin()); iter!=end(); ++iter)
+            mStackIndex.mItems[Misc::StringUtils::lowerCase(iter->getCellRef().getRefId())].push_back(iter);
+        mStackIndex.mValid = true;
+    }
+
+    ContainerStoreStackIndex::Items::iterator found = mStackIndex.mItems.find(Misc::StringUtils::lowerCase(id));
+    if (found == mStackIndex.mItems.end())
+    {
+        static const std::vector<ContainerStoreIterator> empty;
+        return empty;
+    }
+
+    // removed items stay in their list with a count of 0, drop them here
+    std::vector<ContainerStoreIterator>& items = found->second;
+    items.erase(std::remove_if(items.begin(), items.end(), isRemoved), items.end());
+    return items;
+}
+
 int MWWorld::ContainerStore::remove(const std::string& itemId, int count, const Ptr& actor, bool equipReplacement)
 {
     int toRemove = count;
 
-    for (ContainerStoreIterator iter(begin()); iter != end() && toRemove > 0; ++iter)
-        if (Misc::StringUtils::ciEqual(iter->getCellRef().getRefId(), itemId))
-            toRemove -= remove(*iter, toRemove, actor, equipReplacement);
+    // copied, since removing equipped items can add new stacks
+    std::vector<ContainerStoreIterator> items = getStackCandidates(itemId);
+    for (std::vector<ContainerStoreIterator>::iterator iter (items.begin()); iter != items.end() && toRemove > 0; ++iter)
+        if ((*iter)->getRefData().getCount() > 0)
+            toRemove -= remove(**iter, toRemove, actor, equipReplacement);
 
     flagAsModified();
 
@@ -814,6 +861,7 @@ void MWWorld::ContainerStore::readState (const ESM::InventoryState& inventory)
         }
     }
 
+    mStackIndex.mValid = false;
 
     mLevelledItemMap = inventory.mLevelledItemMap;
 }
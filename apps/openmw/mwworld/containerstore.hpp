@@ -3,7 +3,9 @@
 
 #include <iterator>
 #include <map>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include <components/esm/loadalch.hpp>
 #include <components/esm/loadappa.hpp>
@@ -45,6 +47,23 @@ namespace MWWorld
             virtual void itemRemoved(const ConstPtr& item, int count) {}
     };
 
+    /// \brief The items of a ContainerStore grouped by lower case ID, since only items with the same ID can stack.
+    ///
+    /// Refers to the items of one store, so a copy starts out empty and is rebuilt on first use.
+    class ContainerStoreStackIndex
+    {
+        public:
+
+            ContainerStoreStackIndex();
+            ContainerStoreStackIndex (const ContainerStoreStackIndex& index);
+            ContainerStoreStackIndex& operator= (const ContainerStoreStackIndex& index);
+            ~ContainerStoreStackIndex();
+
+            typedef std::unordered_map<std::string, std::vector<ContainerStoreIterator> > Items;
+            Items mItems;
+            bool mValid;
+    };
+
     class ContainerStore
     {
         public:
@@ -91,6 +110,9 @@ namespace MWWorld
 
             mutable float mCachedWeight;
             mutable bool mWeightUpToDate;
+
+            ContainerStoreStackIndex mStackIndex;
+
             ContainerStoreIterator addImp (const Ptr& ptr, int count);
             void addInitialItem (const std::string& id, const std::string& owner, int count, bool topLevel=true, const std::string& levItem = "");
 
@@ -176,6 +198,11 @@ namespace MWWorld
             ContainerStoreIterator addNewStack (const ConstPtr& ptr, int count);
             ///< Add the item to this container (do not try to stack it onto existing items)
 
+            const std::vector<ContainerStoreIterator>& getStackCandidates (const std::string& id);
+            ///< @return The items with refID \a id in this container, the only ones that an item with this ID can stack with.
+            ///
+            /// \attention The result is invalidated by adding items to this container.
+
             virtual void flagAsModified();
 
         public:
@@ -0,0 +1,99 @@
+#include "esmreaderpool.hpp"
+
+#include <cassert>
+
+#include <OpenThreads/ScopedLock>
+
+#include <components/to_utf8/to_utf8.hpp>
+
+namespace MWWorld
+{
+
+    struct ESMReaderPool::ReaderSet
+    {
+        ReaderSet(const ReaderList& prototype, const ToUTF8::Utf8Encoder* encoder)
+            : mReaders(prototype)
+        {
+            // the encoder has a conversion buffer, so can't be shared between threads
+            if (encoder)
+                mEncoder.reset(new ToUTF8::Utf8Encoder(*encoder));
+
+            for (ReaderList::iterator it = mReaders.begin(); it != mReaders.end(); ++it)
+            {
+                it->setEncoder(mEncoder.get());
+                it->setGlobalReaderList(&mReaders);
+            }
+        }
+
+        ReaderList mReaders;
+        std::unique_ptr<ToUTF8::Utf8Encoder> mEncoder;
+    };
+
+    ESMReaderPool::ESMReaderPool(const ReaderList& readers, const ToUTF8::Utf8Encoder* encoder)
+        : mPrototype(readers)
+    {
+        if (encoder)
+            mEncoder.reset(new ToUTF8::Utf8Encoder(*encoder));
+
+        // drop the shared file streams, ESMReader::restoreContext reopens the file when the file name differs
+        for (ReaderList::iterator it = mPrototype.begin(); it != mPrototype.end(); ++it)
+            it->close();
+    }
+
+    ESMReaderPool::~ESMReaderPool()
+    {
+        assert(mFreeReaderSets.size() == mReaderSets.size());
+
+        for (std::vector<ReaderSet*>::iterator it = mReaderSets.begin(); it != mReaderSets.end(); ++it)
+            delete *it;
+    }
+
+    ESMReaderPool::ReaderList& ESMReaderPool::acquire()
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+        if (mFreeReaderSets.empty())
+        {
+            ReaderSet* readerSet = new ReaderSet(mPrototype, mEncoder.get());
+            mReaderSets.push_back(readerSet);
+            return readerSet->mReaders;
+        }
+
+        ReaderSet* readerSet = mFreeReaderSets.back();
+        mFreeReaderSets.pop_back();
+        return readerSet->mReaders;
+    }
+
+    void ESMReaderPool::release(ReaderList& readers)
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+        for (std::vector<ReaderSet*>::iterator it = mReaderSets.begin(); it != mReaderSets.end(); ++it)
+        {
+            if (&(*it)->mReaders == &readers)
+            {
+                mFreeReaderSets.push_back(*it);
+                return;
+            }
+        }
+
+        assert(false && "reader set does not belong to this pool");
+    }
+
+    ESMReaderPool::ScopedReaders::ScopedReaders(ESMReaderPool& pool)
+        : mPool(pool)
+        , mReaders(pool.acquire())
+    {
+    }
+
+    ESMReaderPool::ScopedReaders::~ScopedReaders()
+    {
+        mPool.release(mReaders);
+    }
+
+    ESMReaderPool::ReaderList& ESMReaderPool::ScopedReaders::get()
+    {
+        return mReaders;
+    }
+
+}
@@ -0,0 +1,78 @@
+#ifndef GAME_MWWORLD_ESMREADERPOOL_H
+#define GAME_MWWORLD_ESMREADERPOOL_H
+
+#include <vector>
+#include <memory>
+
+#include <osg/Referenced>
+
+#include <OpenThreads/Mutex>
+
+#include <components/esm/esmreader.hpp>
+
+namespace ToUTF8
+{
+    class Utf8Encoder;
+}
+
+namespace MWWorld
+{
+
+    /// @brief Hands out private copies of the content file readers, so that records can be read from worker threads.
+    /// @par The readers of the World are shared by everything on the main thread and are repositioned on every use,
+    ///  so they must never be touched from another thread. Each reader set of the pool opens its own file streams
+    ///  (lazily, on the first ESM::ESMReader::restoreContext) and has its own text encoder.
+    /// @note Thread safe. Work items using the pool should hold a reference to it, since the work queue may outlive the World.
+    class ESMReaderPool : public osg::Referenced
+    {
+    public:
+        typedef std::vector<ESM::ESMReader> ReaderList;
+
+        /// @param readers The readers of the loaded content files, to copy the headers and indices from.
+        /// @param encoder The encoder used by \a readers, may be NULL.
+        /// @note Must be called from the main thread, after the content files have been loaded.
+        ESMReaderPool(const ReaderList& readers, const ToUTF8::Utf8Encoder* encoder);
+        ~ESMReaderPool();
+
+        /// Take a reader set that is not in use by any other thread, creating a new one if needed.
+        /// @note Must be given back with release().
+        ReaderList& acquire();
+
+        /// Give back a reader set taken with acquire(). Its files stay open for the next user.
+        void release(ReaderList& readers);
+
+        /// @brief Borrows a reader set from the pool for the lifetime of this object.
+        class ScopedReaders
+        {
+        public:
+            ScopedReaders(ESMReaderPool& pool);
+            ~ScopedReaders();
+
+            ReaderList& get();
+
+        private:
+            ScopedReaders(const ScopedReaders&);
+            ScopedReaders& operator=(const ScopedReaders&);
+
+            ESMReaderPool& mPool;
+            ReaderList& mReaders;
+        };
+
+    private:
+        struct ReaderSet;
+
+        ESMReaderPool(const ESMReaderPool&);
+        ESMReaderPool& operator=(const ESMReaderPool&);
+
+        OpenThreads::Mutex mMutex;
+
+        ReaderList mPrototype;
+        std::unique_ptr<ToUTF8::Utf8Encoder> mEncoder;
+
+        std::vector<ReaderSet*> mReaderSets;
+        std::vector<ReaderSet*> mFreeReaderSets;
+    };
+
+}
+
+#endif
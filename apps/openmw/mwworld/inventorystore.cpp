@@ -762,13 +762,15 @@ MWWorld::ContainerStoreIterator MWWorld::InventoryStore::unequipItemQuantity(con
 
     // Move items to an existing stack if possible, otherwise split count items out into a new stack.
     // Moving counts manually here, since ContainerStore's restack can't target unequipped stacks.
-    for (MWWorld::ContainerStoreIterator iter (begin()); iter != end(); ++iter)
+    const std::vector<ContainerStoreIterator>& candidates = getStackCandidates(item.getCellRef().getRefId());
+    for (std::vector<ContainerStoreIterator>::const_iterator iter (candidates.begin()); iter != candidates.end(); ++iter)
     {
-        if (stacks(*iter, item) && !isEquipped(*iter))
+        if (stacks(**iter, item) && !isEquipped(**iter))
         {
-            iter->getRefData().setCount(iter->getRefData().getCount() + count);
+            MWWorld::ContainerStoreIterator stack = *iter;
+            stack->getRefData().setCount(stack->getRefData().getCount() + count);
             item.getRefData().setCount(item.getRefData().getCount() - count);
-            return iter;
+            return stack;
         }
     }
 
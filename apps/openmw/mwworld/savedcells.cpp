@@ -0,0 +1,47 @@
+#include "savedcells.hpp"
+
+#include <components/esm/esmwriter.hpp>
+#include <components/esm/defs.hpp>
+#include <components/esm/fogstate.hpp>
+#include <components/esm/objectstate.hpp>
+
+namespace MWWorld
+{
+    SavedCell::SavedCell()
+        : mInterior(false)
+    {
+    }
+
+    void SavedCell::write (ESM::ESMWriter& writer) const
+    {
+        writer.startRecord (ESM::REC_CSTA);
+        mState.mId.save (writer);
+        mState.save (writer);
+
+        if (mFog)
+            mFog->save (writer, mInterior);
+
+        for (std::vector<std::pair<unsigned int, std::shared_ptr<ESM::ObjectState> > >::const_iterator it = mReferences.begin();
+             it != mReferences.end(); ++it)
+        {
+            // recordId currently unused
+            writer.writeHNT ("OBJE", it->first);
+            it->second->save (writer);
+        }
+
+        for (std::vector<std::pair<ESM::RefNum, ESM::CellId> >::const_iterator it = mMovedReferences.begin();
+             it != mMovedReferences.end(); ++it)
+        {
+            it->first.save (writer, true, "MVRF");
+            it->second.save (writer);
+        }
+
+        writer.endRecord (ESM::REC_CSTA);
+    }
+
+    void SavedCells::write (ESM::ESMWriter& writer) const
+    {
+        for (std::vector<SavedCell>::const_iterator it = mCells.begin(); it != mCells.end(); ++it)
+            it->write (writer);
+    }
+}
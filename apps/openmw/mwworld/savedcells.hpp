@@ -0,0 +1,56 @@
+#ifndef OPENMW_MWWORLD_SAVEDCELLS_H
+#define OPENMW_MWWORLD_SAVEDCELLS_H
+
+#include <iosfwd>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <components/esm/cellref.hpp>
+#include <components/esm/cellstate.hpp>
+
+namespace ESM
+{
+    class ESMWriter;
+    struct FogState;
+    struct ObjectState;
+}
+
+namespace MWWorld
+{
+    /// \brief State of a cell captured for a saved game
+    /// @note Holds copies only, so it can be written out while the game goes on, e.g. on a worker thread.
+    struct SavedCell
+    {
+        ESM::CellState mState;
+
+        /// NULL if the cell has not been explored
+        std::shared_ptr<ESM::FogState> mFog;
+        bool mInterior;
+
+        /// <record ID, reference state>
+        std::vector<std::pair<unsigned int, std::shared_ptr<ESM::ObjectState> > > mReferences;
+
+        /// <reference owned by this cell, cell it was moved to>
+        std::vector<std::pair<ESM::RefNum, ESM::CellId> > mMovedReferences;
+
+        SavedCell();
+
+        /// Write the REC_CSTA record of this cell.
+        void write (ESM::ESMWriter& writer) const;
+    };
+
+    /// \brief All cells captured for a saved game
+    struct SavedCells
+    {
+        std::vector<SavedCell> mCells;
+
+        /// Position of the cell records in the stream the rest of the saved game was written to
+        std::streampos mPosition;
+
+        /// Write the REC_CSTA records of all cells.
+        void write (ESM::ESMWriter& writer) const;
+    };
+}
+
+#endif
@@ -43,6 +43,7 @@ namespace MWWorld
     class Player;
     class CellStore;
     class CellPreloader;
+    class ESMReaderPool;
 
     class Scene
     {
@@ -84,7 +85,8 @@ namespace MWWorld
 
         public:
 
-            Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics);
+            /// @param readerPool Used to read the references of cells that are being preloaded in the background.
+            Scene (MWRender::RenderingManager& rendering, MWPhysics::PhysicsSystem *physics, ESMReaderPool* readerPool);
 
             ~Scene();
 
@@ -6,6 +6,7 @@
 #include <components/loadinglistener/loadinglistener.hpp>
 #include <components/misc/rng.hpp>
 
+#include <algorithm>
 #include <stdexcept>
 #include <sstream>
 #include <iostream>
@@ -45,6 +46,15 @@ namespace
             return x->mX < y.first;
         }
     };
+
+    struct DialogueKeyLess
+    {
+        bool operator()(const std::pair<const std::string*, ESM::Dialogue*>& x,
+                        const std::pair<const std::string*, ESM::Dialogue*>& y) const
+        {
+            return *x.first < *y.first;
+        }
+    };
 }
 
 namespace MWWorld
@@ -136,14 +146,12 @@ namespace MWWorld
     template<typename T>
     const T *Store<T>::search(const std::string &id) const
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename Dynamic::const_iterator dit = mDynamic.find(idLower);
+        typename Dynamic::const_iterator dit = mDynamic.find(id);
         if (dit != mDynamic.end()) {
             return &dit->second;
         }
 
-        typename std::map<std::string, T>::const_iterator it = mStatic.find(idLower);
+        typename Static::const_iterator it = mStatic.find(id);
 
         if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
             return &(it->second);
@@ -273,9 +281,7 @@ namespace MWWorld
     template<typename T>
     bool Store<T>::eraseStatic(const std::string &id)
     {
-        std::string idLower = Misc::StringUtils::lowerCase(id);
-
-        typename std::map<std::string, T>::iterator it = mStatic.find(idLower);
+        typename Static::iterator it = mStatic.find(id);
 
         if (it != mStatic.end() && Misc::StringUtils::ciEqual(it->second.mId, id)) {
             // delete from the static part of mShared
@@ -283,7 +289,7 @@ namespace MWWorld
             typename std::vector<T *>::iterator end = sharedIter + mStatic.size();
 
             while (sharedIter != mShared.end() && sharedIter != end) {
-                if((*sharedIter)->mId == idLower) {
+                if(*sharedIter == &it->second) {
                     mShared.erase(sharedIter);
                     break;
                 }
@@ -298,19 +304,19 @@ namespace MWWorld
     template<typename T>
     bool Store<T>::erase(const std::string &id)
     {
-        std::string key = Misc::StringUtils::lowerCase(id);
-        typename Dynamic::iterator it = mDynamic.find(key);
+        typename Dynamic::iterator it = mDynamic.find(id);
         if (it == mDynamic.end()) {
             return false;
         }
-        mDynamic.erase(it);
 
-        // have to reinit the whole shared part
+        // delete from the dynamic part of mShared, keeping the order of the other records
         assert(mShared.size() >= mStatic.size());
-        mShared.erase(mShared.begin() + mStatic.size(), mShared.end());
-        for (it = mDynamic.begin(); it != mDynamic.end(); ++it) {
-            mShared.push_back(&it->second);
-        }
+        typename std::vector<T *>::iterator sharedIter =
+            std::find(mShared.begin() + mStatic.size(), mShared.end(), &it->second);
+        if (sharedIter != mShared.end())
+            mShared.erase(sharedIter);
+
+        mDynamic.erase(it);
         return true;
     }
     template<typename T>
@@ -321,11 +327,11 @@ namespace MWWorld
     template<typename T>
     void Store<T>::write (ESM::ESMWriter& writer, Loading::Listener& progress) const
     {
-        for (typename Dynamic::const_iterator iter (mDynamic.begin()); iter!=mDynamic.end();
-             ++iter)
+        // the dynamic part of mShared, so the records are written in the order they were created
+        for (size_t i = mStatic.size(); i < mShared.size(); ++i)
         {
             writer.startRecord (T::sRecordId);
-            iter->second.save (writer);
+            mShared[i]->save (writer);
             writer.endRecord (T::sRecordId);
         }
     }
@@ -1040,12 +1046,17 @@ namespace MWWorld
             dial.clearDeletedInfos();
         }
 
+        // Dialogues are listed in the order of their lower case IDs
+        std::vector<std::pair<const std::string*, ESM::Dialogue*> > sorted;
+        sorted.reserve(mStatic.size());
+        for (Static::iterator it = mStatic.begin(); it != mStatic.end(); ++it)
+            sorted.push_back(std::make_pair(&it->first, &it->second));
+        std::sort(sorted.begin(), sorted.end(), DialogueKeyLess());
+
         mShared.clear();
-        mShared.reserve(mStatic.size());
-        std::map<std::string, ESM::Dialogue>::iterator it = mStatic.begin();
-        for (; it != mStatic.end(); ++it) {
-            mShared.push_back(&(it->second));
-        }
+        mShared.reserve(sorted.size());
+        for (size_t i = 0; i < sorted.size(); ++i)
+            mShared.push_back(sorted[i].second);
     }
 
     template <>
@@ -1056,12 +1067,11 @@ namespace MWWorld
 
         dialogue.loadId(esm);
 
-        std::string idLower = Misc::StringUtils::lowerCase(dialogue.mId);
-        std::map<std::string, ESM::Dialogue>::iterator found = mStatic.find(idLower);
+        Static::iterator found = mStatic.find(dialogue.mId);
         if (found == mStatic.end())
         {
             dialogue.loadData(esm, isDeleted);
-            mStatic.insert(std::make_pair(idLower, dialogue));
+            mStatic.insert(std::make_pair(Misc::StringUtils::lowerCase(dialogue.mId), dialogue));
         }
         else
         {
@@ -4,6 +4,9 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <unordered_map>
+
+#include <components/misc/stringops.hpp>
 
 #include "recordcmp.hpp"
 
@@ -138,14 +141,17 @@ namespace MWWorld
     template <class T>
     class Store : public StoreBase
     {
-        std::map<std::string, T>      mStatic;
+        // Keyed by the lower case ID. The key functions are case-insensitive, so that lookups
+        // do not need to make a lower case copy of the ID they are given.
+        typedef std::unordered_map<std::string, T, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> Dynamic;
+        typedef std::unordered_map<std::string, T, Misc::StringUtils::CiHash, Misc::StringUtils::CiEqual> Static;
+
+        Static      mStatic;
         std::vector<T *>    mShared; // Preserves the record order as it came from the content files (this
                                      // is relevant for the spell autocalc code and selection order
                                      // for heads/hairs in the character creation)
-        std::map<std::string, T> mDynamic;
-
-        typedef std::map<std::string, T> Dynamic;
-        typedef std::map<std::string, T> Static;
+                                     // The dynamic records follow in the order they were inserted.
+        Dynamic mDynamic;
 
         friend class ESMStore;
 
@@ -48,6 +48,7 @@
 #include "player.hpp"
 #include "manualref.hpp"
 #include "cellstore.hpp"
+#include "savedcells.hpp"
 #include "containerstore.hpp"
 #include "inventorystore.hpp"
 #include "actionteleport.hpp"
@@ -56,6 +57,7 @@
 
 #include "contentloader.hpp"
 #include "esmloader.hpp"
+#include "esmreaderpool.hpp"
 
 namespace
 {
@@ -191,7 +193,10 @@ namespace MWWorld
 
         mWeatherManager = new MWWorld::WeatherManager(*mRendering, mFallback, mStore);
 
-        mWorldScene = new Scene(*mRendering, mPhysics);
+        mReaderPool = new ESMReaderPool(mEsm, encoder);
+        mRendering->initObjectPaging(mStore, mReaderPool.get());
+
+        mWorldScene = new Scene(*mRendering, mPhysics, mReaderPool.get());
     }
 
     void World::fillGlobalVariables()
@@ -335,7 +340,7 @@ namespace MWWorld
         return mCells.countSavedGameRecords();
     }
 
-    void World::write (ESM::ESMWriter& writer, Loading::Listener& progress) const
+    void World::write (ESM::ESMWriter& writer, Loading::Listener& progress, SavedCells* cells) const
     {
         // Active cells could have a dirty fog of war, sync it to the CellStore first
         for (Scene::CellStoreCollection::const_iterator iter (mWorldScene->getActiveCells().begin());
@@ -350,7 +355,13 @@ namespace MWWorld
         mStore.write (writer, progress); // dynamic Store must be written (and read) before Cells, so that
                                          // references to custom made records will be recognized
         mPlayer->write (writer, progress);
-        mCells.write (writer, progress);
+        if (cells)
+        {
+            cells->mPosition = writer.tell();
+            mCells.save (*cells, progress);
+        }
+        else
+            mCells.write (writer, progress);
         mGlobalVariables.write (writer, progress);
         mWeatherManager->write (writer, progress);
         mProjectileManager->write (writer, progress);
@@ -526,14 +537,14 @@ namespace MWWorld
         return &mFallback;
     }
 
-    CellStore *World::getExterior (int x, int y)
+    CellStore *World::getExterior (int x, int y, bool load)
     {
-        return mCells.getExterior (x, y);
+        return mCells.getExterior (x, y, load);
     }
 
-    CellStore *World::getInterior (const std::string& name)
+    CellStore *World::getInterior (const std::string& name, bool load)
     {
-        return mCells.getInterior (name);
+        return mCells.getInterior (name, load);
     }
 
     CellStore *World::getCell (const ESM::CellId& id)
@@ -66,6 +66,7 @@ namespace MWWorld
     class WeatherManager;
     class Player;
     class ProjectileManager;
+    class ESMReaderPool;
 
     /// \brief The game world and its visual representation
 
@@ -81,6 +82,7 @@ namespace MWWorld
             MWWorld::Scene *mWorldScene;
             MWWorld::Player *mPlayer;
             std::vector<ESM::ESMReader> mEsm;
+            osg::ref_ptr<ESMReaderPool> mReaderPool;
             MWWorld::ESMStore mStore;
             LocalScripts mLocalScripts;
             MWWorld::Globals mGlobalVariables;
@@ -200,14 +202,16 @@ namespace MWWorld
             virtual int countSavedGameRecords() const;
             virtual int countSavedGameCells() const;
 
-            virtual void write (ESM::ESMWriter& writer, Loading::Listener& progress) const;
+            virtual void write (ESM::ESMWriter& writer, Loading::Listener& progress, SavedCells* cells = NULL) const;
+            ///< \param cells If not NULL, the cells are only captured into \a cells instead of being written, along with
+            /// the position in the stream of \a writer where their records belong.
 
             virtual void readRecord (ESM::ESMReader& reader, uint32_t type,
                 const std::map<int, int>& contentFileMap);
 
-            virtual CellStore *getExterior (int x, int y);
+            virtual CellStore *getExterior (int x, int y, bool load = true);
 
-            virtual CellStore *getInterior (const std::string& name);
+            virtual CellStore *getInterior (const std::string& name, bool load = true);
 
             virtual CellStore *getCell (const ESM::CellId& id);
 
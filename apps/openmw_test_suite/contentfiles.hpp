@@ -0,0 +1,59 @@
+#ifndef OPENMW_TEST_SUITE_CONTENTFILES_H
+#define OPENMW_TEST_SUITE_CONTENTFILES_H
+
+#include <string>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/program_options.hpp>
+
+#include <components/files/collections.hpp>
+#include <components/files/configurationmanager.hpp>
+
+/// Read the absolute paths of the content files from openmw.cfg, for tests that rely on external content files.
+/// @return The paths, or an empty list if no content files are configured.
+inline std::vector<boost::filesystem::path> readContentFiles(Files::ConfigurationManager& configurationManager)
+{
+    boost::program_options::variables_map variables;
+
+    boost::program_options::options_description desc("Allowed options");
+    desc.add_options()
+    ("data", boost::program_options::value<Files::PathContainer>()->default_value(Files::PathContainer(), "data")->multitoken()->composing())
+    ("content", boost::program_options::value<std::vector<std::string> >()->default_value(std::vector<std::string>(), "")
+        ->multitoken(), "content file(s): esm/esp, or omwgame/omwaddon")
+    ("data-local", boost::program_options::value<std::string>()->default_value(""));
+
+    boost::program_options::notify(variables);
+
+    configurationManager.readConfiguration(variables, desc, true);
+
+    Files::PathContainer dataDirs, dataLocal;
+    if (!variables["data"].empty()) {
+        dataDirs = Files::PathContainer(variables["data"].as<Files::PathContainer>());
+    }
+
+    // the defaults are only stored if a configuration file was found
+    std::string local = variables["data-local"].empty() ? "" : variables["data-local"].as<std::string>();
+    if (!local.empty()) {
+        dataLocal.push_back(Files::PathContainer::value_type(local));
+    }
+
+    configurationManager.processPaths (dataDirs);
+    configurationManager.processPaths (dataLocal, true);
+
+    if (!dataLocal.empty())
+        dataDirs.insert (dataDirs.end(), dataLocal.begin(), dataLocal.end());
+
+    Files::Collections collections (dataDirs, true);
+
+    std::vector<boost::filesystem::path> contentFiles;
+    if (variables["content"].empty())
+        return contentFiles;
+
+    std::vector<std::string> contentNames = variables["content"].as<std::vector<std::string> >();
+    for (std::vector<std::string>::iterator it = contentNames.begin(); it != contentNames.end(); ++it)
+        contentFiles.push_back(collections.getPath(*it));
+    return contentFiles;
+}
+
+#endif
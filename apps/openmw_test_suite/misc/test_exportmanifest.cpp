@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+#include "components/misc/exportmanifest.hpp"
+
+TEST(ExportManifestTest, pending_output_needs_rewrite)
+{
+    boost::filesystem::path root = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%%%%%");
+    boost::filesystem::create_directories(root / "Data/Meshes");
+    std::string output = (root / "Data/Meshes/door.nif").string();
+
+    // a mesh left over from an earlier export
+    std::ofstream(output.c_str()) << "old";
+    std::time_t queued = std::time(NULL);
+    boost::filesystem::last_write_time(output, queued - 60);
+
+    Misc::ExportManifest manifest;
+    manifest.load(root.string());
+    manifest.updatePending(output, 7);
+    EXPECT_FALSE(manifest.isUpToDate(output, 7));
+
+    manifest.save();
+    manifest.load(root.string());
+    EXPECT_FALSE(manifest.isUpToDate(output, 7));
+
+    // the job has run
+    boost::filesystem::last_write_time(output, queued + 60);
+    EXPECT_TRUE(manifest.isUpToDate(output, 7));
+    EXPECT_FALSE(manifest.isUpToDate(output, 8));
+
+    manifest.update(output, 8);
+    boost::filesystem::last_write_time(output, queued - 60);
+    EXPECT_TRUE(manifest.isUpToDate(output, 8));
+
+    boost::filesystem::remove(output);
+    EXPECT_FALSE(manifest.isUpToDate(output, 8));
+
+    boost::filesystem::remove_all(root);
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <boost/filesystem.hpp>
+
+#include "components/misc/exportrecordcache.hpp"
+
+namespace
+{
+    Misc::ExportRecordCache::Record makeRecord(Misc::ExportRecordCache::Hash hash, const std::string& data)
+    {
+        Misc::ExportRecordCache::Record record;
+        record.mHash = hash;
+        record.mData = data;
+
+        Misc::ExportRecordCache::Asset asset;
+        asset.mType = Misc::ExportRecordCache::Asset::Type_Model;
+        asset.mSource = "w\\iron dagger.nif";
+        asset.mOutput = "morro\\w\\iron dagger.nif";
+        asset.mFlags = 2;
+        record.mAssets.push_back(asset);
+
+        record.mReferences["iron dagger"] = 0x01010005;
+        return record;
+    }
+
+    std::map<std::string, uint32_t> makeFormIDs()
+    {
+        std::map<std::string, uint32_t> formIDs;
+        formIDs["iron dagger"] = 0x01010005;
+        formIDs["steel sword"] = 0x01010006;
+        return formIDs;
+    }
+
+    std::string makeCachePath()
+    {
+        return (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("%%%%%%%%.cache")).string();
+    }
+}
+
+TEST(ExportRecordCacheTest, save_and_load)
+{
+    std::string path = makeCachePath();
+
+    Misc::ExportRecordCache cache;
+    cache.load(path);
+    EXPECT_EQ(0u, cache.getFormID("dagger"));
+
+    cache.setFormID("Dagger", 0x10005);
+    cache.validate(42, makeFormIDs());
+    cache.storeRecord("WEAPDagger", makeRecord(7, std::string("WEAP\0\0\0\0", 8)));
+    cache.storeRecord("WEAPSword", makeRecord(8, "WEAP"));
+    cache.save();
+
+    cache.load(path);
+    EXPECT_EQ(0x10005u, cache.getFormID("DAGGER"));
+    EXPECT_TRUE(cache.isFormIDUsed(0x10005));
+    EXPECT_FALSE(cache.isFormIDUsed(0x10006));
+
+    cache.validate(42, makeFormIDs());
+    EXPECT_EQ(NULL, cache.findRecord("weapdagger", 8));
+    const Misc::ExportRecordCache::Record* record = cache.findRecord("weapdagger", 7);
+    ASSERT_TRUE(record != NULL);
+    EXPECT_EQ(std::string("WEAP\0\0\0\0", 8), record->mData);
+    ASSERT_EQ(1u, record->mAssets.size());
+    EXPECT_EQ("morro\\w\\iron dagger.nif", record->mAssets[0].mOutput);
+    EXPECT_EQ(2, record->mAssets[0].mFlags);
+    ASSERT_EQ(1u, record->mReferences.size());
+    EXPECT_EQ(0x01010005u, record->mReferences.find("iron dagger")->second);
+
+    // only the records used by the last export are kept
+    cache.save();
+    cache.load(path);
+    EXPECT_EQ(1u, cache.getNumRecords());
+
+    // different export options or masters make all records useless
+    cache.validate(43, makeFormIDs());
+    EXPECT_EQ(0u, cache.getNumRecords());
+    EXPECT_EQ(0x10005u, cache.getFormID("dagger"));
+
+    boost::filesystem::remove(path);
+}
+
+TEST(ExportRecordCacheTest, validate_keeps_records_with_unchanged_references)
+{
+    std::string path = makeCachePath();
+
+    Misc::ExportRecordCache cache;
+    cache.load(path);
+    cache.validate(42, makeFormIDs());
+
+    Misc::ExportRecordCache::Record dagger = makeRecord(7, "WEAP");
+    Misc::ExportRecordCache::Record sword = makeRecord(8, "WEAP");
+    sword.mReferences.clear();
+    sword.mReferences["steel sword"] = 0x01010006;
+    sword.mReferences["fire enchantment"] = 0;
+    cache.storeRecord("WEAPIronDagger", dagger);
+    cache.storeRecord("WEAPSteelSword", sword);
+
+    // adding an unrelated record does not change what the cached records refer to
+    std::map<std::string, uint32_t> formIDs = makeFormIDs();
+    formIDs["silver axe"] = 0x01010007;
+    cache.validate(42, formIDs);
+    EXPECT_EQ(2u, cache.getNumRecords());
+    EXPECT_TRUE(cache.findRecord("weapirondagger", 7) != NULL);
+    EXPECT_TRUE(cache.findRecord("weapsteelsword", 8) != NULL);
+
+    // a stringID that did not resolve before does now
+    formIDs["fire enchantment"] = 0x01010008;
+    cache.validate(42, formIDs);
+    EXPECT_EQ(1u, cache.getNumRecords());
+    EXPECT_TRUE(cache.findRecord("weapirondagger", 7) != NULL);
+    EXPECT_EQ(NULL, cache.findRecord("weapsteelsword", 8));
+
+    // a referenced record was removed
+    formIDs.erase("iron dagger");
+    cache.validate(42, formIDs);
+    EXPECT_EQ(0u, cache.getNumRecords());
+
+    boost::filesystem::remove(path);
+}
@@ -65,3 +65,28 @@ TEST_F(KeywordSearchTest, keyword_test_conflict_resolution3)
     ASSERT_TRUE (matches.size() == 1);
     ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "bar lock");
 }
+
+TEST_F(KeywordSearchTest, keyword_test_prefix_and_end_of_text)
+{
+    // keywords that are prefixes of other keywords, and keywords at the very end of the text, must be found
+    MWDialogue::KeywordSearch<std::string, int> search;
+    search.seed("bar lock", 0);
+    search.seed("bar", 1);
+    search.seed("a", 2);
+
+    std::string text = "Bar, a";
+
+    std::vector<MWDialogue::KeywordSearch<std::string, int>::Match> matches;
+    search.highlightKeywords(text.begin(), text.end(), matches);
+
+    ASSERT_TRUE (matches.size() == 2);
+    ASSERT_TRUE (std::string(matches.front().mBeg, matches.front().mEnd) == "Bar");
+    ASSERT_TRUE (matches.front().mValue == 1);
+    ASSERT_TRUE (std::string(matches.rbegin()->mBeg, matches.rbegin()->mEnd) == "a");
+    ASSERT_TRUE (matches.rbegin()->mValue == 2);
+
+    int value = -1;
+    ASSERT_TRUE (search.containsKeyword("BAR", value));
+    ASSERT_TRUE (value == 1);
+    ASSERT_FALSE (search.containsKeyword("bar l", value));
+}
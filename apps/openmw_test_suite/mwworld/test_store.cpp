@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include <boost/filesystem/fstream.hpp>
 
 #include <components/files/configurationmanager.hpp>
@@ -9,6 +11,8 @@
 
 #include "apps/openmw/mwworld/esmstore.hpp"
 
+#include "../contentfiles.hpp"
+
 static Loading::Listener dummyListener;
 
 /// Base class for tests of ESMStore that rely on external content files to produce the test results
@@ -18,7 +22,7 @@ struct ContentFileTest : public ::testing::Test
 
     virtual void SetUp()
     {
-        readContentFiles();
+        mContentFiles = readContentFiles(mConfigurationManager);
 
         // load the content files
         std::vector<ESM::ESMReader> readerList;
@@ -45,45 +49,6 @@ struct ContentFileTest : public ::testing::Test
     {
     }
 
-    // read absolute path to content files from openmw.cfg
-    void readContentFiles()
-    {
-        boost::program_options::variables_map variables;
-
-        boost::program_options::options_description desc("Allowed options");
-        desc.add_options()
-        ("data", boost::program_options::value<Files::PathContainer>()->default_value(Files::PathContainer(), "data")->multitoken()->composing())
-        ("content", boost::program_options::value<std::vector<std::string> >()->default_value(std::vector<std::string>(), "")
-            ->multitoken(), "content file(s): esm/esp, or omwgame/omwaddon")
-        ("data-local", boost::program_options::value<std::string>()->default_value(""));
-
-        boost::program_options::notify(variables);
-
-        mConfigurationManager.readConfiguration(variables, desc, true);
-
-        Files::PathContainer dataDirs, dataLocal;
-        if (!variables["data"].empty()) {
-            dataDirs = Files::PathContainer(variables["data"].as<Files::PathContainer>());
-        }
-
-        std::string local = variables["data-local"].as<std::string>();
-        if (!local.empty()) {
-            dataLocal.push_back(Files::PathContainer::value_type(local));
-        }
-
-        mConfigurationManager.processPaths (dataDirs);
-        mConfigurationManager.processPaths (dataLocal, true);
-
-        if (!dataLocal.empty())
-            dataDirs.insert (dataDirs.end(), dataLocal.begin(), dataLocal.end());
-
-        Files::Collections collections (dataDirs, true);
-
-        std::vector<std::string> contentFiles = variables["content"].as<std::vector<std::string> >();
-        for (std::vector<std::string>::iterator it = contentFiles.begin(); it != contentFiles.end(); ++it)
-            mContentFiles.push_back(collections.getPath(*it));
-    }
-
 protected:
     Files::ConfigurationManager mConfigurationManager;
     MWWorld::ESMStore mEsmStore;
@@ -313,3 +278,85 @@ TEST_F(StoreTest, overwrite_test)
 
     ASSERT_TRUE (overwrittenRec && overwrittenRec->mModel == "the_new_model");
 }
+
+/// Tests that lookups ignore letter case and that dynamic records keep their insertion order.
+TEST_F(StoreTest, dynamic_order_test)
+{
+    typedef ESM::Apparatus RecordType;
+
+    MWWorld::Store<RecordType> store;
+
+    RecordType record;
+    record.blank();
+    record.mId = "static";
+    store.insertStatic(record);
+
+    const char* ids[] = { "zeta", "Alpha", "mu", "beta" };
+    for (size_t i=0; i<sizeof(ids)/sizeof(ids[0]); ++i)
+    {
+        record.mId = ids[i];
+        store.insert(record);
+    }
+
+    ASSERT_TRUE (store.search("ALPHA") != NULL);
+    ASSERT_TRUE (store.search("Static") != NULL);
+    ASSERT_TRUE (store.isDynamic("Mu"));
+    ASSERT_FALSE (store.isDynamic("static"));
+
+    ASSERT_TRUE (store.erase("MU"));
+    ASSERT_TRUE (store.search("mu") == NULL);
+
+    const char* expected[] = { "static", "zeta", "Alpha", "beta" };
+    ASSERT_EQ (store.getSize(), sizeof(expected)/sizeof(expected[0]));
+    size_t index = 0;
+    for (MWWorld::Store<RecordType>::iterator it = store.begin(); it != store.end(); ++it, ++index)
+        ASSERT_EQ (it->mId, expected[index]);
+}
+
+/// Compare the lookup throughput of Store<T>::search with a lower-casing std::map lookup.
+TEST_F(StoreTest, lookup_benchmark)
+{
+    typedef ESM::Apparatus RecordType;
+
+    const int numRecords = 2000;
+    const int numLookups = 200000;
+
+    MWWorld::Store<RecordType> store;
+    std::map<std::string, RecordType> map;
+    std::vector<std::string> queries;
+
+    RecordType record;
+    record.blank();
+    for (int i=0; i<numRecords; ++i)
+    {
+        std::ostringstream stream;
+        stream << "fSomeGameSetting" << i;
+        record.mId = Misc::StringUtils::lowerCase(stream.str());
+        store.insertStatic(record);
+        map[record.mId] = record;
+        queries.push_back(stream.str());
+    }
+
+    size_t found = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i=0; i<numLookups; ++i)
+    {
+        std::map<std::string, RecordType>::const_iterator it = map.find(Misc::StringUtils::lowerCase(queries[i % numRecords]));
+        if (it != map.end())
+            ++found;
+    }
+    std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+    for (int i=0; i<numLookups; ++i)
+    {
+        if (store.search(queries[i % numRecords]))
+            ++found;
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+    ASSERT_EQ (found, static_cast<size_t>(2 * numLookups));
+
+    double mapTime = std::chrono::duration<double>(middle - start).count();
+    double storeTime = std::chrono::duration<double>(end - middle).count();
+    std::cout << "lookup_benchmark: std::map " << numLookups / mapTime << " lookups/s, Store "
+              << numLookups / storeTime << " lookups/s" << std::endl;
+}
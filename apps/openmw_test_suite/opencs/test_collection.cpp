@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iterator>
+#include <list>
+#include <random>
+#include <sstream>
+
+#include <components/esm/esmreader.hpp>
+#include <components/esm/loadcell.hpp>
+
+#include "apps/opencs/model/world/collection.hpp"
+#include "apps/opencs/model/world/ref.hpp"
+#include "apps/opencs/model/world/refcollection.hpp"
+#include "apps/opencs/model/world/cell.hpp"
+
+#include "../contentfiles.hpp"
+
+namespace
+{
+    typedef CSMWorld::Collection<CSMWorld::CellRef> RefCollection;
+
+    CSMWorld::Record<CSMWorld::CellRef> makeRecord(const std::string& id, const std::string& cell = "")
+    {
+        CSMWorld::Record<CSMWorld::CellRef> record;
+        record.mState = CSMWorld::RecordBase::State_BaseOnly;
+        record.mBase.blank();
+        record.mBase.mId = id;
+        record.mBase.mCell = cell;
+        return record;
+    }
+
+    /// Check that every row can be found by its ID and the other way round.
+    void checkIndex(const RefCollection& collection)
+    {
+        for (int i=0; i<collection.getSize(); ++i)
+            EXPECT_EQ(i, collection.searchId(collection.getId(i)));
+        EXPECT_EQ(static_cast<size_t>(collection.getSize()), collection.getIds().size());
+    }
+}
+
+TEST(CollectionTest, insert_remove)
+{
+    RefCollection collection;
+    collection.appendRecord(makeRecord("a"));
+    collection.appendRecord(makeRecord("c"));
+    collection.insertRecord(makeRecord("b"), 1);
+    collection.insertRecord(makeRecord("start"), 0);
+
+    ASSERT_EQ(4, collection.getSize());
+    EXPECT_EQ("start", collection.getId(0));
+    EXPECT_EQ("a", collection.getId(1));
+    EXPECT_EQ("b", collection.getId(2));
+    EXPECT_EQ("c", collection.getId(3));
+    checkIndex(collection);
+
+    // the records must not move in memory when rows are inserted or removed before them
+    const CSMWorld::Record<CSMWorld::CellRef>* recordC = &collection.getRecord(3);
+    collection.removeRows(0, 2);
+    ASSERT_EQ(2, collection.getSize());
+    EXPECT_EQ(recordC, &collection.getRecord(1));
+    EXPECT_EQ(-1, collection.searchId("a"));
+    checkIndex(collection);
+
+    collection.insertRecord(makeRecord("a"), 0);
+    EXPECT_EQ(recordC, &collection.getRecord("C"));
+    checkIndex(collection);
+}
+
+TEST(CollectionTest, set_record_keeps_id)
+{
+    RefCollection collection;
+    collection.appendRecord(makeRecord("a"));
+
+    CSMWorld::Record<CSMWorld::CellRef> record = makeRecord("A");
+    record.mBase.mScale = 2.f;
+    collection.setRecord(0, record);
+    EXPECT_EQ(2.f, collection.getRecord(0).get().mScale);
+
+    EXPECT_THROW(collection.setRecord(0, makeRecord("b")), std::runtime_error);
+    EXPECT_THROW(collection.getRecord(1), std::out_of_range);
+}
+
+TEST(CollectionTest, cell_index)
+{
+    CSMWorld::Collection<CSMWorld::Cell> cells;
+    CSMWorld::RefCollection refs (cells);
+    refs.appendRecord(makeRecord("ref#0", "Balmora"));
+    refs.appendRecord(makeRecord("ref#1", "#0 0"));
+    refs.appendRecord(makeRecord("ref#2", "balmora"));
+    refs.insertRecord(makeRecord("ref#3", "Balmora"), 0);
+
+    EXPECT_EQ(std::vector<int>({0, 1, 3}), refs.getCellRows("BALMORA"));
+    EXPECT_EQ(std::vector<int>({2}), refs.getCellRows("#0 0"));
+    EXPECT_TRUE(refs.getCellRows("Vivec").empty());
+
+    // deleted references stay in their cell until they are purged
+    CSMWorld::Record<CSMWorld::CellRef> record = refs.getRecord(0);
+    record.mState = CSMWorld::RecordBase::State_Deleted;
+    refs.setRecord(0, record);
+    EXPECT_EQ(std::vector<int>({0, 1, 3}), refs.getCellRows("balmora"));
+
+    // moving a reference to another cell
+    record = refs.getRecord(1);
+    record.mState = CSMWorld::RecordBase::State_Modified;
+    record.mModified = record.mBase;
+    record.mModified.mCell = "Vivec";
+    refs.setRecord(1, record);
+    EXPECT_EQ(std::vector<int>({0, 3}), refs.getCellRows("balmora"));
+    EXPECT_EQ(std::vector<int>({1}), refs.getCellRows("vivec"));
+
+    refs.removeRows(0, 1);
+    EXPECT_EQ(std::vector<int>({2}), refs.getCellRows("balmora"));
+    EXPECT_EQ(std::vector<int>({0}), refs.getCellRows("vivec"));
+    EXPECT_EQ(std::vector<int>({1}), refs.getCellRows("#0 0"));
+}
+
+/// Compare indexed access to the references of the first content file (usually Morrowind.esm) with walking a list,
+/// which is what the collection used to do.
+TEST(CollectionTest, reference_table_benchmark)
+{
+    Files::ConfigurationManager configurationManager;
+    std::vector<boost::filesystem::path> contentFiles = readContentFiles(configurationManager);
+    if (contentFiles.empty())
+    {
+        std::cout << "No content files found, skipping test" << std::endl;
+        return;
+    }
+
+    RefCollection collection;
+
+    ESM::ESMReader reader;
+    reader.setEncoder(NULL);
+    reader.open(contentFiles.front().string());
+
+    int numRefs = 0;
+    while (reader.hasMoreRecs())
+    {
+        ESM::NAME name = reader.getRecName();
+        reader.getRecHeader();
+        if (name.intval != ESM::REC_CELL)
+        {
+            reader.skipRecord();
+            continue;
+        }
+
+        ESM::Cell cell;
+        bool isDeleted = false;
+        cell.load(reader, isDeleted, false);
+
+        CSMWorld::CellRef ref;
+        ESM::MovedCellRef movedRef;
+        while (ESM::Cell::getNextRef(reader, ref, isDeleted, true, &movedRef))
+        {
+            std::ostringstream id;
+            id << "ref#" << numRefs++;
+            ref.mId = id.str();
+
+            CSMWorld::Record<CSMWorld::CellRef> record;
+            record.mState = CSMWorld::RecordBase::State_BaseOnly;
+            record.mBase = ref;
+            collection.appendRecord(record);
+        }
+        if (reader.hasMoreSubs())
+            reader.skipRecord();
+    }
+
+    ASSERT_EQ(numRefs, collection.getSize());
+
+    std::list<CSMWorld::Record<CSMWorld::CellRef> > list;
+    for (int i=0; i<collection.getSize(); ++i)
+        list.push_back(collection.getRecord(i));
+
+    // rows in the order a sorted or filtered table view asks for them
+    std::vector<int> rows;
+    std::mt19937 random (42);
+    std::uniform_int_distribution<int> distribution (0, collection.getSize()-1);
+    for (int i=0; i<2000; ++i)
+        rows.push_back(distribution(random));
+
+    typedef std::chrono::high_resolution_clock Clock;
+
+    unsigned int checksum = 0;
+    Clock::time_point start = Clock::now();
+    for (std::vector<int>::const_iterator it = rows.begin(); it != rows.end(); ++it)
+        checksum += std::next(list.begin(), *it)->get().mRefNum.mIndex;
+    double listTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    unsigned int checksum2 = 0;
+    start = Clock::now();
+    for (std::vector<int>::const_iterator it = rows.begin(); it != rows.end(); ++it)
+        checksum2 += collection.getRecord(*it).get().mRefNum.mIndex;
+    double collectionTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    EXPECT_EQ(checksum, checksum2);
+
+    start = Clock::now();
+    checkIndex(collection);
+    double scanTime = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "reference_table_benchmark: " << collection.getSize() << " references, " << rows.size() << " random rows: list "
+              << listTime * 1000 << " ms, collection " << collectionTime * 1000 << " ms; full ID scan "
+              << scanTime * 1000 << " ms" << std::endl;
+}
@@ -10,6 +10,7 @@ void inline OutputDebugString(const char *c_string) { std::cout << c_string; };
 
 #include <sstream>
 #include <cassert>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
 
@@ -73,6 +74,9 @@ namespace ESM
 		, mEnableCompressionWriteRedirect(false)
 		, mCompressNextRecord(false)
 		, mCompressionStream(NULL)
+		, mCaptureNextRecord(false)
+		, mCapturingRecord(false)
+		, mCaptureTexturesStart(0)
     {}
 
     unsigned int ESMWriter::getVersion() const
@@ -224,6 +228,11 @@ namespace ESM
             throw std::runtime_error ("Unclosed record remaining");
     }
 
+    std::streampos ESMWriter::tell() const
+    {
+        return mStream->tellp();
+    }
+
     void ESMWriter::startRecord(const std::string& name, uint32_t flags)
     {
         mRecordCount++;
@@ -256,6 +265,8 @@ namespace ESM
 		std::stringstream debugstream;
 		uint32_t activeID = formID;
 		bool bSuccess = true;
+		bool capture = mCaptureNextRecord;
+		mCaptureNextRecord = false;
 
 		if (name == "TES4")
 			activeID = 0;
@@ -285,7 +296,18 @@ namespace ESM
 			bSuccess = false;
 			return bSuccess;
 		}
-		
+
+		if (capture)
+		{
+			mCapturingRecord = true;
+			mCaptureKey = name + stringID;
+			mCaptureTexturesStart = mDDSToExportList.size();
+			mCapturedRecord.mData.clear();
+			mCapturedRecord.mAssets.clear();
+			mCapturedRecord.mReferences.clear();
+			mCapturedRecord.mReferences[Misc::StringUtils::lowerCase(stringID)] = activeID;
+		}
+
 		mRecordCount++;
 		writeName(name);
 
@@ -463,6 +485,22 @@ namespace ESM
 		mCounting = true;
 		mStream->seekp(0, std::ios_base::end);
 
+		if (mCapturingRecord)
+		{
+			// the size was not known yet when the record header was captured, it follows the record name
+			mCapturedRecord.mData.replace(4, sizeof(uint32_t), reinterpret_cast<const char*> (&rec.size), sizeof(uint32_t));
+			for (size_t i=mCaptureTexturesStart; i<mDDSToExportList.size(); ++i)
+			{
+				Misc::ExportRecordCache::Asset asset;
+				asset.mType = Misc::ExportRecordCache::Asset::Type_Texture;
+				asset.mSource = mDDSToExportList[i].first;
+				asset.mOutput = mDDSToExportList[i].second.first;
+				asset.mFlags = mDDSToExportList[i].second.second;
+				mCapturedRecord.mAssets.push_back(asset);
+			}
+			mExportCache.storeRecord(mCaptureKey, mCapturedRecord);
+			mCapturingRecord = false;
+		}
 	}
 
 	void ESMWriter::endRecordTES4 (uint32_t name)
@@ -609,6 +647,8 @@ namespace ESM
 				for (std::list<RecordData>::iterator it = mRecords.begin(); it != mRecords.end(); ++it)
 					it->size += size;
 			}
+			if (mCapturingRecord && mCounting)
+				mCapturedRecord.mData.append(data, size);
 			mStream->write(data, size);
 		}
 		else
@@ -858,7 +898,6 @@ namespace ESM
 		if (mFormIDMap.size() == 0)
 		{
 			mLowestAvailableID = 0x10001 | mESMoffset;;
-			return mLowestAvailableID;
 		}
 
 		// sanity check
@@ -868,7 +907,9 @@ namespace ESM
 			mLowestAvailableID = tempID | mESMoffset;
 		}
 
-		while ( mFormIDMap.find(mLowestAvailableID) != mFormIDMap.end() )
+		// FormIDs from the previous export stay reserved for the records they were assigned to
+		while ( mFormIDMap.find(mLowestAvailableID) != mFormIDMap.end() ||
+			mExportCache.isFormIDUsed(mLowestAvailableID & 0x00FFFFFF) )
 		{
 			mLowestAvailableID++;
 		}
@@ -910,6 +951,14 @@ namespace ESM
 
 		}
 
+		// an auto-assigned formID is replaced by the one the record got in the previous export
+		if (setup_phase == false && formID == mLowestAvailableID)
+		{
+			uint32_t cachedFormID = mExportCache.getFormID(stringID);
+			if (cachedFormID != 0 && mFormIDMap.find(cachedFormID | mESMoffset) == mFormIDMap.end())
+				formID = cachedFormID | mESMoffset;
+		}
+
 		auto currentFormIDreserve = mFormIDMap.find(formID);
 		if (currentFormIDreserve != mFormIDMap.end())
 		{
@@ -972,6 +1021,62 @@ namespace ESM
 		mStringTypeMap.clear();
 		mUniqueIDcheck.clear();
 		mCellnameMgr.clear();
+		mCaptureNextRecord = false;
+		mCapturingRecord = false;
+	}
+
+	void ESMWriter::validateExportCache()
+	{
+		// cached records contain the FormIDs of the records they refer to, so each one can only be
+		// reused if the stringIDs it refers to still resolve to the same FormIDs, see crossRefStringID()
+		Misc::ExportRecordCache::Hash settingsHash = Misc::ExportManifest::hash(mConversionOptions);
+		for (std::vector<Header::MasterData>::const_iterator it = mHeader.mMaster.begin(); it != mHeader.mMaster.end(); ++it)
+			settingsHash = Misc::ExportManifest::hash(it->name, settingsHash);
+		mExportCache.validate(settingsHash, mStringIDMap);
+	}
+
+	void ESMWriter::saveExportCache()
+	{
+		for (std::map<std::string, uint32_t>::const_iterator it = mStringIDMap.begin(); it != mStringIDMap.end(); ++it)
+		{
+			if ((it->second & 0xFF000000) == mESMoffset)
+				mExportCache.setFormID(it->first, it->second & 0x00FFFFFF);
+		}
+		mExportCache.save();
+	}
+
+	bool ESMWriter::writeCachedRecordTES4(const std::string& name, const std::string& stringID, Misc::ExportRecordCache::Hash sourceHash)
+	{
+		const Misc::ExportRecordCache::Record* record = mExportCache.findRecord(name + stringID, sourceHash);
+		// name, size, flags, formID, version control
+		if (record == NULL || record->mData.size() < 20 || (!mRecords.empty() && mRecords.back().name != "GRUP"))
+			return false;
+
+		uint32_t formID = 0;
+		std::memcpy(&formID, &record->mData[12], sizeof(uint32_t));
+		if (mUniqueIDcheck.find(formID) != mUniqueIDcheck.end())
+			return false;
+
+		mRecordCount++;
+		write(record->mData.data(), record->mData.size());
+		mUniqueIDcheck.insert( std::make_pair(formID, mUniqueIDcheck.size()) );
+		mCompressNextRecord = false;
+
+		for (std::vector<Misc::ExportRecordCache::Asset>::const_iterator it = record->mAssets.begin(); it != record->mAssets.end(); ++it)
+		{
+			if (it->mType == Misc::ExportRecordCache::Asset::Type_Model)
+				QueueModelForExport(it->mSource, it->mOutput, it->mFlags);
+			else
+				mDDSToExportList.push_back(std::make_pair(it->mSource, std::make_pair(it->mOutput, it->mFlags)));
+		}
+
+		return true;
+	}
+
+	void ESMWriter::captureNextRecordTES4(Misc::ExportRecordCache::Hash sourceHash)
+	{
+		mCaptureNextRecord = true;
+		mCapturedRecord.mHash = sourceHash;
 	}
 
 	uint32_t ESMWriter::crossRefStringID(const std::string& stringID, const std::string &sSIG, bool convertToEDID, bool creating_record)
@@ -1033,6 +1138,8 @@ namespace ESM
 		}
 
 		auto searchResult = mStringIDMap.find(Misc::StringUtils::lowerCase(tempString));
+		if (mCapturingRecord)
+			mCapturedRecord.mReferences[Misc::StringUtils::lowerCase(tempString)] = searchResult != mStringIDMap.end() ? searchResult->second : 0;
 		auto typeResult = mStringTypeMap.find(Misc::StringUtils::lowerCase(tempString));
 
 		std::string tempSIG = Misc::StringUtils::lowerCase(sSIG);
@@ -3462,6 +3569,16 @@ namespace ESM
 
 	void ESMWriter::QueueModelForExport(const std::string &origString, const std::string &outputString, int recordType)
 	{
+        if (mCapturingRecord)
+        {
+            Misc::ExportRecordCache::Asset asset;
+            asset.mType = Misc::ExportRecordCache::Asset::Type_Model;
+            asset.mSource = origString;
+            asset.mOutput = outputString;
+            asset.mFlags = recordType;
+            mCapturedRecord.mAssets.push_back(asset);
+        }
+
         // Do NOT normalize convertedString, since it may include commandline switches in addition to filepath strings
         std::string convertedString = outputString;
         // convert name to LOD format as needed
@@ -17,6 +17,9 @@
 #include <list>
 #include <map>
 
+#include <components/misc/exportmanifest.hpp>
+#include <components/misc/exportrecordcache.hpp>
+
 #include "loadskil.hpp"
 #include "attr.hpp"
 #include "esmcommon.hpp"
@@ -83,6 +86,9 @@ class ESMWriter
 
         void close();
         ///< \note Does not close the stream.
+
+        std::streampos tell() const;
+        ///< Position in the stream passed to save(), e.g. to insert records that are written separately.
 		void updateTES4();
 
         void writeHNString(const std::string& name, const std::string& data);
@@ -249,6 +255,22 @@ public:
 		// SOUND List for export
 		std::map<std::string, std::pair<std::string, int>> mSOUNDToExportList;
 
+		// Source content hashes of previously exported assets, used to skip unchanged assets on re-export
+		Misc::ExportManifest mExportManifest;
+
+		// FormIDs and serialized records of the previous export of this plugin, reused to keep FormIDs stable
+		// and to skip serializing records that did not change
+		Misc::ExportRecordCache mExportCache;
+		/// Call once all FormIDs of the export have been reserved, before any record is written.
+		void validateExportCache();
+		/// Store the FormIDs of this plugin's records in the cache and write it.
+		void saveExportCache();
+		/// Write the cached record \a stringID of type \a name if it was serialized from source data with \a sourceHash.
+		/// @return false if there is no such record, it must then be serialized normally.
+		bool writeCachedRecordTES4(const std::string& name, const std::string& stringID, Misc::ExportRecordCache::Hash sourceHash);
+		/// Store the next record that is written in the cache, as serialized from source data with \a sourceHash.
+		void captureNextRecordTES4(Misc::ExportRecordCache::Hash sourceHash);
+
 		// BaseOjbect stringID map for creation of Persistent REFs
 		std::map<std::string, std::pair<std::string, int>> mBaseObjToScriptedREFList;
 		void RegisterBaseObjForScriptedREF(const std::string &stringID, std::string sSIG, int nMode=0);
@@ -280,6 +302,12 @@ public:
 		std::ofstream* mCompressionStream;
 		char mTempfilename[MAX_PATH];
 
+		bool mCaptureNextRecord;
+		bool mCapturingRecord;
+		std::string mCaptureKey;
+		size_t mCaptureTexturesStart;
+		Misc::ExportRecordCache::Record mCapturedRecord;
+
         Header mHeader;
 		std::streampos mBookmarkPoint;
 
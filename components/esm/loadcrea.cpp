@@ -19,6 +19,7 @@ void inline OutputDebugString(const char *c_string) { std::cout << c_string; };
 #include <apps/opencs/model/doc/document.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/misc/exportmanifest.hpp>
 
 namespace ESM {
 
@@ -202,15 +203,7 @@ namespace ESM {
 		std::string logRoot = outputRoot;
 #endif
 */
-		std::string outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
-		if (outputRoot.length() == 0)
-		{
-#ifdef _WIN32
-			std::string outputRoot = "C:";
-#else
-			std::string outputRoot = getenv("HOME");
-#endif
-		}
+		std::string outputRoot = Misc::getExportOutputRoot();
 		outputRoot += "/";
 		std::string logRoot = outputRoot + "Oblivion.output/";
 
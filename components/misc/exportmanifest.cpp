@@ -0,0 +1,199 @@
+#include "exportmanifest.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include <boost/filesystem.hpp>
+
+#include <OpenThreads/ScopedLock>
+
+#include "resourcehelpers.hpp"
+#include "stringops.hpp"
+
+namespace
+{
+    const char* sManifestName = "modexporter_manifest.txt";
+}
+
+namespace Misc
+{
+
+std::string getExportOutputRoot()
+{
+    const char* outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
+    if (outputRoot != NULL && outputRoot[0] != '\0')
+        return outputRoot;
+#ifdef _WIN32
+    return "C:";
+#else
+    const char* home = getenv("HOME");
+    return home != NULL ? home : "";
+#endif
+}
+
+ExportManifest::Hash ExportManifest::hash(const char *data, size_t size, Hash seed)
+{
+    Hash result = seed;
+    for (size_t i=0; i<size; ++i)
+    {
+        result ^= static_cast<unsigned char>(data[i]);
+        result *= 1099511628211ULL;
+    }
+    return result;
+}
+
+ExportManifest::Hash ExportManifest::hash(const std::string &str, Hash seed)
+{
+    return hash(str.c_str(), str.size(), seed);
+}
+
+ExportManifest::ExportManifest()
+{
+}
+
+void ExportManifest::load(const std::string &rootDir)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+    mRootDir = ResourceHelpers::getNormalizedPath(rootDir);
+    if (!mRootDir.empty() && mRootDir[mRootDir.size()-1] != '/')
+        mRootDir += '/';
+    mEntries.clear();
+
+    std::ifstream stream ((mRootDir + sManifestName).c_str());
+    if (!stream.is_open())
+        return;
+
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        // <16 hex digits>[@<time queued>] <relative output path>
+        if (line.size() < 18 || (line[16] != ' ' && line[16] != '@'))
+            continue;
+
+        std::istringstream hashStream (line.substr(0, 16));
+        Entry entry;
+        entry.mHash = 0;
+        entry.mQueued = 0;
+        hashStream >> std::hex >> entry.mHash;
+        if (hashStream.fail())
+            continue;
+
+        size_t pathStart = 17;
+        if (line[16] == '@')
+        {
+            size_t space = line.find(' ', 17);
+            if (space == std::string::npos || space + 1 >= line.size())
+                continue;
+            std::istringstream timeStream (line.substr(17, space - 17));
+            long long queued = 0;
+            timeStream >> queued;
+            if (timeStream.fail())
+                continue;
+            entry.mQueued = static_cast<std::time_t>(queued);
+            pathStart = space + 1;
+        }
+
+        mEntries[line.substr(pathStart)] = entry;
+    }
+
+    std::cout << "Export manifest: " << mEntries.size() << " entries loaded from " << mRootDir << sManifestName << std::endl;
+}
+
+void ExportManifest::save() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+
+    if (mRootDir.empty())
+        return;
+
+    if (!boost::filesystem::exists(mRootDir))
+        boost::filesystem::create_directories(mRootDir);
+
+    // write to a temporary file first, so that an interrupted export does not leave a truncated manifest
+    std::string path = mRootDir + sManifestName;
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream stream (tmpPath.c_str(), std::ios_base::out | std::ios_base::trunc);
+        for (std::map<std::string, Entry>::const_iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+        {
+            stream << std::hex << std::setw(16) << std::setfill('0') << it->second.mHash;
+            if (it->second.mQueued != 0)
+                stream << '@' << std::dec << static_cast<long long>(it->second.mQueued);
+            stream << ' ' << it->first << '\n';
+        }
+        if (!stream.good())
+        {
+            std::cerr << "Export manifest: failed to write " << tmpPath << std::endl;
+            return;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+        std::cerr << "Export manifest: failed to write " << path << ": " << ec.message() << std::endl;
+}
+
+bool ExportManifest::isUpToDate(const std::string &outputPath, Hash hash) const
+{
+    std::string key = getKey(outputPath);
+    std::time_t queued = 0;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+        std::map<std::string, Entry>::const_iterator found = mEntries.find(key);
+        if (found == mEntries.end() || found->second.mHash != hash)
+            return false;
+        queued = found->second.mQueued;
+    }
+
+    boost::system::error_code ec;
+    std::time_t written = boost::filesystem::last_write_time(outputPath, ec);
+    if (ec)
+        return false;
+    // an output that predates its job was left over from an earlier export, the job has not run or failed
+    return written >= queued;
+}
+
+void ExportManifest::update(const std::string &outputPath, Hash hash)
+{
+    std::string key = getKey(outputPath);
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+    Entry& entry = mEntries[key];
+    entry.mHash = hash;
+    entry.mQueued = 0;
+}
+
+void ExportManifest::updatePending(const std::string &outputPath, Hash hash)
+{
+    std::string key = getKey(outputPath);
+    std::time_t now = std::time(NULL);
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+    Entry& entry = mEntries[key];
+    // keep the original time if the same content is queued again before the job has run
+    if (entry.mQueued == 0 || entry.mHash != hash)
+        entry.mQueued = now;
+    entry.mHash = hash;
+}
+
+size_t ExportManifest::size() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mMutex);
+    return mEntries.size();
+}
+
+std::string ExportManifest::getKey(const std::string &outputPath) const
+{
+    std::string key = StringUtils::lowerCase(ResourceHelpers::getNormalizedPath(outputPath));
+    std::string root = StringUtils::lowerCase(mRootDir);
+    if (!root.empty() && key.compare(0, root.size(), root) == 0)
+        key.erase(0, root.size());
+    return key;
+}
+
+}
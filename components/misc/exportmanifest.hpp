@@ -0,0 +1,76 @@
+#ifndef OPENMW_COMPONENTS_MISC_EXPORTMANIFEST_H
+#define OPENMW_COMPONENTS_MISC_EXPORTMANIFEST_H
+
+#include <ctime>
+#include <iosfwd>
+#include <map>
+#include <string>
+
+#include <stdint.h>
+
+#include <OpenThreads/Mutex>
+
+namespace Misc
+{
+
+/// The directory the exporter writes Oblivion.output/ and its logs to, without a trailing slash.
+/// Taken from MODEXPORTER_OUTPUTROOT, falling back to C: on Windows and $HOME elsewhere.
+std::string getExportOutputRoot();
+
+/*
+  Remembers which source content each exported asset was produced from, so that
+  a later export can skip assets whose source did not change.
+  The manifest is a text file in the export output root. All methods are thread safe.
+*/
+class ExportManifest
+{
+public:
+    typedef uint64_t Hash;
+
+    static const Hash sHashSeed = 14695981039346656037ULL;
+
+    /// 64-bit FNV-1a. Pass a previous result as \a seed to hash several pieces of data.
+    static Hash hash(const char* data, size_t size, Hash seed = sHashSeed);
+    static Hash hash(const std::string& str, Hash seed = sHashSeed);
+
+    ExportManifest();
+
+    /// Read the manifest from \a rootDir. Entries are stored relative to \a rootDir.
+    /// A missing manifest file is not an error, it just starts out empty.
+    void load(const std::string& rootDir);
+
+    /// Write the manifest back to the directory it was loaded from. No-op if load() was never called.
+    void save() const;
+
+    /// @return true if \a outputPath is recorded as produced from content with \a hash and still exists on disk.
+    /// An output queued with updatePending() must also have been written after it was queued.
+    bool isUpToDate(const std::string& outputPath, Hash hash) const;
+
+    /// Record that \a outputPath has been written from content with \a hash.
+    void update(const std::string& outputPath, Hash hash);
+
+    /// Record that \a outputPath will be written from content with \a hash by an external tool
+    /// (e.g. a Blender job list). It only counts as up to date once the tool has rewritten the file.
+    void updatePending(const std::string& outputPath, Hash hash);
+
+    size_t size() const;
+
+private:
+    std::string getKey(const std::string& outputPath) const;
+
+    struct Entry
+    {
+        Hash mHash;
+        /// When the output was queued for an external tool, 0 if it was written by the exporter itself
+        std::time_t mQueued;
+    };
+
+    std::string mRootDir;
+    std::map<std::string, Entry> mEntries;
+
+    mutable OpenThreads::Mutex mMutex;
+};
+
+}
+
+#endif
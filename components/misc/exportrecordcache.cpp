@@ -0,0 +1,267 @@
+#include "exportrecordcache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+#include <boost/filesystem.hpp>
+
+#include "stringops.hpp"
+
+namespace
+{
+    const char sMagic[4] = { 'M', 'X', 'R', 'C' };
+
+    // Increase when the file layout changes, to invalidate existing caches
+    const uint32_t sFormatVersion = 2;
+
+    template<typename T>
+    void writeValue(std::ostream& stream, const T& value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void writeString(std::ostream& stream, const std::string& str)
+    {
+        writeValue(stream, static_cast<uint32_t>(str.size()));
+        stream.write(str.data(), str.size());
+    }
+
+    template<typename T>
+    bool readValue(std::istream& stream, T& value)
+    {
+        stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return stream.good();
+    }
+
+    bool readString(std::istream& stream, std::string& str)
+    {
+        uint32_t size = 0;
+        if (!readValue(stream, size))
+            return false;
+        str.resize(size);
+        if (size > 0)
+            stream.read(&str[0], size);
+        return stream.good();
+    }
+}
+
+namespace Misc
+{
+
+ExportRecordCache::ExportRecordCache()
+    : mSettingsHash(0)
+{
+}
+
+void ExportRecordCache::load(const std::string &path)
+{
+    mPath = path;
+    mSettingsHash = 0;
+    mFormIDs.clear();
+    mUsedFormIDs.clear();
+    mRecords.clear();
+    mCurrentRecords.clear();
+
+    std::ifstream stream (path.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!stream.is_open())
+        return;
+
+    char magic[sizeof(sMagic)];
+    uint32_t version = 0;
+    stream.read(magic, sizeof(magic));
+    if (!stream.good() || !std::equal(magic, magic + sizeof(magic), sMagic) || !readValue(stream, version) || version != sFormatVersion)
+    {
+        std::cerr << "Export cache: ignoring " << path << ", it was written by a different version" << std::endl;
+        return;
+    }
+
+    bool good = readValue(stream, mSettingsHash);
+
+    uint32_t numFormIDs = 0;
+    good = good && readValue(stream, numFormIDs);
+    for (uint32_t i=0; good && i<numFormIDs; ++i)
+    {
+        std::string stringID;
+        uint32_t formID = 0;
+        good = readString(stream, stringID) && readValue(stream, formID);
+        if (good)
+            setFormID(stringID, formID);
+    }
+
+    uint32_t numRecords = 0;
+    good = good && readValue(stream, numRecords);
+    for (uint32_t i=0; good && i<numRecords; ++i)
+    {
+        std::string key;
+        Record record;
+        uint32_t numAssets = 0;
+        good = readString(stream, key) && readValue(stream, record.mHash) && readString(stream, record.mData)
+                && readValue(stream, numAssets);
+        for (uint32_t j=0; good && j<numAssets; ++j)
+        {
+            Asset asset;
+            uint32_t type = 0;
+            int32_t flags = 0;
+            good = readValue(stream, type) && readString(stream, asset.mSource) && readString(stream, asset.mOutput)
+                    && readValue(stream, flags);
+            asset.mType = static_cast<Asset::Type>(type);
+            asset.mFlags = flags;
+            record.mAssets.push_back(asset);
+        }
+        uint32_t numReferences = 0;
+        good = good && readValue(stream, numReferences);
+        for (uint32_t j=0; good && j<numReferences; ++j)
+        {
+            std::string stringID;
+            uint32_t formID = 0;
+            good = readString(stream, stringID) && readValue(stream, formID);
+            record.mReferences[stringID] = formID;
+        }
+        if (good)
+            mRecords[key] = record;
+    }
+
+    if (!good)
+    {
+        // the FormIDs that were read are still fine, but a truncated record list can not be trusted
+        std::cerr << "Export cache: " << path << " is truncated" << std::endl;
+        mRecords.clear();
+    }
+
+    std::cout << "Export cache: " << mFormIDs.size() << " FormIDs and " << mRecords.size() << " records loaded from " << path << std::endl;
+}
+
+void ExportRecordCache::save() const
+{
+    if (mPath.empty())
+        return;
+
+    boost::filesystem::path parent = boost::filesystem::path(mPath).parent_path();
+    if (!parent.empty() && !boost::filesystem::exists(parent))
+        boost::filesystem::create_directories(parent);
+
+    // write to a temporary file first, so that an interrupted export does not leave a truncated cache
+    std::string tmpPath = mPath + ".tmp";
+    {
+        std::ofstream stream (tmpPath.c_str(), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        stream.write(sMagic, sizeof(sMagic));
+        writeValue(stream, sFormatVersion);
+        writeValue(stream, mSettingsHash);
+
+        writeValue(stream, static_cast<uint32_t>(mFormIDs.size()));
+        for (std::map<std::string, uint32_t>::const_iterator it = mFormIDs.begin(); it != mFormIDs.end(); ++it)
+        {
+            writeString(stream, it->first);
+            writeValue(stream, it->second);
+        }
+
+        writeValue(stream, static_cast<uint32_t>(mCurrentRecords.size()));
+        for (std::set<std::string>::const_iterator it = mCurrentRecords.begin(); it != mCurrentRecords.end(); ++it)
+        {
+            const Record& record = mRecords.find(*it)->second;
+            writeString(stream, *it);
+            writeValue(stream, record.mHash);
+            writeString(stream, record.mData);
+            writeValue(stream, static_cast<uint32_t>(record.mAssets.size()));
+            for (std::vector<Asset>::const_iterator asset = record.mAssets.begin(); asset != record.mAssets.end(); ++asset)
+            {
+                writeValue(stream, static_cast<uint32_t>(asset->mType));
+                writeString(stream, asset->mSource);
+                writeString(stream, asset->mOutput);
+                writeValue(stream, static_cast<int32_t>(asset->mFlags));
+            }
+            writeValue(stream, static_cast<uint32_t>(record.mReferences.size()));
+            for (std::map<std::string, uint32_t>::const_iterator reference = record.mReferences.begin(); reference != record.mReferences.end(); ++reference)
+            {
+                writeString(stream, reference->first);
+                writeValue(stream, reference->second);
+            }
+        }
+
+        if (!stream.good())
+        {
+            std::cerr << "Export cache: failed to write " << tmpPath << std::endl;
+            return;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmpPath, mPath, ec);
+    if (ec)
+        std::cerr << "Export cache: failed to write " << mPath << ": " << ec.message() << std::endl;
+}
+
+uint32_t ExportRecordCache::getFormID(const std::string &stringID) const
+{
+    std::map<std::string, uint32_t>::const_iterator found = mFormIDs.find(StringUtils::lowerCase(stringID));
+    return found != mFormIDs.end() ? found->second : 0;
+}
+
+bool ExportRecordCache::isFormIDUsed(uint32_t formID) const
+{
+    return mUsedFormIDs.find(formID) != mUsedFormIDs.end();
+}
+
+void ExportRecordCache::setFormID(const std::string &stringID, uint32_t formID)
+{
+    mFormIDs[StringUtils::lowerCase(stringID)] = formID;
+    mUsedFormIDs.insert(formID);
+}
+
+void ExportRecordCache::validate(Hash settingsHash, const std::map<std::string, uint32_t>& formIDs)
+{
+    if (settingsHash != mSettingsHash && !mRecords.empty())
+    {
+        std::cout << "Export cache: export options or masters have changed since the last export, all records will be written again" << std::endl;
+        mRecords.clear();
+    }
+    mSettingsHash = settingsHash;
+
+    size_t numDropped = 0;
+    for (std::map<std::string, Record>::iterator it = mRecords.begin(); it != mRecords.end();)
+    {
+        bool valid = true;
+        const std::map<std::string, uint32_t>& references = it->second.mReferences;
+        for (std::map<std::string, uint32_t>::const_iterator reference = references.begin(); valid && reference != references.end(); ++reference)
+        {
+            std::map<std::string, uint32_t>::const_iterator found = formIDs.find(reference->first);
+            valid = (found != formIDs.end() ? found->second : 0) == reference->second;
+        }
+
+        if (valid)
+            ++it;
+        else
+        {
+            mRecords.erase(it++);
+            ++numDropped;
+        }
+    }
+
+    if (numDropped > 0)
+        std::cout << "Export cache: " << numDropped << " records refer to FormIDs that have changed and will be written again" << std::endl;
+}
+
+const ExportRecordCache::Record* ExportRecordCache::findRecord(const std::string &key, Hash hash)
+{
+    std::map<std::string, Record>::const_iterator found = mRecords.find(StringUtils::lowerCase(key));
+    if (found == mRecords.end() || found->second.mHash != hash)
+        return NULL;
+
+    mCurrentRecords.insert(found->first);
+    return &found->second;
+}
+
+void ExportRecordCache::storeRecord(const std::string &key, const Record &record)
+{
+    std::string lowerKey = StringUtils::lowerCase(key);
+    mRecords[lowerKey] = record;
+    mCurrentRecords.insert(lowerKey);
+}
+
+size_t ExportRecordCache::getNumRecords() const
+{
+    return mRecords.size();
+}
+
+}
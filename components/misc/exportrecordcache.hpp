@@ -0,0 +1,93 @@
+#ifndef OPENMW_COMPONENTS_MISC_EXPORTRECORDCACHE_H
+#define OPENMW_COMPONENTS_MISC_EXPORTRECORDCACHE_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <stdint.h>
+
+#include "exportmanifest.hpp"
+
+namespace Misc
+{
+
+/*
+  Keeps the results of a previous export of a plugin, so that re-exporting it can
+  reuse them: the FormID that was assigned to each stringID, and the serialized bytes
+  of records together with a hash of the source record they were made from.
+  Cached records are only valid as long as every stringID they refer to still resolves
+  to the same FormID, see validate(). Not thread safe, it is meant to be used by the export operation only.
+*/
+class ExportRecordCache
+{
+public:
+    typedef ExportManifest::Hash Hash;
+
+    /// An asset that was queued for export while a record was serialized.
+    struct Asset
+    {
+        enum Type
+        {
+            Type_Model,
+            Type_Texture
+        };
+
+        Type mType;
+        std::string mSource;
+        std::string mOutput;
+        int mFlags;
+    };
+
+    struct Record
+    {
+        Hash mHash;
+        std::string mData;
+        std::vector<Asset> mAssets;
+        /// Lower case stringIDs the record refers to, with the FormID each resolved to (0 if it did not)
+        std::map<std::string, uint32_t> mReferences;
+    };
+
+    ExportRecordCache();
+
+    /// Read the cache from \a path. A missing or outdated file is not an error, it just starts out empty.
+    void load(const std::string& path);
+
+    /// Write the FormIDs and all records that were used or stored since load(). No-op if load() was never called.
+    void save() const;
+
+    /// @return FormID without the mod index that was assigned to \a stringID before, or 0.
+    uint32_t getFormID(const std::string& stringID) const;
+
+    /// @return Is \a formID (without the mod index) assigned to any stringID?
+    bool isFormIDUsed(uint32_t formID) const;
+
+    void setFormID(const std::string& stringID, uint32_t formID);
+
+    /// Drop the cached records that refer to a stringID which resolves to a different FormID in \a formIDs,
+    /// the lower case FormID table of the current export. All records are dropped if \a settingsHash,
+    /// a hash of the export options and masters, is different from the one the records were cached with.
+    void validate(Hash settingsHash, const std::map<std::string, uint32_t>& formIDs);
+
+    /// @return Cached record for \a key if it was made from source data with \a hash, otherwise NULL.
+    const Record* findRecord(const std::string& key, Hash hash);
+
+    void storeRecord(const std::string& key, const Record& record);
+
+    size_t getNumRecords() const;
+
+private:
+    std::string mPath;
+    Hash mSettingsHash;
+    std::map<std::string, uint32_t> mFormIDs;
+    std::set<uint32_t> mUsedFormIDs;
+
+    std::map<std::string, Record> mRecords;
+    /// Records of the current export, only these are saved
+    std::set<std::string> mCurrentRecords;
+};
+
+}
+
+#endif
@@ -0,0 +1,166 @@
+#include "profiler.hpp"
+
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
+
+namespace
+{
+    struct Event
+    {
+        const char* mName;
+        unsigned int mThread;
+        osg::Timer_t mStart;
+        osg::Timer_t mEnd;
+    };
+
+    struct ProfilerData
+    {
+        ProfilerData()
+            : mWindow(10.0)
+        {
+        }
+
+        OpenThreads::Mutex mMutex;
+        double mWindow;
+        std::deque<Event> mEvents;
+        std::map<std::thread::id, unsigned int> mThreadIds;
+        std::map<unsigned int, std::string> mThreadNames;
+
+        /// @note mMutex must be locked
+        unsigned int getThreadId()
+        {
+            std::thread::id id = std::this_thread::get_id();
+            std::map<std::thread::id, unsigned int>::iterator found = mThreadIds.find(id);
+            if (found != mThreadIds.end())
+                return found->second;
+            unsigned int index = mThreadIds.size() + 1;
+            mThreadIds[id] = index;
+            return index;
+        }
+
+        /// @note mMutex must be locked
+        void prune(osg::Timer_t now)
+        {
+            osg::Timer* timer = osg::Timer::instance();
+            while (!mEvents.empty() && timer->delta_s(mEvents.front().mEnd, now) > mWindow)
+                mEvents.pop_front();
+        }
+    };
+
+    ProfilerData& getData()
+    {
+        static ProfilerData data;
+        return data;
+    }
+
+    void writeEscaped(std::ostream& stream, const std::string& str)
+    {
+        for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+        {
+            if (*it == '"' || *it == '\\')
+                stream << '\\';
+            if (static_cast<unsigned char>(*it) >= 0x20)
+                stream << *it;
+        }
+    }
+}
+
+namespace Misc
+{
+
+bool Profiler::sEnabled = false;
+
+void Profiler::setEnabled(bool enabled, double window)
+{
+    ProfilerData& data = getData();
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+    data.mWindow = window;
+    if (!enabled)
+        data.mEvents.clear();
+    sEnabled = enabled;
+}
+
+void Profiler::setThreadName(const std::string &name)
+{
+    ProfilerData& data = getData();
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+    data.mThreadNames[data.getThreadId()] = name;
+}
+
+void Profiler::record(const char *name, osg::Timer_t start, osg::Timer_t end)
+{
+    ProfilerData& data = getData();
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+
+    Event event;
+    event.mName = name;
+    event.mThread = data.getThreadId();
+    event.mStart = start;
+    event.mEnd = end;
+    data.mEvents.push_back(event);
+
+    data.prune(end);
+}
+
+bool Profiler::writeChromeTrace(const std::string &path)
+{
+    std::deque<Event> events;
+    std::map<unsigned int, std::string> threadNames;
+    {
+        ProfilerData& data = getData();
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(data.mMutex);
+        data.prune(osg::Timer::instance()->tick());
+        events = data.mEvents;
+        threadNames = data.mThreadNames;
+    }
+
+    std::ofstream stream (path.c_str(), std::ios_base::out | std::ios_base::trunc);
+    if (!stream.is_open())
+    {
+        std::cerr << "Profiler: failed to open " << path << std::endl;
+        return false;
+    }
+
+    osg::Timer* timer = osg::Timer::instance();
+    osg::Timer_t base = timer->getStartTick();
+
+    stream << "{\"traceEvents\":[\n";
+    bool first = true;
+    for (std::map<unsigned int, std::string>::const_iterator it = threadNames.begin(); it != threadNames.end(); ++it)
+    {
+        stream << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << it->first
+               << ",\"args\":{\"name\":\"";
+        writeEscaped(stream, it->second);
+        stream << "\"}}";
+        first = false;
+    }
+
+    stream.precision(3);
+    stream << std::fixed;
+    for (std::deque<Event>::const_iterator it = events.begin(); it != events.end(); ++it)
+    {
+        stream << (first ? "" : ",\n") << "{\"name\":\"";
+        writeEscaped(stream, it->mName);
+        stream << "\",\"cat\":\"openmw\",\"ph\":\"X\",\"pid\":1,\"tid\":" << it->mThread
+               << ",\"ts\":" << timer->delta_u(base, it->mStart) << ",\"dur\":" << timer->delta_u(it->mStart, it->mEnd) << "}";
+        first = false;
+    }
+    stream << "\n]}\n";
+
+    if (!stream.good())
+    {
+        std::cerr << "Profiler: failed to write " << path << std::endl;
+        return false;
+    }
+
+    std::cout << "Profiler: wrote " << events.size() << " zones to " << path << std::endl;
+    return true;
+}
+
+}
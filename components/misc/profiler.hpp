@@ -0,0 +1,66 @@
+#ifndef OPENMW_COMPONENTS_MISC_PROFILER_H
+#define OPENMW_COMPONENTS_MISC_PROFILER_H
+
+#include <string>
+
+#include <osg/Timer>
+
+namespace Misc
+{
+
+/*
+  Collects the timings of ProfileZones from all threads, keeping the ones that ended within
+  the last few seconds. They can be written out in the Chrome trace event format, to be viewed
+  in chrome://tracing or similar tools. Zones that are open at the same time on a thread show up nested.
+  Does nothing until enabled, ProfileZones then only cost a branch. All methods are thread safe.
+*/
+class Profiler
+{
+public:
+    /// @param window How many seconds of zones to keep.
+    static void setEnabled(bool enabled, double window = 10.0);
+
+    static bool isEnabled() { return sEnabled; }
+
+    /// Name the calling thread in the trace.
+    static void setThreadName(const std::string& name);
+
+    /// @param name Must stay valid for the lifetime of the program, i.e. a string literal.
+    static void record(const char* name, osg::Timer_t start, osg::Timer_t end);
+
+    /// Write the zones that ended within the window to \a path.
+    /// @return false if the file could not be written.
+    static bool writeChromeTrace(const std::string& path);
+
+private:
+    static bool sEnabled;
+};
+
+/// Records the time from its construction to its destruction in the Profiler.
+class ProfileZone
+{
+public:
+    /// @param name Must stay valid for the lifetime of the program, i.e. a string literal.
+    explicit ProfileZone(const char* name)
+        : mName(name)
+        , mStart(Profiler::isEnabled() ? osg::Timer::instance()->tick() : 0)
+    {
+    }
+
+    ~ProfileZone()
+    {
+        if (mStart)
+            Profiler::record(mName, mStart, osg::Timer::instance()->tick());
+    }
+
+private:
+    ProfileZone(const ProfileZone&);
+    ProfileZone& operator=(const ProfileZone&);
+
+    const char* mName;
+    osg::Timer_t mStart;
+};
+
+}
+
+#endif
@@ -16,6 +16,9 @@ public:
     /// seed the RNG
     static void init();
 
+    /// seed the RNG with a fixed value, to make runs repeatable
+    static void init(unsigned int seed);
+
     /// return value in range [0.0f, 1.0f)  <- note open upper range.
     static float rollProbability();
   
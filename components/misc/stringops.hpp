@@ -115,6 +115,31 @@ public:
         }
     };
 
+    /// Case-insensitive hash, for use with CiEqual as unordered container key functions.
+    /// Hashes the lower case form of the string without making a lower case copy of it.
+    struct CiHash
+    {
+        size_t operator()(const std::string& str) const
+        {
+            // FNV-1a
+            size_t hash = static_cast<size_t>(14695981039346656037ULL);
+            for (size_t i = 0; i < str.size(); ++i)
+            {
+                hash ^= static_cast<unsigned char>(toLower(str[i]));
+                hash *= static_cast<size_t>(1099511628211ULL);
+            }
+            return hash;
+        }
+    };
+
+    struct CiEqual
+    {
+        bool operator()(const std::string& left, const std::string& right) const
+        {
+            return ciEqual(left, right);
+        }
+    };
+
 
     /// Performs a binary search on a sorted container for a string that 'key' starts with
     template<typename Iterator, typename T>
@@ -2,6 +2,7 @@
 #include "effect.hpp"
 
 #include <map>
+#include <unordered_map>
 #include <sstream>
 #include <iostream>
 #include <fstream>
@@ -11,6 +12,7 @@
 #include <components/esm/esmwriter.hpp>
 #include <components/vfs/manager.hpp>
 #include <components/misc/resourcehelpers.hpp>
+#include <components/misc/exportmanifest.hpp>
 
 # define PI           3.14159265358979323846  /* pi */
 
@@ -52,10 +54,12 @@ static std::pair<std::string,RecordFactoryEntry> makeEntry(std::string recName,
     return std::make_pair(recName, anEntry);
 }
 
+typedef std::unordered_map<std::string,RecordFactoryEntry> RecordFactory;
+
 ///These are all the record types we know how to read.
-static std::map<std::string,RecordFactoryEntry> makeFactory()
+static RecordFactory makeFactory()
 {
-    std::map<std::string,RecordFactoryEntry> newFactory;
+    RecordFactory newFactory;
     newFactory.insert(makeEntry("NiNode",                     &construct <NiNode>                      , RC_NiNode                        ));
     newFactory.insert(makeEntry("NiSwitchNode",               &construct <NiSwitchNode>                , RC_NiSwitchNode                  ));
     newFactory.insert(makeEntry("NiLODNode",                  &construct <NiLODNode>                   , RC_NiLODNode                     ));
@@ -122,8 +126,8 @@ static std::map<std::string,RecordFactoryEntry> makeFactory()
 }
 
 
-///Make the factory map used for parsing the file
-static const std::map<std::string,RecordFactoryEntry> factories = makeFactory();
+///Make the factory map used for parsing the file. Hashed, since it is consulted once per record.
+static const RecordFactory factories = makeFactory();
 
 std::string NIFFile::printVersion(unsigned int version)
 {
@@ -188,7 +192,7 @@ void NIFFile::parse(Files::IStreamPtr stream)
             fail(error.str());
         }
 
-        std::map<std::string,RecordFactoryEntry>::const_iterator entry = factories.find(rec);
+        RecordFactory::const_iterator entry = factories.find(rec);
 
         if (entry != factories.end())
         {
@@ -997,15 +1001,7 @@ void NIFFile::exportDDS(const std::string &oldName, const std::string &exportNam
     std::string logRoot = outputRoot;
 #endif
 */
-	std::string outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
-	if (outputRoot.length() == 0)
-	{
-#ifdef _WIN32
-		std::string outputRoot = "C:";
-#else
-		std::string outputRoot = getenv("HOME");
-#endif
-	}
+	std::string outputRoot = Misc::getExportOutputRoot();
 	outputRoot += "/";
 	std::string logRoot = outputRoot + "Oblivion.output/";
 
@@ -1257,15 +1253,7 @@ std::string NIFFile::CreateResourcePaths(std::string modelPath)
 	std::string logRoot = outputRoot;
 #endif
 */
-	std::string outputRoot = getenv("MODEXPORTER_OUTPUTROOT");
-	if (outputRoot.length() == 0)
-	{
-#ifdef _WIN32
-		std::string outputRoot = "C:";
-#else
-		std::string outputRoot = getenv("HOME");
-#endif
-	}
+	std::string outputRoot = Misc::getExportOutputRoot();
 	outputRoot += "/";
 	std::string logRoot = outputRoot + "Oblivion.output/";
 
@@ -1,4 +1,7 @@
 #include "nifstream.hpp"
+
+#include <osg/Endian>
+
 //For error reporting
 #include "niffile.hpp"
 
@@ -32,6 +35,25 @@ float NIFStream::read_le32f()
     } u = { read_le32() };
     return u.f;
 }
+void NIFStream::read_le_array(void* dest, size_t count, size_t elementSize)
+{
+    if (count == 0)
+        return;
+
+    char* data = static_cast<char*>(dest);
+    inp->read(data, count * elementSize);
+
+    if (osg::getCpuByteOrder() == osg::BigEndian)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (elementSize == 2)
+                osg::swapBytes2(data + i * elementSize);
+            else if (elementSize == 4)
+                osg::swapBytes4(data + i * elementSize);
+        }
+    }
+}
 
 //Public functions
 osg::Vec2f NIFStream::getVector2()
@@ -85,11 +107,15 @@ Transformation NIFStream::getTrafo()
 
 std::string NIFStream::getString(size_t length)
 {
-    std::vector<char> str (length+1, 0);
-
-    inp->read(&str[0], length);
+    std::string str (length, '\0');
+    if (length > 0)
+        inp->read(&str[0], length);
 
-    return &str[0];
+    // strings are terminated by the first null character, if there is one
+    size_t end = str.find('\0');
+    if (end != std::string::npos)
+        str.resize(end);
+    return str;
 }
 std::string NIFStream::getString()
 {
@@ -103,35 +129,35 @@ std::string NIFStream::getVersionString()
     return result;
 }
 
+// The vectors are filled with a single read instead of one read per element.
+// osg::Vec*f are plain arrays of floats, so their storage matches the file layout.
 void NIFStream::getUShorts(std::vector<unsigned short> &vec, size_t size)
 {
     vec.resize(size);
-    for(size_t i = 0;i < vec.size();i++)
-        vec[i] = getUShort();
+    read_le_array(vec.data(), size, sizeof(unsigned short));
 }
 void NIFStream::getFloats(std::vector<float> &vec, size_t size)
 {
     vec.resize(size);
-    for(size_t i = 0;i < vec.size();i++)
-        vec[i] = getFloat();
+    read_le_array(vec.data(), size, sizeof(float));
 }
 void NIFStream::getVector2s(std::vector<osg::Vec2f> &vec, size_t size)
 {
+    static_assert(sizeof(osg::Vec2f) == 2*sizeof(float), "osg::Vec2f must not be padded");
     vec.resize(size);
-    for(size_t i = 0;i < vec.size();i++)
-        vec[i] = getVector2();
+    read_le_array(vec.data(), size*2, sizeof(float));
 }
 void NIFStream::getVector3s(std::vector<osg::Vec3f> &vec, size_t size)
 {
+    static_assert(sizeof(osg::Vec3f) == 3*sizeof(float), "osg::Vec3f must not be padded");
     vec.resize(size);
-    for(size_t i = 0;i < vec.size();i++)
-        vec[i] = getVector3();
+    read_le_array(vec.data(), size*3, sizeof(float));
 }
 void NIFStream::getVector4s(std::vector<osg::Vec4f> &vec, size_t size)
 {
+    static_assert(sizeof(osg::Vec4f) == 4*sizeof(float), "osg::Vec4f must not be padded");
     vec.resize(size);
-    for(size_t i = 0;i < vec.size();i++)
-        vec[i] = getVector4();
+    read_le_array(vec.data(), size*4, sizeof(float));
 }
 void NIFStream::getQuaternions(std::vector<osg::Quat> &quat, size_t size)
 {
@@ -31,6 +31,10 @@ class NIFStream {
     uint32_t read_le32();
     float read_le32f();
 
+    /// Read \a count little-endian elements of \a elementSize bytes straight into \a dest,
+    /// swapping them in place on big-endian hosts.
+    void read_le_array(void* dest, size_t count, size_t elementSize);
+
 public:
 
     NIFFile * const file;
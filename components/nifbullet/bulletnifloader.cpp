@@ -42,6 +42,7 @@ namespace NifBullet
 BulletNifLoader::BulletNifLoader()
     : mCompoundShape(NULL)
     , mStaticMesh(NULL)
+    , mBuildStaticBvh(true)
 {
 }
 
@@ -49,9 +50,10 @@ BulletNifLoader::~BulletNifLoader()
 {
 }
 
-osg::ref_ptr<Resource::BulletShape> BulletNifLoader::load(const Nif::NIFFilePtr nif)
+osg::ref_ptr<Resource::BulletShape> BulletNifLoader::load(const Nif::NIFFilePtr nif, bool buildStaticBvh)
 {
     mShape = new Resource::BulletShape;
+    mBuildStaticBvh = buildStaticBvh;
 
     mCompoundShape = NULL;
     mStaticMesh = NULL;
@@ -110,11 +112,11 @@ osg::ref_ptr<Resource::BulletShape> BulletNifLoader::load(const Nif::NIFFilePtr
             {
                 btTransform trans;
                 trans.setIdentity();
-                mCompoundShape->addChildShape(trans, new Resource::TriangleMeshShape(mStaticMesh,true));
+                mCompoundShape->addChildShape(trans, new Resource::TriangleMeshShape(mStaticMesh,true,mBuildStaticBvh));
             }
         }
         else if (mStaticMesh)
-            mShape->mCollisionShape = new Resource::TriangleMeshShape(mStaticMesh,true);
+            mShape->mCollisionShape = new Resource::TriangleMeshShape(mStaticMesh,true,mBuildStaticBvh);
 
         return mShape;
     }
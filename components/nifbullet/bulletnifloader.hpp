@@ -50,7 +50,9 @@ public:
         abort();
     }
 
-    osg::ref_ptr<Resource::BulletShape> load(const Nif::NIFFilePtr file);
+    /// @param buildStaticBvh If false, the BVH of the static mesh shape is left for the caller to build or load,
+    ///  see Resource::TriangleMeshShape::setDeserializedBvh.
+    osg::ref_ptr<Resource::BulletShape> load(const Nif::NIFFilePtr file, bool buildStaticBvh = true);
 
 private:
     bool findBoundingBox(const Nif::Node* node, int flags = 0);
@@ -66,6 +68,8 @@ private:
     btTriangleMesh* mStaticMesh;
 
     osg::ref_ptr<Resource::BulletShape> mShape;
+
+    bool mBuildStaticBvh;
 };
 
 }
@@ -8,6 +8,8 @@
 #include <osg/Vec3f>
 
 #include <BulletCollision/CollisionShapes/btBvhTriangleMeshShape.h>
+#include <BulletCollision/CollisionShapes/btOptimizedBvh.h>
+#include <LinearMath/btAlignedAllocator.h>
 
 class btCollisionShape;
 
@@ -66,6 +68,7 @@ namespace Resource
     {
         TriangleMeshShape(btStridingMeshInterface* meshInterface, bool useQuantizedAabbCompression, bool buildBvh = true)
             : btBvhTriangleMeshShape(meshInterface, useQuantizedAabbCompression, buildBvh)
+            , mBvhBuffer(NULL)
         {
         }
 
@@ -73,7 +76,25 @@ namespace Resource
         {
             delete getTriangleInfoMap();
             delete m_meshInterface;
+
+            if (mBvhBuffer)
+            {
+                m_bvh->~btOptimizedBvh();
+                btAlignedFree(mBvhBuffer);
+            }
+        }
+
+        /// Use a BVH that was deserialized in place with btOptimizedBvh::deSerializeInPlace.
+        /// @param buffer The buffer holding \a bvh, allocated with btAlignedAlloc. Takes ownership.
+        /// @note The shape must have been created without building a BVH.
+        void setDeserializedBvh(btOptimizedBvh* bvh, void* buffer)
+        {
+            setOptimizedBvh(bvh);
+            mBvhBuffer = buffer;
         }
+
+    private:
+        void* mBvhBuffer;
     };
 
 
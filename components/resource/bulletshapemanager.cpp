@@ -1,5 +1,7 @@
 #include "bulletshapemanager.hpp"
 
+#include <vector>
+
 #include <osg/NodeVisitor>
 #include <osg/TriangleFunctor>
 #include <osg/Transform>
@@ -7,6 +9,7 @@
 #include <osg/Version>
 
 #include <BulletCollision/CollisionShapes/btTriangleMesh.h>
+#include <BulletCollision/CollisionShapes/btCompoundShape.h>
 
 #include <components/vfs/manager.hpp>
 
@@ -17,6 +20,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "bvhcache.hpp"
 
 namespace Resource
 {
@@ -86,7 +90,8 @@ public:
             return osg::ref_ptr<BulletShape>();
 
         osg::ref_ptr<BulletShape> shape (new BulletShape);
-        TriangleMeshShape* meshShape = new TriangleMeshShape(mTriangleMesh, true);
+        // the BVH is built by BulletShapeManager::finishShape
+        TriangleMeshShape* meshShape = new TriangleMeshShape(mTriangleMesh, true, false);
         shape->mCollisionShape = meshShape;
         mTriangleMesh = NULL;
         return shape;
@@ -110,6 +115,43 @@ BulletShapeManager::~BulletShapeManager()
 
 }
 
+void BulletShapeManager::setDiskCacheDirectory(const std::string &path)
+{
+    if (path.empty())
+        mDiskCache.reset();
+    else
+        mDiskCache.reset(new BvhCache(mVFS, path));
+}
+
+void BulletShapeManager::finishShape(const std::string &normalized, BulletShape *shape)
+{
+    btCollisionShape* collisionShape = shape->mCollisionShape;
+    if (!collisionShape)
+        return;
+
+    std::vector<std::pair<btCollisionShape*, int> > shapes;
+    if (collisionShape->isCompound())
+    {
+        btCompoundShape* compound = static_cast<btCompoundShape*>(collisionShape);
+        for (int i=0; i<compound->getNumChildShapes(); ++i)
+            shapes.push_back(std::make_pair(compound->getChildShape(i), i));
+    }
+    else
+        shapes.push_back(std::make_pair(collisionShape, -1));
+
+    for (std::vector<std::pair<btCollisionShape*, int> >::iterator it = shapes.begin(); it != shapes.end(); ++it)
+    {
+        TriangleMeshShape* meshShape = dynamic_cast<TriangleMeshShape*>(it->first);
+        if (!meshShape || meshShape->getOptimizedBvh())
+            continue;
+
+        if (mDiskCache)
+            mDiskCache->loadOrBuild(normalized, it->second, meshShape);
+        else
+            meshShape->buildOptimizedBvh();
+    }
+}
+
 osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &name)
 {
     std::string normalized = name;
@@ -129,7 +171,7 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
         if (ext == "nif")
         {
             NifBullet::BulletNifLoader loader;
-            shape = loader.load(mNifFileManager->get(normalized));
+            shape = loader.load(mNifFileManager->get(normalized), false);
         }
         else
         {
@@ -147,6 +189,8 @@ osg::ref_ptr<const BulletShape> BulletShapeManager::getShape(const std::string &
             }
         }
 
+        finishShape(normalized, shape);
+
         mCache->addEntryToObjectCache(normalized, shape);
     }
     return shape;
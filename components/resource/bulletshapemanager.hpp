@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_BULLETSHAPEMANAGER_H
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include <osg/ref_ptr>
@@ -18,6 +19,7 @@ namespace Resource
     class BulletShapeInstance;
 
     class MultiObjectCache;
+    class BvhCache;
 
     /// Handles loading, caching and "instancing" of bullet shapes.
     /// A shape 'instance' is a clone of another shape, with the goal of setting a different scale on this instance.
@@ -39,6 +41,10 @@ namespace Resource
         /// @note May return a null pointer if the object has no shape.
         osg::ref_ptr<BulletShapeInstance> getInstance(const std::string& name);
 
+        /// Keep the BVHs of collision meshes in the given directory, so that they load faster on the next launch. Pass an empty string to disable.
+        /// @see BvhCache
+        void setDiskCacheDirectory(const std::string& path);
+
         /// @see ResourceManager::updateCache
         virtual void updateCache(double referenceTime);
 
@@ -47,7 +53,11 @@ namespace Resource
     private:
         osg::ref_ptr<BulletShapeInstance> createInstance(const std::string& name);
 
+        /// Build or load the BVHs that were left out when creating \a shape.
+        void finishShape(const std::string& normalized, BulletShape* shape);
+
         osg::ref_ptr<MultiObjectCache> mInstanceCache;
+        std::unique_ptr<BvhCache> mDiskCache;
         SceneManager* mSceneManager;
         NifFileManager* mNifFileManager;
     };
@@ -0,0 +1,143 @@
+#include "bvhcache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <functional>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <LinearMath/btScalar.h>
+
+#include <components/vfs/manager.hpp>
+
+#include "bulletshape.hpp"
+
+namespace
+{
+
+    // Increase when the way collision meshes are built changes, to invalidate existing entries
+    const int sFormatVersion = 1;
+
+}
+
+namespace Resource
+{
+
+    BvhCache::BvhCache(const VFS::Manager *vfs, const std::string &cacheDir)
+        : mVFS(vfs)
+        , mCacheDir(cacheDir)
+    {
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(mCacheDir, ec);
+        if (ec)
+            std::cerr << "Failed to create collision cache directory '" << mCacheDir << "': " << ec.message() << std::endl;
+    }
+
+    void BvhCache::loadOrBuild(const std::string &normalizedFilename, int index, TriangleMeshShape *shape) const
+    {
+        size_t size = 0;
+        std::time_t modified = 0;
+        if (!mVFS->getStatus(normalizedFilename, size, modified))
+        {
+            shape->buildOptimizedBvh();
+            return;
+        }
+
+        // The serialized BVH is only valid for the exact triangle layout and build of Bullet that it was made with
+        const unsigned char* vertexBase = NULL;
+        int numVertices = 0;
+        PHY_ScalarType vertexType;
+        int vertexStride = 0;
+        const unsigned char* indexBase = NULL;
+        int indexStride = 0;
+        int numFaces = 0;
+        PHY_ScalarType indexType;
+        shape->getMeshInterface()->getLockedReadOnlyVertexIndexBase(&vertexBase, numVertices, vertexType, vertexStride, &indexBase, indexStride, numFaces, indexType);
+        shape->getMeshInterface()->unLockReadOnlyVertexBase(0);
+
+        std::ostringstream header;
+        header << "OpenMW collision cache " << sFormatVersion << " " << BT_BULLET_VERSION << " " << sizeof(btScalar) << " "
+               << size << " " << modified << " " << index << " " << numVertices << " " << numFaces << " " << normalizedFilename;
+
+        // collisions are harmless, the header contains the full file name and index
+        std::ostringstream name;
+        name << std::hex << std::hash<std::string>()(normalizedFilename) << "_" << std::dec << index << ".bvh";
+        std::string path = (boost::filesystem::path(mCacheDir) / name.str()).string();
+
+        if (load(path, header.str(), shape))
+            return;
+
+        shape->buildOptimizedBvh();
+        save(path, header.str(), shape);
+    }
+
+    bool BvhCache::load(const std::string &path, const std::string &header, TriangleMeshShape *shape) const
+    {
+        boost::filesystem::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+        if (!file.is_open())
+            return false;
+
+        std::string fileHeader;
+        if (!std::getline(file, fileHeader) || fileHeader != header)
+            return false;
+
+        std::streamoff start = file.tellg();
+        file.seekg(0, std::ios_base::end);
+        std::streamoff bufferSize = file.tellg() - start;
+        file.seekg(start);
+        if (bufferSize <= 0)
+            return false;
+
+        // deSerializeInPlace constructs the BVH inside the buffer, which must be 16 byte aligned
+        void* buffer = btAlignedAlloc(static_cast<size_t>(bufferSize), 16);
+        file.read(static_cast<char*>(buffer), bufferSize);
+        btOptimizedBvh* bvh = NULL;
+        if (file.gcount() == bufferSize)
+            bvh = btOptimizedBvh::deSerializeInPlace(buffer, static_cast<unsigned int>(bufferSize), false);
+        if (!bvh)
+        {
+            btAlignedFree(buffer);
+            return false;
+        }
+
+        shape->setDeserializedBvh(bvh, buffer);
+        return true;
+    }
+
+    void BvhCache::save(const std::string &path, const std::string &header, TriangleMeshShape *shape) const
+    {
+        btOptimizedBvh* bvh = shape->getOptimizedBvh();
+        if (!bvh || !bvh->isQuantized())
+            return;
+
+        unsigned int bufferSize = bvh->calculateSerializeBufferSize();
+        void* buffer = btAlignedAlloc(bufferSize, 16);
+        if (!bvh->serializeInPlace(buffer, bufferSize, false))
+        {
+            btAlignedFree(buffer);
+            return;
+        }
+
+        // several threads may be loading the same file, so write to a unique file and move it into place
+        boost::filesystem::path tmpPath = boost::filesystem::path(path).parent_path() / boost::filesystem::unique_path("%%%%%%%%%%%%.tmp");
+        bool good = false;
+        {
+            boost::filesystem::ofstream file(tmpPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            file << header << '\n';
+            file.write(static_cast<const char*>(buffer), bufferSize);
+            good = file.good();
+        }
+        btAlignedFree(buffer);
+
+        boost::system::error_code ec;
+        if (good)
+            boost::filesystem::rename(tmpPath, path, ec);
+        if (!good || ec)
+        {
+            std::cerr << "Failed to write collision cache '" << path << "'" << std::endl;
+            boost::filesystem::remove(tmpPath, ec);
+        }
+    }
+
+}
@@ -0,0 +1,41 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_BVHCACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_BVHCACHE_H
+
+#include <string>
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace Resource
+{
+
+    struct TriangleMeshShape;
+
+    /// @brief Keeps the bounding volume hierarchies of triangle mesh collision shapes in a directory on disk.
+    /// @par Building the BVH is the most expensive part of creating the collision shape for large meshes.
+    ///  An entry is only used if the size and modification time of its source file are still the same as when it was written.
+    /// @note Thread safe.
+    class BvhCache
+    {
+    public:
+        BvhCache(const VFS::Manager* vfs, const std::string& cacheDir);
+
+        /// Give \a shape a BVH, loaded from the cache if possible, otherwise built and then stored in the cache.
+        /// @param index Identifies the shape among the shapes created from the same file.
+        /// @note \a shape must have been created without building a BVH.
+        void loadOrBuild(const std::string& normalizedFilename, int index, TriangleMeshShape* shape) const;
+
+    private:
+        bool load(const std::string& path, const std::string& header, TriangleMeshShape* shape) const;
+
+        void save(const std::string& path, const std::string& header, TriangleMeshShape* shape) const;
+
+        const VFS::Manager* mVFS;
+        std::string mCacheDir;
+    };
+
+}
+
+#endif
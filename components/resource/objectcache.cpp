@@ -49,6 +49,17 @@ osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCache(const std::string&
     else return 0;
 }
 
+osg::ref_ptr<osg::Object> ObjectCache::getRefFromObjectCacheWithPrefix(const std::string &prefix)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
+    ObjectCacheMap::iterator itr = _objectCache.lower_bound(prefix);
+    if (itr!=_objectCache.end() && itr->first.compare(0, prefix.size(), prefix) == 0)
+    {
+        return itr->second.first;
+    }
+    else return 0;
+}
+
 bool ObjectCache::checkInObjectCache(const std::string &fileName, double timeStamp)
 {
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(_objectCacheMutex);
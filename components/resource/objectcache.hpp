@@ -64,6 +64,9 @@ class ObjectCache : public osg::Referenced
         /** Get an ref_ptr<Object> from the object cache*/
         osg::ref_ptr<osg::Object> getRefFromObjectCache(const std::string& fileName);
 
+        /** Get an ref_ptr<Object> from the object cache whose name starts with \a prefix, or NULL if there is none.*/
+        osg::ref_ptr<osg::Object> getRefFromObjectCacheWithPrefix(const std::string& prefix);
+
         /** Check if an object is in the cache, and if it is, update its usage time stamp. */
         bool checkInObjectCache(const std::string& fileName, double timeStamp);
 
@@ -52,6 +52,17 @@ namespace Resource
         return mKeyframeManager.get();
     }
 
+    void ResourceSystem::setDiskCacheDirectory(const std::string &path)
+    {
+        mDiskCacheDirectory = path;
+        mSceneManager->setDiskCacheDirectory(path.empty() ? path : path + "/models");
+    }
+
+    const std::string& ResourceSystem::getDiskCacheDirectory() const
+    {
+        return mDiskCacheDirectory;
+    }
+
     void ResourceSystem::setExpiryDelay(double expiryDelay)
     {
         for (std::vector<ResourceManager*>::iterator it = mResourceManagers.begin(); it != mResourceManagers.end(); ++it)
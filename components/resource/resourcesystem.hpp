@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_RESOURCE_RESOURCESYSTEM_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace VFS
@@ -51,6 +52,13 @@ namespace Resource
         /// How long to keep objects in cache after no longer being referenced.
         void setExpiryDelay(double expiryDelay);
 
+        /// Keep converted resources in subdirectories of \a path, so that they load faster on the next launch.
+        /// Resource managers created outside of the ResourceSystem should check getDiskCacheDirectory() when they are set up.
+        void setDiskCacheDirectory(const std::string& path);
+
+        /// @return The disk cache directory, or an empty string if disk caching is disabled.
+        const std::string& getDiskCacheDirectory() const;
+
         /// @note May be called from any thread.
         const VFS::Manager* getVFS() const;
 
@@ -68,6 +76,8 @@ namespace Resource
 
         const VFS::Manager* mVFS;
 
+        std::string mDiskCacheDirectory;
+
         ResourceSystem(const ResourceSystem&);
         void operator = (const ResourceSystem&);
     };
@@ -0,0 +1,272 @@
+#include "scenecache.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <functional>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include <osg/Node>
+#include <osg/Drawable>
+#include <osg/StateSet>
+#include <osg/Texture>
+#include <osg/Program>
+#include <osg/UserDataContainer>
+
+#include <osgDB/Registry>
+#include <osgDB/ReadFile>
+
+#include <components/vfs/manager.hpp>
+#include <components/sceneutil/serialize.hpp>
+
+namespace
+{
+
+    // Increase when the layout of converted scenes changes, to invalidate existing entries
+    const int sFormatVersion = 1;
+
+    /// @brief Checks whether a scene can be written out and read back without losing anything.
+    class SerializableVisitor : public osg::NodeVisitor
+    {
+    public:
+        SerializableVisitor()
+            : osg::NodeVisitor(TRAVERSE_ALL_CHILDREN)
+            , mSerializable(true)
+        {
+        }
+
+        virtual void apply(osg::Node& node)
+        {
+            if (!mSerializable)
+                return;
+
+            mSerializable = check(node);
+            if (mSerializable)
+                traverse(node);
+        }
+
+        bool check(osg::Node& node)
+        {
+            if (!SceneUtil::hasLosslessSerializer(node))
+                return false;
+
+            // Callbacks hold the runtime behaviour of controllers, particles etc., which we can not restore
+            if (node.getUpdateCallback() || node.getCullCallback() || node.getEventCallback() || node.getComputeBoundingSphereCallback())
+                return false;
+
+            if (!check(node.getUserDataContainer()))
+                return false;
+
+            if (node.getStateSet() && !check(*node.getStateSet()))
+                return false;
+
+            osg::Drawable* drawable = node.asDrawable();
+            if (drawable && (drawable->getDrawCallback() || drawable->getComputeBoundingBoxCallback()))
+                return false;
+
+            return true;
+        }
+
+        bool check(osg::UserDataContainer* container)
+        {
+            if (!container)
+                return true;
+            if (!SceneUtil::hasLosslessSerializer(*container))
+                return false;
+            if (container->getUserData())
+            {
+                const osg::Object* userData = dynamic_cast<const osg::Object*>(container->getUserData());
+                if (!userData || !SceneUtil::hasLosslessSerializer(*userData))
+                    return false;
+            }
+            for (unsigned int i=0; i<container->getNumUserObjects(); ++i)
+            {
+                if (!SceneUtil::hasLosslessSerializer(*container->getUserObject(i)))
+                    return false;
+            }
+            return true;
+        }
+
+        bool check(osg::StateSet& stateset)
+        {
+            if (stateset.getUpdateCallback() || stateset.getEventCallback())
+                return false;
+
+            if (!check(stateset.getAttributeList()))
+                return false;
+
+            const osg::StateSet::TextureAttributeList& texAttributes = stateset.getTextureAttributeList();
+            for (unsigned int i=0; i<texAttributes.size(); ++i)
+            {
+                if (!check(texAttributes[i]))
+                    return false;
+            }
+
+            const osg::StateSet::UniformList& uniforms = stateset.getUniformList();
+            for (osg::StateSet::UniformList::const_iterator it = uniforms.begin(); it != uniforms.end(); ++it)
+            {
+                if (!SceneUtil::hasLosslessSerializer(*it->second.first) || it->second.first->getUpdateCallback())
+                    return false;
+            }
+            return true;
+        }
+
+        bool check(const osg::StateSet::AttributeList& attributes)
+        {
+            for (osg::StateSet::AttributeList::const_iterator it = attributes.begin(); it != attributes.end(); ++it)
+            {
+                const osg::StateAttribute* attr = it->second.first.get();
+                // Programs are owned by the ShaderManager, copies of them would not be shared
+                if (dynamic_cast<const osg::Program*>(attr))
+                    return false;
+                if (!SceneUtil::hasLosslessSerializer(*attr) || attr->getUpdateCallback() || attr->getEventCallback())
+                    return false;
+
+                // Images are written by file name and read back through the ImageManager, so they need to have one.
+                // Images embedded in the NIF file don't.
+                const osg::Texture* texture = attr->asTexture();
+                if (texture)
+                {
+                    for (unsigned int i=0; i<texture->getNumImages(); ++i)
+                    {
+                        const osg::Image* image = texture->getImage(i);
+                        if (image && image->getFileName().empty())
+                            return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool mSerializable;
+    };
+
+}
+
+namespace Resource
+{
+
+    SceneCache::SceneCache(const VFS::Manager *vfs, const std::string &cacheDir, osgDB::ReadFileCallback *readFileCallback)
+        : mVFS(vfs)
+        , mCacheDir(cacheDir)
+        , mReadFileCallback(readFileCallback)
+    {
+        SceneUtil::registerLosslessSerializers();
+
+        boost::system::error_code ec;
+        boost::filesystem::create_directories(mCacheDir, ec);
+        if (ec)
+            std::cerr << "Failed to create scene cache directory '" << mCacheDir << "': " << ec.message() << std::endl;
+    }
+
+    SceneCache::~SceneCache()
+    {
+    }
+
+    bool SceneCache::makeHeader(const std::string &normalizedFilename, const std::string &signature, std::string &header) const
+    {
+        size_t size = 0;
+        std::time_t modified = 0;
+        if (!mVFS->getStatus(normalizedFilename, size, modified))
+            return false;
+
+        std::ostringstream stream;
+        stream << "OpenMW scene cache " << sFormatVersion << " " << size << " " << modified << " " << signature << " " << normalizedFilename;
+        header = stream.str();
+        return true;
+    }
+
+    std::string SceneCache::getCachePath(const std::string &normalizedFilename) const
+    {
+        // collisions are harmless, the header contains the full file name
+        std::ostringstream stream;
+        stream << std::hex << std::hash<std::string>()(normalizedFilename) << ".osgb";
+        return (boost::filesystem::path(mCacheDir) / stream.str()).string();
+    }
+
+    osg::ref_ptr<osg::Node> SceneCache::read(const std::string &normalizedFilename, const std::string &signature) const
+    {
+        std::string expectedHeader;
+        if (!makeHeader(normalizedFilename, signature, expectedHeader))
+            return NULL;
+
+        boost::filesystem::ifstream file(getCachePath(normalizedFilename), std::ios_base::in | std::ios_base::binary);
+        if (!file.is_open())
+            return NULL;
+
+        std::string header;
+        if (!std::getline(file, header) || header != expectedHeader)
+            return NULL;
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return NULL;
+
+        // the osgb reader expects to start at the beginning of its stream
+        std::stringstream data;
+        data << file.rdbuf();
+
+        osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+        options->setReadFileCallback(mReadFileCallback);
+
+        osgDB::ReaderWriter::ReadResult result = rw->readNode(data, options);
+        if (!result.success())
+        {
+            std::cerr << "Failed to read cached scene for '" << normalizedFilename << "': " << result.message() << std::endl;
+            return NULL;
+        }
+        return result.getNode();
+    }
+
+    void SceneCache::write(const std::string &normalizedFilename, const std::string &signature, const osg::Node *node) const
+    {
+        SerializableVisitor visitor;
+        const_cast<osg::Node*>(node)->accept(visitor);
+        if (!visitor.mSerializable)
+            return;
+
+        std::string header;
+        if (!makeHeader(normalizedFilename, signature, header))
+            return;
+
+        osgDB::ReaderWriter* rw = osgDB::Registry::instance()->getReaderWriterForExtension("osgb");
+        if (!rw)
+            return;
+
+        osg::ref_ptr<osgDB::Options> options (new osgDB::Options);
+        options->setPluginStringData("fileType", "Binary");
+        // store file names only, the images are shared through the ImageManager
+        options->setOptionString("WriteImageHint=UseExternal");
+
+        std::stringstream data;
+        osgDB::ReaderWriter::WriteResult result = rw->writeNode(*node, data, options);
+        if (!result.success())
+        {
+            std::cerr << "Failed to write cached scene for '" << normalizedFilename << "': " << result.message() << std::endl;
+            return;
+        }
+
+        // several threads may be loading the same file, so write to a unique file and move it into place
+        boost::filesystem::path path (getCachePath(normalizedFilename));
+        boost::filesystem::path tmpPath = path.parent_path() / boost::filesystem::unique_path("%%%%%%%%%%%%.tmp");
+        {
+            boost::filesystem::ofstream file(tmpPath, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            file << header << '\n' << data.rdbuf();
+            if (!file.good())
+            {
+                std::cerr << "Failed to write cached scene '" << tmpPath.string() << "'" << std::endl;
+                file.close();
+                boost::system::error_code ec;
+                boost::filesystem::remove(tmpPath, ec);
+                return;
+            }
+        }
+
+        boost::system::error_code ec;
+        boost::filesystem::rename(tmpPath, path, ec);
+        if (ec)
+            boost::filesystem::remove(tmpPath, ec);
+    }
+
+}
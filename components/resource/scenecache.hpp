@@ -0,0 +1,56 @@
+#ifndef OPENMW_COMPONENTS_RESOURCE_SCENECACHE_H
+#define OPENMW_COMPONENTS_RESOURCE_SCENECACHE_H
+
+#include <string>
+
+#include <osg/ref_ptr>
+
+namespace osg
+{
+    class Node;
+}
+
+namespace osgDB
+{
+    class ReadFileCallback;
+}
+
+namespace VFS
+{
+    class Manager;
+}
+
+namespace Resource
+{
+
+    /// @brief Keeps converted scene graphs in a directory on disk, so they do not have to be converted again on the next launch.
+    /// @par An entry is only used if the size and modification time of its source file and the conversion settings signature
+    ///  are still the same as when it was written. Only scenes that can be restored exactly are stored, see SceneUtil::hasLosslessSerializer.
+    /// @note Thread safe.
+    class SceneCache
+    {
+    public:
+        /// @param readFileCallback Used to resolve the images that cached scenes refer to.
+        SceneCache(const VFS::Manager* vfs, const std::string& cacheDir, osgDB::ReadFileCallback* readFileCallback);
+        ~SceneCache();
+
+        /// @return The cached scene, or NULL if there is no valid entry.
+        osg::ref_ptr<osg::Node> read(const std::string& normalizedFilename, const std::string& signature) const;
+
+        /// Store the scene, if it can be restored exactly. Failures are logged, but not fatal.
+        void write(const std::string& normalizedFilename, const std::string& signature, const osg::Node* node) const;
+
+    private:
+        /// @return false if the source file can not be validated
+        bool makeHeader(const std::string& normalizedFilename, const std::string& signature, std::string& header) const;
+
+        std::string getCachePath(const std::string& normalizedFilename) const;
+
+        const VFS::Manager* mVFS;
+        std::string mCacheDir;
+        osg::ref_ptr<osgDB::ReadFileCallback> mReadFileCallback;
+    };
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "scenemanager.hpp"
 
 #include <iostream>
+#include <sstream>
 #include <cstdlib>
 
 #include <osg/Node>
@@ -32,6 +33,7 @@
 #include "niffilemanager.hpp"
 #include "objectcache.hpp"
 #include "multiobjectcache.hpp"
+#include "scenecache.hpp"
 
 namespace
 {
@@ -466,6 +468,88 @@ namespace Resource
         return options;
     }
 
+    void SceneManager::setDiskCacheDirectory(const std::string &path)
+    {
+        if (path.empty())
+            mDiskCache.reset();
+        else
+            mDiskCache.reset(new SceneCache(mVFS, path, new ImageReadCallback(mImageManager)));
+    }
+
+    osg::ref_ptr<osg::Node> SceneManager::loadTemplate(std::string &normalized, const std::string &name)
+    {
+        osg::ref_ptr<osg::Node> loaded;
+        try
+        {
+            Files::IStreamPtr file = mVFS->get(normalized);
+
+            loaded = load(file, normalized, mImageManager, mNifFileManager);
+        }
+        catch (std::exception& e)
+        {
+            static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
+
+            for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
+            {
+                normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
+                if (mVFS->exists(normalized))
+                {
+                    std::cerr << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead" << std::endl;
+                    Files::IStreamPtr file = mVFS->get(normalized);
+                    loaded = load(file, normalized, mImageManager, mNifFileManager);
+                    break;
+                }
+            }
+
+            if (!loaded)
+                throw;
+        }
+
+        // set filtering settings
+        SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsVisitor);
+        SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+        loaded->accept(setFilterSettingsControllerVisitor);
+
+        Shader::ShaderVisitor shaderVisitor(*mShaderManager.get(), *mImageManager, "objects_vertex.glsl", "objects_fragment.glsl");
+        shaderVisitor.setForceShaders(mForceShaders);
+        shaderVisitor.setClampLighting(mClampLighting);
+        shaderVisitor.setForcePerPixelLighting(mForcePerPixelLighting);
+        shaderVisitor.setAutoUseNormalMaps(mAutoUseNormalMaps);
+        shaderVisitor.setNormalMapPattern(mNormalMapPattern);
+        shaderVisitor.setNormalHeightMapPattern(mNormalHeightMapPattern);
+        shaderVisitor.setAutoUseSpecularMaps(mAutoUseSpecularMaps);
+        shaderVisitor.setSpecularMapPattern(mSpecularMapPattern);
+        loaded->accept(shaderVisitor);
+
+        // share state
+        // do this before optimizing so the optimizer will be able to combine nodes more aggressively
+        // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
+        mSharedStateMutex.lock();
+        mSharedStateManager->share(loaded.get());
+        mSharedStateMutex.unlock();
+
+        if (canOptimize(normalized))
+        {
+            SceneUtil::Optimizer optimizer;
+            optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
+
+            static const unsigned int options = getOptimizationOptions();
+
+            optimizer.optimize(loaded, options);
+        }
+
+        return loaded;
+    }
+
+    std::string SceneManager::getDiskCacheSignature() const
+    {
+        std::ostringstream stream;
+        stream << mForceShaders << mClampLighting << mForcePerPixelLighting << mAutoUseNormalMaps << mAutoUseSpecularMaps
+               << getOptimizationOptions() << ":" << mNormalMapPattern << ":" << mNormalHeightMapPattern << ":" << mSpecularMapPattern;
+        return stream.str();
+    }
+
     osg::ref_ptr<const osg::Node> SceneManager::getTemplate(const std::string &name)
     {
         std::string normalized = name;
@@ -477,64 +561,25 @@ namespace Resource
         else
         {
             osg::ref_ptr<osg::Node> loaded;
-            try
-            {
-                Files::IStreamPtr file = mVFS->get(normalized);
+            if (mDiskCache)
+                loaded = mDiskCache->read(normalized, getDiskCacheSignature());
 
-                loaded = load(file, normalized, mImageManager, mNifFileManager);
-            }
-            catch (std::exception& e)
+            if (loaded)
             {
-                static const char * const sMeshTypes[] = { "nif", "osg", "osgt", "osgb", "osgx", "osg2" };
+                // the cached scene was converted and optimized already, but the filter settings may have changed since
+                SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
+                loaded->accept(setFilterSettingsVisitor);
 
-                for (unsigned int i=0; i<sizeof(sMeshTypes)/sizeof(sMeshTypes[0]); ++i)
-                {
-                    normalized = "meshes/marker_error." + std::string(sMeshTypes[i]);
-                    if (mVFS->exists(normalized))
-                    {
-                        std::cerr << "Failed to load '" << name << "': " << e.what() << ", using marker_error." << sMeshTypes[i] << " instead" << std::endl;
-                        Files::IStreamPtr file = mVFS->get(normalized);
-                        loaded = load(file, normalized, mImageManager, mNifFileManager);
-                        break;
-                    }
-                }
-
-                if (!loaded)
-                    throw;
+                mSharedStateMutex.lock();
+                mSharedStateManager->share(loaded.get());
+                mSharedStateMutex.unlock();
             }
-
-            // set filtering settings
-            SetFilterSettingsVisitor setFilterSettingsVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsVisitor);
-            SetFilterSettingsControllerVisitor setFilterSettingsControllerVisitor(mMinFilter, mMagFilter, mMaxAnisotropy);
-            loaded->accept(setFilterSettingsControllerVisitor);
-
-            Shader::ShaderVisitor shaderVisitor(*mShaderManager.get(), *mImageManager, "objects_vertex.glsl", "objects_fragment.glsl");
-            shaderVisitor.setForceShaders(mForceShaders);
-            shaderVisitor.setClampLighting(mClampLighting);
-            shaderVisitor.setForcePerPixelLighting(mForcePerPixelLighting);
-            shaderVisitor.setAutoUseNormalMaps(mAutoUseNormalMaps);
-            shaderVisitor.setNormalMapPattern(mNormalMapPattern);
-            shaderVisitor.setNormalHeightMapPattern(mNormalHeightMapPattern);
-            shaderVisitor.setAutoUseSpecularMaps(mAutoUseSpecularMaps);
-            shaderVisitor.setSpecularMapPattern(mSpecularMapPattern);
-            loaded->accept(shaderVisitor);
-
-            // share state
-            // do this before optimizing so the optimizer will be able to combine nodes more aggressively
-            // note, because StateSets will be shared at this point, StateSets can not be modified inside the optimizer
-            mSharedStateMutex.lock();
-            mSharedStateManager->share(loaded.get());
-            mSharedStateMutex.unlock();
-
-            if (canOptimize(normalized))
+            else
             {
-                SceneUtil::Optimizer optimizer;
-                optimizer.setIsOperationPermissibleForObjectCallback(new CanOptimizeCallback);
-
-                static const unsigned int options = getOptimizationOptions();
+                loaded = loadTemplate(normalized, name);
 
-                optimizer.optimize(loaded, options);
+                if (mDiskCache)
+                    mDiskCache->write(normalized, getDiskCacheSignature(), loaded);
             }
 
             if (mIncrementalCompileOperation)
@@ -37,6 +37,7 @@ namespace Resource
 {
 
     class MultiObjectCache;
+    class SceneCache;
 
     /// @brief Handles loading and caching of scenes, e.g. .nif files or .osg files
     /// @note Some methods of the scene manager can be used from any thread, see the methods documentation for more details.
@@ -140,6 +141,10 @@ namespace Resource
         /// otherwise should be disabled to reduce memory usage.
         void setUnRefImageDataAfterApply(bool unref);
 
+        /// Keep converted scenes in the given directory, so that they load faster on the next launch. Pass an empty string to disable.
+        /// @see SceneCache
+        void setDiskCacheDirectory(const std::string& path);
+
         /// @see ResourceManager::updateCache
         virtual void updateCache(double referenceTime);
 
@@ -147,6 +152,13 @@ namespace Resource
 
     private:
 
+        /// Load and convert a scene, falling back to the error marker if it can not be loaded.
+        /// @param normalized Is changed to the name of the error marker when it is used.
+        osg::ref_ptr<osg::Node> loadTemplate(std::string& normalized, const std::string& name);
+
+        /// Identifies the settings that affect converted scenes, so that disk cache entries made with different settings are not used.
+        std::string getDiskCacheSignature() const;
+
         std::unique_ptr<Shader::ShaderManager> mShaderManager;
         bool mForceShaders;
         bool mClampLighting;
@@ -159,6 +171,8 @@ namespace Resource
 
         osg::ref_ptr<MultiObjectCache> mInstanceCache;
 
+        std::unique_ptr<SceneCache> mDiskCache;
+
         osg::ref_ptr<Resource::SharedStateManager> mSharedStateManager;
         mutable OpenThreads::Mutex mSharedStateMutex;
 
@@ -1,11 +1,20 @@
 #include "serialize.hpp"
 
+#include <set>
+
 #include <osgDB/ObjectWrapper>
 #include <osgDB/Registry>
+#include <osgDB/Serializer>
+#include <osgDB/InputStream>
+#include <osgDB/OutputStream>
+
+#include <OpenThreads/Mutex>
+#include <OpenThreads/ScopedLock>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/skeleton.hpp>
 #include <components/sceneutil/riggeometry.hpp>
+#include <components/nifosg/userdata.hpp>
 
 namespace SceneUtil
 {
@@ -28,6 +37,41 @@ public:
     }
 };
 
+static bool checkNodeUserData(const NifOsg::NodeUserData& data)
+{
+    return true;
+}
+
+static bool readNodeUserData(osgDB::InputStream& is, NifOsg::NodeUserData& data)
+{
+    is >> data.mIndex >> data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            is >> data.mRotationScale.mValues[i][j];
+    return true;
+}
+
+static bool writeNodeUserData(osgDB::OutputStream& os, const NifOsg::NodeUserData& data)
+{
+    os << data.mIndex << data.mScale;
+    for (int i=0; i<3; ++i)
+        for (int j=0; j<3; ++j)
+            os << data.mRotationScale.mValues[i][j];
+    os << std::endl;
+    return true;
+}
+
+class NodeUserDataSerializer : public osgDB::ObjectWrapper
+{
+public:
+    NodeUserDataSerializer()
+        : osgDB::ObjectWrapper(createInstanceFunc<NifOsg::NodeUserData>, "NifOsg::NodeUserData", "osg::Object NifOsg::NodeUserData")
+    {
+        addSerializer( new osgDB::UserSerializer<NifOsg::NodeUserData>(
+            "Data", &checkNodeUserData, &readNodeUserData, &writeNodeUserData), osgDB::BaseSerializer::RW_USER );
+    }
+};
+
 class SkeletonSerializer : public osgDB::ObjectWrapper
 {
 public:
@@ -87,13 +131,47 @@ public:
     }
 };
 
-void registerSerializers()
+// Classes whose registered serializer does not restore the object completely
+static std::set<std::string> sLossyClasses;
+
+static OpenThreads::Mutex sRegisterMutex;
+
+void registerLosslessSerializers()
 {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sRegisterMutex);
+
     static bool done = false;
     if (!done)
     {
         osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
         mgr->addWrapper(new PositionAttitudeTransformSerializer);
+        mgr->addWrapper(new NodeUserDataSerializer);
+
+        done = true;
+    }
+}
+
+bool hasLosslessSerializer(const osg::Object& object)
+{
+    std::string name = std::string(object.libraryName()) + "::" + object.className();
+
+    // findWrapper may load a serializer plugin and modify the wrapper map
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sRegisterMutex);
+    if (sLossyClasses.find(name) != sLossyClasses.end())
+        return false;
+    return osgDB::Registry::instance()->getObjectWrapperManager()->findWrapper(name) != NULL;
+}
+
+void registerSerializers()
+{
+    registerLosslessSerializers();
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(sRegisterMutex);
+
+    static bool done = false;
+    if (!done)
+    {
+        osgDB::ObjectWrapperManager* mgr = osgDB::Registry::instance()->getObjectWrapperManager();
         mgr->addWrapper(new SkeletonSerializer);
         mgr->addWrapper(new FrameSwitchSerializer);
         mgr->addWrapper(new RigGeometrySerializer);
@@ -104,6 +182,16 @@ void registerSerializers()
         mgr->removeWrapper(mgr->findWrapper("osg::Geometry"));
         mgr->addWrapper(new GeometrySerializer);
 
+        const char* lossy[] = {
+            "SceneUtil::Skeleton",
+            "NifOsg::FrameSwitch",
+            "SceneUtil::RigGeometry",
+            "SceneUtil::LightManager",
+            "MWRender::CameraRelativeTransform",
+            "osg::Geometry"
+        };
+        sLossyClasses.insert(lossy, lossy + sizeof(lossy)/sizeof(lossy[0]));
+
         // ignore the below for now to avoid warning spam
         const char* ignore[] = {
             "MWRender::PtrHolder",
@@ -114,7 +202,6 @@ void registerSerializers()
             "SceneUtil::UpdateRigGeometry",
             "SceneUtil::LightSource",
             "SceneUtil::StateSetUpdater",
-            "NifOsg::NodeUserData",
             "NifOsg::FlipController",
             "NifOsg::KeyframeController",
             "NifOsg::TextKeyMapHolder",
@@ -134,6 +221,7 @@ void registerSerializers()
         for (size_t i=0; i<sizeof(ignore)/sizeof(ignore[0]); ++i)
         {
             mgr->addWrapper(makeDummySerializer(ignore[i]));
+            sLossyClasses.insert(ignore[i]);
         }
 
 
@@ -1,12 +1,27 @@
 #ifndef OPENMW_COMPONENTS_SCENEUTIL_SERIALIZE_H
 #define OPENMW_COMPONENTS_SCENEUTIL_SERIALIZE_H
 
+namespace osg
+{
+    class Object;
+}
+
 namespace SceneUtil
 {
 
     /// Register osg node serializers for certain SceneUtil classes if not already done so
+    /// @note Many of these only write out the class name, which is enough to inspect the structure of a scene but can not restore it.
+    ///  Geometry data is not written either, once this has been called.
     void registerSerializers();
 
+    /// Register the serializers that save and restore an object completely, if not already done so.
+    /// @note Also called by registerSerializers().
+    void registerLosslessSerializers();
+
+    /// Can \a object be written out and read back in without losing data?
+    /// @note Thread safe once the serializers have been registered.
+    bool hasLosslessSerializer(const osg::Object& object);
+
 }
 
 #endif
@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include <components/misc/profiler.hpp>
+
 namespace SceneUtil
 {
 
@@ -124,13 +126,18 @@ WorkThread::WorkThread(WorkQueue *workQueue)
 
 void WorkThread::run()
 {
+    Misc::Profiler::setThreadName("WorkQueue");
+
     while (true)
     {
         osg::ref_ptr<WorkItem> item = mWorkQueue->removeWorkItem();
         if (!item)
             return;
         mActive = true;
-        item->doWork();
+        {
+            Misc::ProfileZone zone("WorkItem");
+            item->doWork();
+        }
         item->signalDone();
         mActive = false;
     }
@@ -6,11 +6,14 @@
 
 #include <osgUtil/IncrementalCompileOperation>
 
+#include <OpenThreads/ScopedLock>
+
 #include <components/resource/objectcache.hpp>
 #include <components/resource/scenemanager.hpp>
 
 #include <components/sceneutil/positionattitudetransform.hpp>
 #include <components/sceneutil/lightmanager.hpp>
+#include <components/sceneutil/workqueue.hpp>
 
 #include "terraindrawable.hpp"
 #include "material.hpp"
@@ -21,6 +24,38 @@
 namespace Terrain
 {
 
+class CreateChunkWorkItem : public SceneUtil::WorkItem
+{
+public:
+    CreateChunkWorkItem(ChunkManager* chunkManager, const std::string& id, float size, const osg::Vec2f& center, int lod, unsigned int lodFlags)
+        : mChunkManager(chunkManager)
+        , mId(id)
+        , mSize(size)
+        , mCenter(center)
+        , mLod(lod)
+        , mLodFlags(lodFlags)
+    {
+    }
+
+    virtual void doWork()
+    {
+        osg::ref_ptr<osg::Node> node = mChunkManager->createChunk(mSize, mCenter, mLod, mLodFlags);
+        mChunkManager->mCache->addEntryToObjectCache(mId, node.get());
+
+        // only remove the request once the chunk is in the cache, so that it is not requested twice
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mChunkManager->mPendingChunksMutex);
+        mChunkManager->mPendingChunks.erase(mId);
+    }
+
+private:
+    ChunkManager* mChunkManager;
+    std::string mId;
+    float mSize;
+    osg::Vec2f mCenter;
+    int mLod;
+    unsigned int mLodFlags;
+};
+
 ChunkManager::ChunkManager(Storage *storage, Resource::SceneManager *sceneMgr, TextureManager* textureManager, CompositeMapRenderer* renderer)
     : ResourceManager(NULL)
     , mStorage(storage)
@@ -33,11 +68,40 @@ ChunkManager::ChunkManager(Storage *storage, Resource::SceneManager *sceneMgr, T
 
 }
 
-osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f &center, int lod, unsigned int lodFlags)
+ChunkManager::~ChunkManager()
+{
+    // the work items refer to us, so wait for the ones that are still queued or running
+    waitForPendingChunks();
+}
+
+void ChunkManager::waitForPendingChunks()
+{
+    PendingChunks pending;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+        pending = mPendingChunks;
+    }
+    for (PendingChunks::iterator it = pending.begin(); it != pending.end(); ++it)
+        it->second->waitTillDone();
+}
+
+std::string ChunkManager::getChunkId(float size, const osg::Vec2f &center, int lod, unsigned int lodFlags) const
+{
+    std::ostringstream stream;
+    stream << getChunkPrefix(size, center, lod) << lodFlags;
+    return stream.str();
+}
+
+std::string ChunkManager::getChunkPrefix(float size, const osg::Vec2f &center, int lod) const
 {
     std::ostringstream stream;
-    stream << size << " " << center.x() << " " << center.y() << " " << lod << " " << lodFlags;
-    std::string id = stream.str();
+    stream << size << " " << center.x() << " " << center.y() << " " << lod << " ";
+    return stream.str();
+}
+
+osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f &center, int lod, unsigned int lodFlags)
+{
+    std::string id = getChunkId(size, center, lod, lodFlags);
 
     osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(id);
     if (obj)
@@ -50,9 +114,47 @@ osg::ref_ptr<osg::Node> ChunkManager::getChunk(float size, const osg::Vec2f &cen
     }
 }
 
+osg::ref_ptr<osg::Node> ChunkManager::requestChunk(float size, const osg::Vec2f &center, int lod, unsigned int lodFlags, SceneUtil::WorkQueue* workQueue)
+{
+    std::string id = getChunkId(size, center, lod, lodFlags);
+
+    osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCache(id);
+    if (obj)
+        return obj->asNode();
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+    if (mPendingChunks.find(id) != mPendingChunks.end())
+        return NULL;
+
+    // the work item may have finished between the cache lookup and taking the lock
+    obj = mCache->getRefFromObjectCache(id);
+    if (obj)
+        return obj->asNode();
+
+    osg::ref_ptr<CreateChunkWorkItem> workItem = new CreateChunkWorkItem(this, id, size, center, lod, lodFlags);
+    mPendingChunks[id] = workItem;
+    workQueue->addWorkItem(workItem);
+    return NULL;
+}
+
+osg::ref_ptr<osg::Node> ChunkManager::getCachedChunk(float size, const osg::Vec2f &center, int lod)
+{
+    osg::ref_ptr<osg::Object> obj = mCache->getRefFromObjectCacheWithPrefix(getChunkPrefix(size, center, lod));
+    if (obj)
+        return obj->asNode();
+    return NULL;
+}
+
+unsigned int ChunkManager::getNumPendingChunks() const
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mPendingChunksMutex);
+    return mPendingChunks.size();
+}
+
 void ChunkManager::reportStats(unsigned int frameNumber, osg::Stats *stats) const
 {
     stats->setAttribute(frameNumber, "Terrain Chunk", mCache->getCacheSize());
+    stats->setAttribute(frameNumber, "Terrain Pending", getNumPendingChunks());
 }
 
 void ChunkManager::setCullingActive(bool active)
@@ -1,6 +1,10 @@
 #ifndef OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 #define OPENMW_COMPONENTS_TERRAIN_CHUNKMANAGER_H
 
+#include <map>
+
+#include <OpenThreads/Mutex>
+
 #include <components/resource/resourcemanager.hpp>
 
 #include "buffercache.hpp"
@@ -16,6 +20,11 @@ namespace Resource
     class SceneManager;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
 
@@ -23,20 +32,43 @@ namespace Terrain
     class CompositeMapRenderer;
     class Storage;
     class CompositeMap;
+    class CreateChunkWorkItem;
 
     /// @brief Handles loading and caching of terrain chunks
     class ChunkManager : public Resource::ResourceManager
     {
     public:
         ChunkManager(Storage* storage, Resource::SceneManager* sceneMgr, TextureManager* textureManager, CompositeMapRenderer* renderer);
+        ~ChunkManager();
 
         osg::ref_ptr<osg::Node> getChunk(float size, const osg::Vec2f& center, int lod, unsigned int lodFlags);
 
+        /// Get the chunk if it is in the cache, otherwise create it in the background on \a workQueue.
+        /// @return The chunk, or NULL if it is not ready yet. Never blocks on the creation of a chunk.
+        osg::ref_ptr<osg::Node> requestChunk(float size, const osg::Vec2f& center, int lod, unsigned int lodFlags, SceneUtil::WorkQueue* workQueue);
+
+        /// @return A chunk of this node and LOD with any lodFlags if there is one in the cache, otherwise NULL.
+        /// @note Its edges may not be stitched to the current neighbours, only use it until the right chunk is ready.
+        osg::ref_ptr<osg::Node> getCachedChunk(float size, const osg::Vec2f& center, int lod);
+
+        /// @return The number of chunks that were requested and are not ready yet.
+        unsigned int getNumPendingChunks() const;
+
+        /// Wait until all requested chunks have been created.
+        void waitForPendingChunks();
+
         virtual void reportStats(unsigned int frameNumber, osg::Stats* stats) const;
 
         void setCullingActive(bool active);
 
     private:
+        friend class CreateChunkWorkItem;
+
+        std::string getChunkId(float size, const osg::Vec2f& center, int lod, unsigned int lodFlags) const;
+
+        /// The part of the chunk ID before the lodFlags
+        std::string getChunkPrefix(float size, const osg::Vec2f& center, int lod) const;
+
         osg::ref_ptr<osg::Node> createChunk(float size, const osg::Vec2f& center, int lod, unsigned int lodFlags);
 
         osg::ref_ptr<osg::Texture2D> createCompositeMapRTT();
@@ -54,6 +86,10 @@ namespace Terrain
         unsigned int mCompositeMapSize;
 
         bool mCullingActive;
+
+        typedef std::map<std::string, osg::ref_ptr<CreateChunkWorkItem> > PendingChunks;
+        PendingChunks mPendingChunks;
+        mutable OpenThreads::Mutex mPendingChunksMutex;
     };
 
 }
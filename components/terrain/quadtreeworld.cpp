@@ -1,8 +1,12 @@
 #include "quadtreeworld.hpp"
 
+#include <osg/ValueObject>
 #include <osgUtil/CullVisitor>
 
 #include <sstream>
+#include <set>
+
+#include <components/sceneutil/workqueue.hpp>
 
 #include "quadtreenode.hpp"
 #include "storage.hpp"
@@ -238,6 +242,7 @@ private:
 QuadTreeWorld::QuadTreeWorld(osg::Group *parent, osg::Group *compileRoot, Resource::ResourceSystem *resourceSystem, Storage *storage, int nodeMask, int preCompileMask)
     : World(parent, compileRoot, resourceSystem, storage, nodeMask, preCompileMask)
     , mViewDataMap(new ViewDataMap)
+    , mObjectChunkManager(NULL)
     , mQuadTreeBuilt(false)
 {
     // No need for culling on the Drawable / Transform level as the quad tree performs the culling already.
@@ -248,6 +253,9 @@ QuadTreeWorld::~QuadTreeWorld()
 {
     ensureQuadTreeBuilt();
     mViewDataMap->clear();
+
+    // the chunks being created in the background use the storage, which is deleted by the base class
+    mChunkManager->waitForPendingChunks();
 }
 
 
@@ -320,7 +328,9 @@ unsigned int getLodFlags(QuadTreeNode* node, int ourLod, ViewData* vd)
     return lodFlags;
 }
 
-void loadRenderingNode(ViewData::Entry& entry, ViewData* vd, ChunkManager* chunkManager)
+/// @param workQueue If not NULL, create a missing chunk in the background instead of waiting for it.
+/// The entry's rendering node remains NULL until the chunk is ready.
+void loadRenderingNode(ViewData::Entry& entry, ViewData* vd, ChunkManager* chunkManager, SceneUtil::WorkQueue* workQueue = NULL)
 {
     if (vd->hasChanged())
     {
@@ -337,8 +347,46 @@ void loadRenderingNode(ViewData::Entry& entry, ViewData* vd, ChunkManager* chunk
     if (!entry.mRenderingNode)
     {
         int ourLod = Log2(int(entry.mNode->getSize()));
-        entry.mRenderingNode = chunkManager->getChunk(entry.mNode->getSize(), entry.mNode->getCenter(), ourLod, entry.mLodFlags);
+        if (workQueue)
+            entry.mRenderingNode = chunkManager->requestChunk(entry.mNode->getSize(), entry.mNode->getCenter(), ourLod, entry.mLodFlags, workQueue);
+        else
+            entry.mRenderingNode = chunkManager->getChunk(entry.mNode->getSize(), entry.mNode->getCenter(), ourLod, entry.mLodFlags);
+    }
+}
+
+/// Find the closest ancestor of a node whose chunk is already loaded, to render in place of a chunk that is not ready yet.
+/// Its stitching was computed for the neighbours it had back then, which is good enough for a few frames.
+QuadTreeNode* findStandIn(QuadTreeNode* node, ChunkManager* chunkManager, osg::ref_ptr<osg::Node>& chunk)
+{
+    for (QuadTreeNode* parent = node->getParent(); parent; parent = parent->getParent())
+    {
+        int lod = Log2(int(parent->getSize()));
+        chunk = chunkManager->getCachedChunk(parent->getSize(), parent->getCenter(), lod);
+        if (chunk)
+            return parent;
     }
+    return NULL;
+}
+
+bool hasAncestorIn(QuadTreeNode* node, const std::set<QuadTreeNode*>& nodes)
+{
+    for (QuadTreeNode* parent = node->getParent(); parent; parent = parent->getParent())
+    {
+        if (nodes.count(parent))
+            return true;
+    }
+    return false;
+}
+
+void renderChunk(osg::Node* chunk, osg::NodeVisitor& nv, CompositeMapRenderer* compositeMapRenderer)
+{
+    osg::UserDataContainer* udc = chunk->getUserDataContainer();
+    if (udc && udc->getUserData())
+    {
+        compositeMapRenderer->setImmediate(static_cast<CompositeMap*>(udc->getUserData()));
+        udc->setUserData(NULL);
+    }
+    chunk->accept(nv);
 }
 
 void QuadTreeWorld::accept(osg::NodeVisitor &nv)
@@ -367,29 +415,116 @@ void QuadTreeWorld::accept(osg::NodeVisitor &nv)
     else
         mRootNode->traverse(nv);
 
+    // Cameras that are culled every frame may skip chunks that are not ready and pick them up in a later frame.
+    // Intersections need the exact terrain, and cameras marked with the "SyncTerrain" user value, such as the
+    // local map, are drawn only once.
+    osg::ref_ptr<SceneUtil::WorkQueue> workQueue;
+    if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
+    {
+        bool syncTerrain = false;
+        static_cast<osgUtil::CullVisitor*>(&nv)->getCurrentCamera()->getUserValue("SyncTerrain", syncTerrain);
+        if (!syncTerrain)
+            mWorkQueue.lock(workQueue);
+    }
+
+    std::set<QuadTreeNode*> standInNodes;
+    std::vector<std::pair<QuadTreeNode*, osg::ref_ptr<osg::Node> > > standIns;
+
     for (unsigned int i=0; i<vd->getNumEntries(); ++i)
     {
         ViewData::Entry& entry = vd->getEntry(i);
 
-        loadRenderingNode(entry, vd, mChunkManager.get());
+        loadRenderingNode(entry, vd, mChunkManager.get(), workQueue.get());
 
-        if (entry.mVisible)
+        if (!entry.mRenderingNode && entry.mVisible)
         {
-            osg::UserDataContainer* udc = entry.mRenderingNode->getUserDataContainer();
-            if (udc && udc->getUserData())
-            {
-                mCompositeMapRenderer->setImmediate(static_cast<CompositeMap*>(udc->getUserData()));
-                udc->setUserData(NULL);
-            }
-            entry.mRenderingNode->accept(nv);
+            osg::ref_ptr<osg::Node> chunk;
+            QuadTreeNode* standInNode = findStandIn(entry.mNode, mChunkManager.get(), chunk);
+            if (standInNode && standInNodes.insert(standInNode).second)
+                standIns.push_back(std::make_pair(standInNode, chunk));
         }
     }
 
+    for (unsigned int i=0; i<vd->getNumEntries(); ++i)
+    {
+        ViewData::Entry& entry = vd->getEntry(i);
+
+        // covered by a stand-in, which would overlap with this chunk
+        if (!standInNodes.empty() && hasAncestorIn(entry.mNode, standInNodes))
+            continue;
+
+        if (entry.mVisible && entry.mRenderingNode)
+            renderChunk(entry.mRenderingNode, nv, mCompositeMapRenderer);
+    }
+
+    for (std::vector<std::pair<QuadTreeNode*, osg::ref_ptr<osg::Node> > >::iterator it = standIns.begin(); it != standIns.end(); ++it)
+    {
+        if (!hasAncestorIn(it->first, standInNodes))
+            renderChunk(it->second, nv, mCompositeMapRenderer);
+    }
+
+    if (mObjectChunkManager && nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
+        renderObjectChunks(vd, nv);
+
     vd->reset(nv.getTraversalNumber());
 
     mRootNode->getViewDataMap()->clearUnusedViews(nv.getTraversalNumber());
 }
 
+void QuadTreeWorld::renderObjectChunks(ViewData *vd, osg::NodeVisitor &nv)
+{
+    // Object chunks are no smaller than a cell, the finer terrain nodes share the chunk of their cell
+    std::set<QuadTreeNode*> nodes;
+    for (unsigned int i=0; i<vd->getNumEntries(); ++i)
+    {
+        QuadTreeNode* node = vd->getEntry(i).mNode;
+        while (node->getSize() < 1.f && node->getParent())
+            node = node->getParent();
+        nodes.insert(node);
+    }
+
+    CellSet loadedCells;
+    {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLoadedCellsMutex);
+        loadedCells = mLoadedCells;
+    }
+
+    // the chunks are not limited to the terrain's bounding box, so they are culled by their own bounds
+    for (std::set<QuadTreeNode*>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+        renderObjectChunks((*it)->getSize(), (*it)->getCenter(), loadedCells, nv);
+}
+
+void QuadTreeWorld::renderObjectChunks(float size, const osg::Vec2f &center, const CellSet &loadedCells, osg::NodeVisitor &nv)
+{
+    bool containsLoadedCell = false;
+    for (CellSet::const_iterator it = loadedCells.begin(); it != loadedCells.end(); ++it)
+    {
+        if (it->first < center.x() + size/2.f && it->first + 1 > center.x() - size/2.f
+                && it->second < center.y() + size/2.f && it->second + 1 > center.y() - size/2.f)
+        {
+            containsLoadedCell = true;
+            break;
+        }
+    }
+
+    if (containsLoadedCell)
+    {
+        // the objects of loaded cells are rendered by the cells themselves, split the area until they are excluded
+        if (size <= 1.f)
+            return;
+        float quarter = size/4.f;
+        renderObjectChunks(size/2.f, center + osg::Vec2f(-quarter, -quarter), loadedCells, nv);
+        renderObjectChunks(size/2.f, center + osg::Vec2f(quarter, -quarter), loadedCells, nv);
+        renderObjectChunks(size/2.f, center + osg::Vec2f(-quarter, quarter), loadedCells, nv);
+        renderObjectChunks(size/2.f, center + osg::Vec2f(quarter, quarter), loadedCells, nv);
+        return;
+    }
+
+    osg::ref_ptr<osg::Node> chunk = mObjectChunkManager->requestChunk(size, center);
+    if (chunk)
+        chunk->accept(nv);
+}
+
 void QuadTreeWorld::ensureQuadTreeBuilt()
 {
     OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mQuadTreeMutex);
@@ -456,5 +591,27 @@ void QuadTreeWorld::reportStats(unsigned int frameNumber, osg::Stats *stats)
     stats->setAttribute(frameNumber, "Composite", mCompositeMapRenderer->getCompileSetSize());
 }
 
+void QuadTreeWorld::setWorkQueue(SceneUtil::WorkQueue *workQueue)
+{
+    mWorkQueue = workQueue;
+}
+
+void QuadTreeWorld::setObjectChunkManager(ObjectChunkManager *manager)
+{
+    mObjectChunkManager = manager;
+}
+
+void QuadTreeWorld::loadCell(int x, int y)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLoadedCellsMutex);
+    mLoadedCells.insert(std::make_pair(x, y));
+}
+
+void QuadTreeWorld::unloadCell(int x, int y)
+{
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mLoadedCellsMutex);
+    mLoadedCells.erase(std::make_pair(x, y));
+}
+
 
 }
@@ -3,6 +3,10 @@
 
 #include "world.hpp"
 
+#include <set>
+
+#include <osg/observer_ptr>
+
 #include <OpenThreads/Mutex>
 
 namespace osg
@@ -10,6 +14,11 @@ namespace osg
     class NodeVisitor;
 }
 
+namespace SceneUtil
+{
+    class WorkQueue;
+}
+
 namespace Terrain
 {
     class RootNode;
@@ -19,6 +28,18 @@ namespace Terrain
     class QuadTreeWorld : public Terrain::World
     {
     public:
+        /// @brief Creates chunks of objects that are paged in along with the terrain, e.g. the statics of distant cells.
+        /// @note Must be thread safe.
+        class ObjectChunkManager
+        {
+        public:
+            virtual ~ObjectChunkManager() {}
+
+            /// Get the chunk with the objects of the given area of cells, or start creating it in the background.
+            /// @return The chunk, or NULL if it is not ready yet.
+            virtual osg::ref_ptr<osg::Node> requestChunk(float size, const osg::Vec2f& center) = 0;
+        };
+
         QuadTreeWorld(osg::Group* parent, osg::Group* compileRoot, Resource::ResourceSystem* resourceSystem, Storage* storage, int nodeMask, int preCompileMask=~0);
         ~QuadTreeWorld();
 
@@ -33,13 +54,39 @@ namespace Terrain
 
         void reportStats(unsigned int frameNumber, osg::Stats* stats);
 
+        /// Create chunks that are missing during the cull traversal in the background on \a workQueue, instead of
+        /// blocking the cull traversal on them. Until a chunk is ready, a coarser chunk that is already loaded is
+        /// rendered in its place. Cameras that are drawn only once should set the "SyncTerrain" user value to true,
+        /// so that they wait for their chunks instead. The work queue is not owned by the terrain.
+        void setWorkQueue(SceneUtil::WorkQueue* workQueue);
+
+        /// Render the objects of cells outside of the loaded cells through \a manager. Set to NULL to disable.
+        void setObjectChunkManager(ObjectChunkManager* manager);
+
+        /// Tell that the objects of this cell are rendered by the loaded cells, not by the object chunks.
+        virtual void loadCell(int x, int y);
+        virtual void unloadCell(int x, int y);
+
     private:
         void ensureQuadTreeBuilt();
 
+        typedef std::set<std::pair<int, int> > CellSet;
+
+        void renderObjectChunks(ViewData* vd, osg::NodeVisitor& nv);
+
+        void renderObjectChunks(float size, const osg::Vec2f& center, const CellSet& loadedCells, osg::NodeVisitor& nv);
+
         osg::ref_ptr<RootNode> mRootNode;
 
         osg::ref_ptr<ViewDataMap> mViewDataMap;
 
+        osg::observer_ptr<SceneUtil::WorkQueue> mWorkQueue;
+
+        ObjectChunkManager* mObjectChunkManager;
+
+        CellSet mLoadedCells;
+        OpenThreads::Mutex mLoadedCellsMutex;
+
         OpenThreads::Mutex mQuadTreeMutex;
         bool mQuadTreeBuilt;
     };
@@ -2,6 +2,7 @@
 #define OPENMW_COMPONENTS_RESOURCE_ARCHIVE_H
 
 #include <map>
+#include <ctime>
 
 #include <components/files/constrainedfilestream.hpp>
 
@@ -14,6 +15,10 @@ namespace VFS
         virtual ~File() {}
 
         virtual Files::IStreamPtr open() = 0;
+
+        /// Get the size and last modification time of the file, e.g. to validate data derived from it.
+        /// @return false if the archive can not provide this information.
+        virtual bool getStatus(size_t& size, std::time_t& modified) { return false; }
     };
 
     class Archive
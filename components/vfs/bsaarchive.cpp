@@ -1,5 +1,7 @@
 #include "bsaarchive.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <components/misc/stringops.hpp>
 
 namespace VFS
@@ -10,10 +12,15 @@ namespace VFS
     {
         mFile.open(filename);
 
+        boost::system::error_code ec;
+        std::time_t modified = boost::filesystem::last_write_time(filename, ec);
+        if (ec)
+            modified = 0;
+
         const Bsa::BSAFile::FileList &filelist = mFile.getList();
         for(Bsa::BSAFile::FileList::const_iterator it = filelist.begin();it != filelist.end();++it)
         {
-            mResources.push_back(BsaArchiveFile(&*it, &mFile));
+            mResources.push_back(BsaArchiveFile(&*it, &mFile, modified));
         }
     }
 
@@ -30,9 +37,10 @@ namespace VFS
 
     // ------------------------------------------------------------------------------
 
-    BsaArchiveFile::BsaArchiveFile(const Bsa::BSAFile::FileStruct *info, Bsa::BSAFile* bsa)
+    BsaArchiveFile::BsaArchiveFile(const Bsa::BSAFile::FileStruct *info, Bsa::BSAFile* bsa, std::time_t archiveModified)
         : mInfo(info)
         , mFile(bsa)
+        , mArchiveModified(archiveModified)
     {
 
     }
@@ -42,4 +50,11 @@ namespace VFS
         return mFile->getFile(mInfo);
     }
 
+    bool BsaArchiveFile::getStatus(size_t &size, std::time_t &modified)
+    {
+        size = mInfo->fileSize;
+        modified = mArchiveModified;
+        return mArchiveModified != 0;
+    }
+
 }
@@ -11,12 +11,16 @@ namespace VFS
     class BsaArchiveFile : public File
     {
     public:
-        BsaArchiveFile(const Bsa::BSAFile::FileStruct* info, Bsa::BSAFile* bsa);
+        BsaArchiveFile(const Bsa::BSAFile::FileStruct* info, Bsa::BSAFile* bsa, std::time_t archiveModified);
 
         virtual Files::IStreamPtr open();
 
+        /// @note Reports the modification time of the whole archive, individual files have none.
+        virtual bool getStatus(size_t& size, std::time_t& modified);
+
         const Bsa::BSAFile::FileStruct* mInfo;
         Bsa::BSAFile* mFile;
+        std::time_t mArchiveModified;
     };
 
     class BsaArchive : public Archive
@@ -63,4 +63,14 @@ namespace VFS
         return Files::openConstrainedFileStream(mPath.c_str());
     }
 
+    bool FileSystemArchiveFile::getStatus(size_t &size, std::time_t &modified)
+    {
+        boost::system::error_code ec;
+        size = boost::filesystem::file_size(mPath, ec);
+        if (ec)
+            return false;
+        modified = boost::filesystem::last_write_time(mPath, ec);
+        return !ec;
+    }
+
 }
@@ -13,6 +13,8 @@ namespace VFS
 
         virtual Files::IStreamPtr open();
 
+        virtual bool getStatus(size_t& size, std::time_t& modified);
+
     private:
         std::string mPath;
 
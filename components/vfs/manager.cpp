@@ -73,6 +73,14 @@ namespace VFS
         return (found->second).first->open();
     }
 
+    bool Manager::getStatus(const std::string &normalizedName, size_t &size, std::time_t &modified) const
+    {
+        std::map<std::string, std::pair<File*, std::string>>::const_iterator found = mIndex.find(normalizedName);
+        if (found == mIndex.end())
+            return false;
+        return (found->second).first->getStatus(size, modified);
+    }
+
     bool Manager::exists(const std::string &name) const
     {
         std::string normalized = name;
@@ -5,6 +5,7 @@
 
 #include <vector>
 #include <map>
+#include <ctime>
 
 namespace VFS
 {
@@ -57,6 +58,11 @@ namespace VFS
         /// @note May be called from any thread once the index has been built.
         Files::IStreamPtr getNormalized(const std::string& normalizedName) const;
 
+        /// Get the size and last modification time of a file (name is already normalized).
+        /// @return false if the file does not exist or its archive can not provide this information.
+        /// @note May be called from any thread once the index has been built.
+        bool getStatus(const std::string& normalizedName, size_t& size, std::time_t& modified) const;
+
     private:
         bool mStrict;
 